@@ -34,6 +34,7 @@
 #include <sys/errno.h>
 #ifdef __linux__
 #include <sched.h>
+#include <dirent.h>
 #endif
 #endif // !_WIN32
 
@@ -208,14 +209,6 @@ pthread_once_t threadpool_init_control = PTHREAD_ONCE_INIT;
 #endif
 cl_int threadPoolInitErr = -1;          // set to CL_SUCCESS on successful thread launch
 
-// critical region lock around ThreadPool_Do.  We can only run one ThreadPool_Do at a time,
-// because we are too lazy to set up a queue here, and don't expect to need one.
-#if defined( _WIN32 )
-CRITICAL_SECTION    gThreadPoolLock[1];
-#else // !_WIN32
-pthread_mutex_t     gThreadPoolLock;
-#endif // !_WIN32
-
 // Condition variable to park ThreadPool threads when not working
 #if defined( _WIN32 )
 CRITICAL_SECTION    cond_lock[1];
@@ -224,186 +217,542 @@ _CONDITION_VARIABLE cond_var[1];
 pthread_mutex_t     cond_lock;
 pthread_cond_t      cond_var;
 #endif // !_WIN32
-volatile cl_int     gRunCount = 0;              // Condition variable state. How many iterations on the function left to run.
-                                                // set to CL_INT_MAX to cause worker threads to exit. Note: this value might go negative.
+volatile cl_int     gJobGeneration = 0;         // Condition variable state. Bumped every time new work is published to the workers.
+volatile cl_int     gThreadPoolExit = 0;        // set to 1 to cause worker threads to exit.
 
-// State that only changes when the threadpool is not working.
-volatile TPFuncPtr  gFunc_ptr = NULL;
-volatile void       *gUserInfo = NULL;
-volatile cl_int     gJobCount = 0;
-
-// State that may change while the thread pool is working
-volatile cl_int     jobError = CL_SUCCESS;      // err code return for the job as a whole
-
-// Condition variable to park caller while waiting
+// Condition variable to park callers of ThreadPool_Wait. Broadcast when a task completes or new work is published.
 #if defined( _WIN32 )
-HANDLE              caller_event;
+CRITICAL_SECTION    caller_cond_lock[1];
+_CONDITION_VARIABLE caller_cond_var[1];
 #else // !_WIN32
 pthread_mutex_t     caller_cond_lock;
 pthread_cond_t      caller_cond_var;
 #endif // !_WIN32
-volatile cl_int     gRunning = 0;       // # of threads intended to be running. Running threads will decrement this as they discover they've run out of work to do.
 
 // The total number of threads launched.
 volatile cl_int     gThreadCount = 0;
-#ifdef _WIN32
-void ThreadPool_WorkerFunc( void *p )
+
+// Thread placement. Set up by ThreadPool_Init when affinity is requested with SetThreadAffinity()
+// or the CL_TEST_THREAD_AFFINITY environment variable.
+cl_int              gThreadAffinity = 0;        // set to 1 to pin each worker thread to a core
+int                 *gThreadCPU = NULL;         // logical cpu each worker is pinned to, indexed by thread id. NULL if not pinned.
+cl_uint             *gThreadNode = NULL;        // NUMA node of each worker, indexed by thread id. NULL if not pinned.
+
+// Thread id + 1 of the worker thread we are running on, or 0 if this is not a worker thread.
+#if defined( _MSC_VER )
+static __declspec(thread) cl_uint tWorkerID = 0;
 #else
-void *ThreadPool_WorkerFunc( void *p )
+static __thread cl_uint tWorkerID = 0;
 #endif
-{
-    cl_uint threadID = ThreadPool_AtomicAdd( (volatile cl_int *) p, 1 );
-    cl_int item = ThreadPool_AtomicAdd( &gRunCount, -1 );
-//    log_info( "ThreadPool_WorkerFunc start: gRunning = %d\n", gRunning );
 
-    while( MAX_COUNT > item )
-    {
-        cl_int err;
+// Work distribution
+//
+// Each task submitted from outside the pool is carved into one contiguous chunk of job ids
+// per worker, and each chunk is pushed onto that worker's deque. Tasks submitted from inside
+// a TPFuncPtr are pushed whole onto the submitting worker's own deque. A worker pops job ids
+// off the front of the newest range in its own deque. Once that runs dry it steals the back
+// half of the oldest range held by the busiest other worker. Workers therefore only touch
+// their own cache line in the common case, and only take another worker's lock when the
+// load is unbalanced.
+typedef struct ThreadPool_Task ThreadPool_Task;
+struct ThreadPool_Task
+{
+    TPFuncPtr       func_ptr;
+    void            *userInfo;
+    volatile cl_int remaining;                  // number of jobs that have not yet completed
+    volatile cl_int error;                      // err code return for the job as a whole
+};
 
-        // check for more work to do
-        if( 0 >= item )
-        {
-//            log_info( "Thread %d has run out of work.\n", threadID );
+typedef struct ThreadPool_Range
+{
+    ThreadPool_Task         *task;              // task the job ids below belong to
+    cl_uint                 begin;              // next job id the owner will run
+    cl_uint                 end;                // one past the last job id. Thieves take from this end.
+    struct ThreadPool_Range *newer;
+    struct ThreadPool_Range *older;
+}ThreadPool_Range;
 
-            // No work to do. Attempt to block waiting for work
 #if defined( _WIN32 )
-            EnterCriticalSection( cond_lock );
+typedef CRITICAL_SECTION    ThreadPool_Lock;
+#define ThreadPool_LockInit( _l )       InitializeCriticalSection( _l )
+#define ThreadPool_LockAcquire( _l )    EnterCriticalSection( _l )
+#define ThreadPool_LockRelease( _l )    LeaveCriticalSection( _l )
 #else // !_WIN32
-            if((err = pthread_mutex_lock( &cond_lock) ))
-            {
-                log_error("Error %d from pthread_mutex_lock. Worker %d unable to block waiting for work. ThreadPool_WorkerFunc failed.\n", err, threadID );
-                goto exit;
-            }
+typedef pthread_mutex_t     ThreadPool_Lock;
+#define ThreadPool_LockInit( _l )       pthread_mutex_init( _l, NULL )
+#define ThreadPool_LockAcquire( _l )    pthread_mutex_lock( _l )
+#define ThreadPool_LockRelease( _l )    pthread_mutex_unlock( _l )
 #endif // !_WIN32
 
-            cl_int remaining = ThreadPool_AtomicAdd( &gRunning, -1 );
-//            log_info( "ThreadPool_WorkerFunc: gRunning = %d\n", remaining - 1 );
-            if( 1 == remaining )
-            { // last thread out signal the main thread to wake up
-#if defined( _WIN32 )
-                SetEvent( caller_event );
-#else // !_WIN32
-                if((err = pthread_mutex_lock( &caller_cond_lock) ))
-                {
-                    log_error("Error %d from pthread_mutex_lock. Unable to wake caller.\n", err );
-                    goto exit;
-                }
-                if( (err = pthread_cond_broadcast( &caller_cond_var )))
-                {
-                    log_error("Error %d from pthread_cond_broadcast. Unable to wake up main thread. ThreadPool_WorkerFunc failed.\n", err );
-                    goto exit;
-                }
-                if((err = pthread_mutex_unlock( &caller_cond_lock) ))
+#define THREADPOOL_CACHE_LINE   128     // big enough to cover adjacent line prefetch on x86
+
+typedef struct ThreadPool_Deque
+{
+    ThreadPool_Lock     lock;                   // protects the fields below. Taken by the owner and by thieves.
+    ThreadPool_Range    *newest;                // the owner works here
+    ThreadPool_Range    *oldest;                // thieves steal from here
+    volatile cl_uint    pending;                // number of job ids in all ranges. Read unlocked by thieves as a hint.
+    ThreadPool_Task     *pinned;                // job from ThreadPool_DoOnEachWorker that only the owner may run
+}ThreadPool_Deque;
+
+// Pad each deque out to its own cache line(s) so that workers draining their own job range do not
+// false-share with their neighbours.
+typedef union ThreadPool_PaddedDeque
+{
+    ThreadPool_Deque    d;
+    char                pad[ ((sizeof(ThreadPool_Deque) + THREADPOOL_CACHE_LINE - 1) / THREADPOOL_CACHE_LINE) * THREADPOOL_CACHE_LINE ];
+}ThreadPool_PaddedDeque;
+
+ThreadPool_PaddedDeque  *gDeques = NULL;        // one per worker thread, indexed by thread id
+
+// Push a range onto the newest end of a deque. Must hold d->lock.
+static void ThreadPool_PushRange( ThreadPool_Deque *d, ThreadPool_Range *r )
+{
+    r->older = d->newest;
+    r->newer = NULL;
+    if( d->newest )
+        d->newest->newer = r;
+    else
+        d->oldest = r;
+    d->newest = r;
+    d->pending += r->end - r->begin;
+}
+
+// Unlink an empty range from a deque. Must hold d->lock. The caller frees it after dropping the lock.
+static void ThreadPool_UnlinkRange( ThreadPool_Deque *d, ThreadPool_Range *r )
+{
+    if( r->newer )
+        r->newer->older = r->older;
+    else
+        d->newest = r->older;
+    if( r->older )
+        r->older->newer = r->newer;
+    else
+        d->oldest = r->newer;
+}
+
+// Pop the next job id off the front of the newest range in our own deque
+static int ThreadPool_PopJob( cl_uint threadID, ThreadPool_Task **task, cl_uint *job )
+{
+    ThreadPool_Deque *d = &gDeques[threadID].d;
+    ThreadPool_Range *r;
+    ThreadPool_Range *emptied = NULL;
+    int found = 0;
+
+    ThreadPool_LockAcquire( &d->lock );
+    if( (r = d->newest) )
+    {
+        *task = r->task;
+        *job = r->begin++;
+        d->pending--;
+        found = 1;
+        if( r->begin == r->end )
+        {
+            ThreadPool_UnlinkRange( d, r );
+            emptied = r;
+        }
+    }
+    ThreadPool_LockRelease( &d->lock );
+
+    free( emptied );
+    return found;
+}
+
+// Steal the back half of the oldest range held by the busiest other worker. The first stolen
+// job id is returned to be run right away and the rest of the stolen range is pushed onto our own deque.
+static int ThreadPool_StealJob( cl_uint threadID, ThreadPool_Task **task, cl_uint *job )
+{
+    cl_uint count = (cl_uint) gThreadCount;
+    cl_uint i;
+
+    while( 1 )
+    {
+        cl_uint victim = threadID;
+        cl_uint victimSize = 0;
+        int pass;
+
+        // Find the largest pile of remaining work. Reads are unlocked, so this is only a hint.
+        // When the workers are pinned, look on our own NUMA node first so that the data the
+        // stolen jobs touch is more likely to be local.
+        for( pass = gThreadNode ? 0 : 1; pass < 2 && 0 == victimSize; pass++ )
+            for( i = 1; i < count; i++ )
+            {
+                cl_uint v = (threadID + i) % count;
+                cl_uint pending = gDeques[v].d.pending;
+                if( 0 == pass && gThreadNode[v] != gThreadNode[threadID] )
+                    continue;
+                if( pending > victimSize )
                 {
-                    log_error("Error %d from pthread_mutex_lock. Unable to wake caller.\n", err );
-                    goto exit;
+                    victim = v;
+                    victimSize = pending;
                 }
-#endif // !_WIN32
             }
 
-            // loop in case we are woken only to discover that some other thread already did all the work
-            while( 0 >= item )
+        if( 0 == victimSize )
+            return 0;
+
+        // Allocate the range for the stolen remainder up front so we never need to allocate while holding a lock.
+        // If that fails just take a single job.
+        ThreadPool_Range *stolen = (ThreadPool_Range*) malloc( sizeof( *stolen ) );
+        ThreadPool_Range *emptied = NULL;
+        ThreadPool_Deque *d = &gDeques[victim].d;
+        ThreadPool_Range *r;
+        int found = 0;
+
+        ThreadPool_LockAcquire( &d->lock );
+        if( (r = d->oldest) )
+        {
+            cl_uint take = stolen ? (r->end - r->begin + 1) / 2 : 1;
+            *task = r->task;
+            if( stolen )
             {
-#if defined( _WIN32 )
-                _SleepConditionVariableCS( cond_var, cond_lock, INFINITE );
-#else // !_WIN32
-                if((err = pthread_cond_wait( &cond_var, &cond_lock) ))
-                {
-                    log_error("Error %d from pthread_cond_wait. Unable to block for waiting for work. ThreadPool_WorkerFunc failed.\n", err );
-                    pthread_mutex_unlock( &cond_lock);
-                    goto exit;
-                }
-#endif // !_WIN32
+                stolen->task = r->task;
+                stolen->end = r->end;
+            }
+            r->end -= take;
+            *job = r->end;
+            d->pending -= take;
+            found = 1;
+            if( r->begin == r->end )
+            {
+                ThreadPool_UnlinkRange( d, r );
+                emptied = r;
+            }
+        }
+        ThreadPool_LockRelease( &d->lock );
+        free( emptied );
 
-                // try again to get a valid item id
-                item = ThreadPool_AtomicAdd( &gRunCount, -1 );
-                if( MAX_COUNT <= item )  // exit if we are done
-                {
-#if defined( _WIN32 )
-                    LeaveCriticalSection( cond_lock );
-#else // !_WIN32
-                    pthread_mutex_unlock( &cond_lock);
-#endif // !_WIN32
-                    goto exit;
-                }
+        // Otherwise we lost the race to the owner or to another thief. Look again.
+        if( ! found )
+        {
+            free( stolen );
+            continue;
+        }
+
+        if( stolen )
+        {
+            stolen->begin = *job + 1;
+            if( stolen->begin < stolen->end )
+            {
+                ThreadPool_Deque *mine = &gDeques[threadID].d;
+                ThreadPool_LockAcquire( &mine->lock );
+                ThreadPool_PushRange( mine, stolen );
+                ThreadPool_LockRelease( &mine->lock );
             }
+            else
+                free( stolen );
+        }
 
-            ThreadPool_AtomicAdd( &gRunning, 1 );
-//            log_info( "Thread %d has found work.\n", threadID);
+        return 1;
+    }
+}
 
+// Wake anyone sleeping in ThreadPool_Wait so they can re-check their task or help with new work.
+static void ThreadPool_WakeWaiters( void )
+{
 #if defined( _WIN32 )
-            LeaveCriticalSection( cond_lock );
+    EnterCriticalSection( caller_cond_lock );
+    _WakeAllConditionVariable( caller_cond_var );
+    LeaveCriticalSection( caller_cond_lock );
 #else // !_WIN32
-            if((err = pthread_mutex_unlock( &cond_lock) ))
-            {
-                log_error("Error %d from pthread_mutex_unlock. Unable to block for waiting for work. ThreadPool_WorkerFunc failed.\n", err );
-                goto exit;
-            }
+    int err;
+    if((err = pthread_mutex_lock( &caller_cond_lock) ))
+    {
+        log_error("Error %d from pthread_mutex_lock. Unable to wake caller.\n", err );
+        return;
+    }
+    if( (err = pthread_cond_broadcast( &caller_cond_var )))
+        log_error("Error %d from pthread_cond_broadcast. Unable to wake up waiting threads.\n", err );
+    if((err = pthread_mutex_unlock( &caller_cond_lock) ))
+        log_error("Error %d from pthread_mutex_unlock. Unable to wake caller.\n", err );
 #endif // !_WIN32
+}
 
-        }
+// Mark a job complete. The last job of a task wakes the threads waiting in ThreadPool_Wait.
+// The task may be destroyed as soon as remaining reaches zero, so it must not be touched after that.
+static void ThreadPool_JobDone( ThreadPool_Task *task )
+{
+    if( 1 == ThreadPool_AtomicAdd( &task->remaining, -1 ) )
+        ThreadPool_WakeWaiters();
+}
 
-        // we have a valid item, so do the work
-        if( CL_SUCCESS == jobError )  // but only if we haven't already encountered an error
-        {
-//            log_info( "Thread %d doing job %d\n", threadID, item - 1);
+static void ThreadPool_RunJob( ThreadPool_Task *task, cl_uint job, cl_uint threadID )
+{
+    cl_int err;
 
+    // Once an error has been seen, drain the remaining jobs without running them
+    if( CL_SUCCESS == task->error )
+    {
 #if defined(__APPLE__) && defined(__arm__)
-            // On most platforms which support denorm, default is FTZ off. However,
-            // on some hardware where the reference is computed, default might be flush denorms to zero e.g. arm.
-            // This creates issues in result verification. Since spec allows the implementation to either flush or
-            // not flush denorms to zero, an implementation may choose not be flush i.e. return denorm result whereas
-            // reference result may be zero (flushed denorm). Hence we need to disable denorm flushing on host side
-            // where reference is being computed to make sure we get non-flushed reference result. If implementation
-            // returns flushed result, we correctly take care of that in verification code.
-            FPU_mode_type oldMode;
-            DisableFTZ( &oldMode );
+        // On most platforms which support denorm, default is FTZ off. However,
+        // on some hardware where the reference is computed, default might be flush denorms to zero e.g. arm.
+        // This creates issues in result verification. Since spec allows the implementation to either flush or
+        // not flush denorms to zero, an implementation may choose not be flush i.e. return denorm result whereas
+        // reference result may be zero (flushed denorm). Hence we need to disable denorm flushing on host side
+        // where reference is being computed to make sure we get non-flushed reference result. If implementation
+        // returns flushed result, we correctly take care of that in verification code.
+        FPU_mode_type oldMode;
+        DisableFTZ( &oldMode );
 #endif
 
-            // Call the user's function with this item ID
-            err = gFunc_ptr( item - 1, threadID, (void*) gUserInfo );
+        // Call the user's function with this item ID
+        err = task->func_ptr( job, threadID, task->userInfo );
 #if defined(__APPLE__) && defined(__arm__)
-            // Restore FP state
-            RestoreFPState( &oldMode );
+        // Restore FP state
+        RestoreFPState( &oldMode );
 #endif
 
-            if( err )
-            {
+        if( err )
+        {
 #if (__MINGW32__)
-                EnterCriticalSection(&gAtomicLock);
-                if( jobError == CL_SUCCESS );
-                    jobError = err;
-                gRunCount = 0;
-                LeaveCriticalSection(&gAtomicLock);
+            EnterCriticalSection(&gAtomicLock);
+            if( task->error == CL_SUCCESS )
+                task->error = err;
+            LeaveCriticalSection(&gAtomicLock);
 #elif defined( __GNUC__ )
-                // GCC extension: http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-                // set the new error if we are the first one there.
-                __sync_val_compare_and_swap( &jobError, CL_SUCCESS, err );
-
-                // drop run count to 0
-                gRunCount = 0;
-                __sync_synchronize();
+            // GCC extension: http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
+            // set the new error if we are the first one there.
+            __sync_val_compare_and_swap( &task->error, CL_SUCCESS, err );
 #elif defined( _MSC_VER )
-                // set the new error if we are the first one there.
-                _InterlockedCompareExchange( (volatile LONG*) &jobError, err, CL_SUCCESS );
+            // set the new error if we are the first one there.
+            _InterlockedCompareExchange( (volatile LONG*) &task->error, err, CL_SUCCESS );
+#else
+            if( pthread_mutex_lock(&gAtomicLock) )
+                log_error( "Atomic operation failed. pthread_mutex_lock(&gAtomicLock) returned an error\n");
+            if( task->error == CL_SUCCESS )
+                task->error = err;
+            if( pthread_mutex_unlock(&gAtomicLock) )
+                log_error( "Failed to release gAtomicLock. Further atomic operations may deadlock\n");
+#endif
+        }
+    }
+
+    ThreadPool_JobDone( task );
+}
+
+// Run the job ThreadPool_DoOnEachWorker left for this worker, if any. Its job id is the thread id.
+static void ThreadPool_RunPinnedJob( cl_uint threadID )
+{
+    ThreadPool_Deque *d = &gDeques[threadID].d;
+    ThreadPool_Task *task;
+
+    ThreadPool_LockAcquire( &d->lock );
+    task = d->pinned;
+    d->pinned = NULL;
+    ThreadPool_LockRelease( &d->lock );
+
+    if( task )
+        ThreadPool_RunJob( task, threadID, threadID );
+}
+
+// Wake the worker threads sleeping in ThreadPool_WorkerFunc to look for new work
+static void ThreadPool_WakeWorkers( void )
+{
+#if defined( _WIN32 )
+    EnterCriticalSection( cond_lock );
+    gJobGeneration++;
+    _WakeAllConditionVariable( cond_var );
+    LeaveCriticalSection( cond_lock );
+#else // !_WIN32
+    int err;
+    if((err = pthread_mutex_lock( &cond_lock) ))
+        log_error("Error %d from pthread_mutex_lock. Unable to wake up work threads.\n", err );
+    gJobGeneration++;
+    if( (err = pthread_cond_broadcast( &cond_var )))
+        log_error("Error %d from pthread_cond_broadcast. Unable to wake up work threads.\n", err );
+    if((err = pthread_mutex_unlock( &cond_lock) ))
+        log_error("Error %d from pthread_mutex_unlock. Unable to wake up work threads.\n", err );
+#endif // !_WIN32
+}
+
+#if defined( __linux__ ) && !defined( __ANDROID__ )
+// Read a sysfs cpu list such as "0-3,8-11" and record node as the node of each cpu in it
+static void ThreadPool_ReadNodeCPUs( const char *path, int node, int *cpuNode )
+{
+    FILE *f = fopen( path, "r" );
+    int first, last;
+
+    if( NULL == f )
+        return;
+
+    while( 1 == fscanf( f, "%d", &first ) )
+    {
+        int c = fgetc( f );
+        last = first;
+        if( '-' == c )
+        {
+            if( 1 != fscanf( f, "%d", &last ) )
+                break;
+            c = fgetc( f );
+        }
+        for( ; first <= last; first++ )
+            if( first >= 0 && first < CPU_SETSIZE )
+                cpuNode[first] = node;
+        if( ',' != c )
+            break;
+    }
+    fclose( f );
+}
+
+// Choose a cpu for each worker thread. The cpus we are allowed to run on are ordered by NUMA node,
+// so consecutive thread ids share a node and each node is filled before moving on to the next.
+// If there are more threads than cpus, we wrap around.
+static void ThreadPool_PlaceThreads( void )
+{
+    cpu_set_t   allowed;
+    int         *cpuNode = NULL;
+    int         *order = NULL;
+    int         i, cpu, node, maxNode = 0, cpuCount = 0;
+    DIR         *dir;
+    struct dirent *entry;
+
+    if( sched_getaffinity( 0, sizeof( allowed ), &allowed ) )
+    {
+        log_error( "Error: Unable to read the process cpu affinity. Worker threads will not be pinned.\n" );
+        return;
+    }
 
-                // drop run count to 0
-                gRunCount = 0;
-                _mm_mfence();
+    cpuNode = (int*) malloc( CPU_SETSIZE * sizeof( *cpuNode ) );
+    order = (int*) malloc( CPU_SETSIZE * sizeof( *order ) );
+    gThreadCPU = (int*) malloc( gThreadCount * sizeof( *gThreadCPU ) );
+    gThreadNode = (cl_uint*) malloc( gThreadCount * sizeof( *gThreadNode ) );
+    if( NULL == cpuNode || NULL == order || NULL == gThreadCPU || NULL == gThreadNode )
+    {
+        log_error( "Error: Unable to allocate ThreadPool placement tables. Worker threads will not be pinned.\n" );
+        goto fail;
+    }
+
+    // Kernels built without NUMA support have no node directory. Everything is on node 0 then.
+    for( cpu = 0; cpu < CPU_SETSIZE; cpu++ )
+        cpuNode[cpu] = 0;
+    if( (dir = opendir( "/sys/devices/system/node" )) )
+    {
+        while( (entry = readdir( dir )) )
+        {
+            char path[sizeof( "/sys/devices/system/node/" ) + sizeof( entry->d_name ) + sizeof( "/cpulist" )];
+            if( 1 != sscanf( entry->d_name, "node%d", &node ) || node < 0 )
+                continue;
+            snprintf( path, sizeof( path ), "/sys/devices/system/node/%s/cpulist", entry->d_name );
+            ThreadPool_ReadNodeCPUs( path, node, cpuNode );
+            if( node > maxNode )
+                maxNode = node;
+        }
+        closedir( dir );
+    }
+
+    for( node = 0; node <= maxNode; node++ )
+        for( cpu = 0; cpu < CPU_SETSIZE; cpu++ )
+            if( cpuNode[cpu] == node && CPU_ISSET( cpu, &allowed ) )
+                order[cpuCount++] = cpu;
+
+    if( 0 == cpuCount )
+    {
+        log_error( "Error: No usable cpus found. Worker threads will not be pinned.\n" );
+        goto fail;
+    }
+
+    for( i = 0; i < gThreadCount; i++ )
+    {
+        gThreadCPU[i] = order[ i % cpuCount ];
+        gThreadNode[i] = (cl_uint) cpuNode[ gThreadCPU[i] ];
+    }
+
+    log_info( "ThreadPool: pinning %d worker threads to %d cpus on %d NUMA nodes.\n", gThreadCount, cpuCount, maxNode + 1 );
+    free( cpuNode );
+    free( order );
+    return;
+
+fail:
+    free( cpuNode );
+    free( order );
+    free( gThreadCPU );
+    free( gThreadNode );
+    gThreadCPU = NULL;
+    gThreadNode = NULL;
+}
+
+// Pin the calling worker thread to the cpu chosen for it by ThreadPool_PlaceThreads
+static void ThreadPool_PinThread( cl_uint threadID )
+{
+    cpu_set_t set;
+
+    CPU_ZERO( &set );
+    CPU_SET( gThreadCPU[threadID], &set );
+    if( sched_setaffinity( 0, sizeof( set ), &set ) )
+        log_error( "Error: Unable to pin worker thread %d to cpu %d.\n", threadID, gThreadCPU[threadID] );
+}
+#endif // __linux__ && !__ANDROID__
+
+#ifdef _WIN32
+void ThreadPool_WorkerFunc( void *p )
 #else
-                if( pthread_mutex_lock(&gAtomicLock) )
-                    log_error( "Atomic operation failed. pthread_mutex_lock(&gAtomicLock) returned an error\n");
-                if( jobError == CL_SUCCESS );
-                    jobError = err;
-                gRunCount = 0;
-                if( pthread_mutex_unlock(&gAtomicLock) )
-                    log_error( "Failed to release gAtomicLock. Further atomic operations may deadlock\n");
+void *ThreadPool_WorkerFunc( void *p )
 #endif
+{
+    cl_uint threadID = ThreadPool_AtomicAdd( (volatile cl_int *) p, 1 );
+    cl_int generation = 0;
+    cl_int err;
+
+    tWorkerID = threadID + 1;
+
+#if defined( __linux__ ) && !defined( __ANDROID__ )
+    // Pin ourselves before we touch any memory, so that our allocations are first touched on our own node
+    if( gThreadCPU )
+        ThreadPool_PinThread( threadID );
+#endif
+
+    // Let ThreadPool_Init know we are up. p must not be touched after this.
+    ThreadPool_WakeWaiters();
+
+    while( 1 )
+    {
+        ThreadPool_Task *task;
+        cl_uint job;
+
+        // No work to do. Attempt to block waiting for work
+#if defined( _WIN32 )
+        EnterCriticalSection( cond_lock );
+#else // !_WIN32
+        if((err = pthread_mutex_lock( &cond_lock) ))
+        {
+            log_error("Error %d from pthread_mutex_lock. Worker %d unable to block waiting for work. ThreadPool_WorkerFunc failed.\n", err, threadID );
+            goto exit;
+        }
+#endif // !_WIN32
+
+        // loop in case of spurious wake ups
+        while( generation == gJobGeneration && ! gThreadPoolExit )
+        {
+#if defined( _WIN32 )
+            _SleepConditionVariableCS( cond_var, cond_lock, INFINITE );
+#else // !_WIN32
+            if((err = pthread_cond_wait( &cond_var, &cond_lock) ))
+            {
+                log_error("Error %d from pthread_cond_wait. Unable to block for waiting for work. ThreadPool_WorkerFunc failed.\n", err );
+                pthread_mutex_unlock( &cond_lock);
+                goto exit;
             }
+#endif // !_WIN32
+        }
+        generation = gJobGeneration;
+
+#if defined( _WIN32 )
+        LeaveCriticalSection( cond_lock );
+#else // !_WIN32
+        if((err = pthread_mutex_unlock( &cond_lock) ))
+        {
+            log_error("Error %d from pthread_mutex_unlock. Unable to block for waiting for work. ThreadPool_WorkerFunc failed.\n", err );
+            goto exit;
         }
+#endif // !_WIN32
 
-        // get the next item
-        item = ThreadPool_AtomicAdd( &gRunCount, -1 );
+        if( gThreadPoolExit )  // exit if we are done
+            goto exit;
+
+        // Drain our own deque, then help the others until there is nothing left to steal
+        ThreadPool_RunPinnedJob( threadID );
+        while( ThreadPool_PopJob( threadID, &task, &job ) || ThreadPool_StealJob( threadID, &task, &job ) )
+            ThreadPool_RunJob( task, job, threadID );
     }
 
 exit:
@@ -437,6 +786,23 @@ void        SetThreadCount( int count )
     gThreadCount = count;
 }
 
+// SetThreadAffinity() may be used to pin each worker thread to its own core. Workers are grouped
+// by NUMA node, so that consecutive thread ids share a node. Off by default. The
+// CL_TEST_THREAD_AFFINITY environment variable turns it on, too.
+//
+// SetThreadAffinity() must be called before the first call to GetThreadCount() or ThreadPool_Do(),
+// otherwise the behavior is indefined.
+void        SetThreadAffinity( int enable )
+{
+    if( threadPoolInitErr == CL_SUCCESS )
+    {
+        log_error( "Error: It is illegal to set the thread affinity after the first call to ThreadPool_Do or GetThreadCount\n" );
+        abort();
+    }
+
+    gThreadAffinity = enable;
+}
+
 void ThreadPool_Init(void)
 {
     cl_int i;
@@ -531,11 +897,33 @@ void ThreadPool_Init(void)
         return;
     }
 
+    if( getenv( "CL_TEST_THREAD_AFFINITY" ) )
+        gThreadAffinity = 1;
+
+    if( gThreadAffinity )
+    {
+#if defined( __linux__ ) && !defined( __ANDROID__ )
+        ThreadPool_PlaceThreads();
+#else
+        log_info( "WARNING: Thread affinity is not supported on this platform. Worker threads will not be pinned.\n" );
+#endif
+    }
+
+    gDeques = (ThreadPool_PaddedDeque*) calloc( gThreadCount, sizeof( *gDeques ) );
+    if( NULL == gDeques )
+    {
+        log_error( "Error: Unable to allocate ThreadPool work queues. Running single threaded.\n" );
+        gThreadCount = 1;
+        return;
+    }
+    for( i = 0; i < gThreadCount; i++ )
+        ThreadPool_LockInit( &gDeques[i].d.lock );
+
 #if defined( _WIN32 )
-    InitializeCriticalSection( gThreadPoolLock );
     InitializeCriticalSection( cond_lock );
     _InitializeConditionVariable( cond_var );
-    caller_event = CreateEvent( NULL, FALSE, FALSE, NULL );
+    InitializeCriticalSection( caller_cond_lock );
+    _InitializeConditionVariable( caller_cond_var );
 #elif defined (__GNUC__)
     // Dont rely on PTHREAD_MUTEX_INITIALIZER for intialization of a mutex since it might cause problem
     // with some flavors of gcc compilers.
@@ -543,7 +931,6 @@ void ThreadPool_Init(void)
     pthread_mutex_init(&cond_lock ,NULL);
     pthread_cond_init(&caller_cond_var, NULL);
     pthread_mutex_init(&caller_cond_lock, NULL);
-    pthread_mutex_init(&gThreadPoolLock, NULL);
 #endif
 
 #if !(defined(__GNUC__) || defined(_MSC_VER) || defined(__MINGW32__))
@@ -551,9 +938,11 @@ void ThreadPool_Init(void)
 #elif defined (__MINGW32__)
     InitializeCriticalSection(&gAtomicLock);
 #endif
-    // Make sure the last thread done in the work pool doesn't signal us to wake before we get to the point where we are supposed to wait
+    // Make sure the threads don't signal us to wake before we get to the point where we are supposed to wait
     //  That would cause a deadlock.
-#if !defined( _WIN32 )
+#if defined( _WIN32 )
+    EnterCriticalSection( caller_cond_lock );
+#else // !_WIN32
     if((err = pthread_mutex_lock( &caller_cond_lock) ))
     {
         log_error("Error %d from pthread_mutex_lock. Unable to block for work to finish. ThreadPool_Init failed.\n", err );
@@ -562,7 +951,6 @@ void ThreadPool_Init(void)
     }
 #endif // !_WIN32
 
-    gRunning = gThreadCount;
     // init threads
     for( i = 0; i < gThreadCount; i++ )
     {
@@ -585,10 +973,10 @@ void ThreadPool_Init(void)
     atexit( ThreadPool_Exit );
 
 // block until they are done launching.
-    do
+    while( threadID < (cl_uint) gThreadCount )
     {
 #if defined( _WIN32 )
-        WaitForSingleObject( caller_event, INFINITE );
+        _SleepConditionVariableCS( caller_cond_var, caller_cond_lock, INFINITE );
 #else // !_WIN32
         if((err = pthread_cond_wait( &caller_cond_var, &caller_cond_lock) ))
         {
@@ -598,8 +986,9 @@ void ThreadPool_Init(void)
         }
 #endif // !_WIN32
     }
-    while( gRunCount != -gThreadCount );
-#if !defined( _WIN32 )
+#if defined( _WIN32 )
+    LeaveCriticalSection( caller_cond_lock );
+#else // !_WIN32
     if((err = pthread_mutex_unlock( &caller_cond_lock) ))
     {
         log_error("Error %d from pthread_mutex_unlock. Unable to block for work to finish. ThreadPool_Init failed.\n", err );
@@ -621,7 +1010,7 @@ static BOOL CALLBACK _ThreadPool_Init(_PINIT_ONCE InitOnce, PVOID Parameter, PVO
 void ThreadPool_Exit(void)
 {
     int err, count;
-    gRunCount = CL_INT_MAX;
+    gThreadPoolExit = 1;
 
 #if defined( __GNUC__ )
     // GCC extension: http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
@@ -654,22 +1043,10 @@ void ThreadPool_Exit(void)
         log_info( "Thread pool exited in a orderly fashion.\n" );
 }
 
-
-// Blocking API that farms out count jobs to a thread pool.
-// It may return with some work undone if func_ptr() returns a non-zero
-// result.
-//
-// This function obviously has its shortcommings. Only one call to ThreadPool_Do
-// can be running at a time. It is not intended for general purpose use.
-// If clEnqueueNativeKernelFn, out of order queues and a CL_DEVICE_TYPE_CPU were
-// all available then it would make more sense to use those features.
-cl_int ThreadPool_Do( TPFuncPtr func_ptr,
-                      cl_uint count,
-                      void *userInfo )
+// Lazily set up our threads
+static cl_int ThreadPool_LazyInit( void )
 {
-    cl_int newErr;
     cl_int err = 0;
-    // Lazily set up our threads
 #if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
     err = !_InitOnceExecuteOnce( &threadpool_init_control, _ThreadPool_Init, NULL, NULL );
 #elif defined (_WIN32)
@@ -681,16 +1058,51 @@ cl_int ThreadPool_Do( TPFuncPtr func_ptr,
 #else //posix platform
     err = pthread_once( &threadpool_init_control, ThreadPool_Init );
     if( err )
-    {
-        log_error("Error %d from pthread_once. Unable to init threads. ThreadPool_Do failed.\n", err );
+        log_error("Error %d from pthread_once. Unable to init threads.\n", err );
+#endif
+    return err;
+}
+
+// Non-blocking API that farms out count jobs to the thread pool.
+// Jobs may still be running when it returns. Pass the handle to ThreadPool_Wait
+// to collect the result.
+cl_int ThreadPool_Submit( TPFuncPtr func_ptr,
+                          cl_uint count,
+                          void *userInfo,
+                          TPTaskHandle *handle )
+{
+    ThreadPool_Task *task;
+    ThreadPool_Range **ranges = NULL;
+    cl_uint rangeCount;
+    cl_uint i;
+    cl_int err;
+
+    *handle = NULL;
+
+    if( (err = ThreadPool_LazyInit()) )
         return err;
+
+    if( count >= MAX_COUNT )
+    {
+        log_error("Error: ThreadPool_Submit count %d >= max threadpool count of %d\n", count, MAX_COUNT );
+        return -1;
     }
-#endif
+
+    task = (ThreadPool_Task*) malloc( sizeof( *task ) );
+    if( NULL == task )
+    {
+        log_error( "Error: Unable to allocate ThreadPool task.\n" );
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+    task->func_ptr = func_ptr;
+    task->userInfo = userInfo;
+    task->remaining = (cl_int) count;
+    task->error = CL_SUCCESS;
+
     // Single threaded code to handle case where threadpool wasn't allocated or was disabled by environment variable
     if( threadPoolInitErr )
     {
         cl_uint currentJob = 0;
-        cl_int  result = CL_SUCCESS;
 
 #if defined(__APPLE__) && defined(__arm__)
         // On most platforms which support denorm, default is FTZ off. However,
@@ -704,154 +1116,199 @@ cl_int ThreadPool_Do( TPFuncPtr func_ptr,
         DisableFTZ( &oldMode );
 #endif
         for( currentJob = 0; currentJob < count; currentJob++ )
-            if((result = func_ptr( currentJob, 0, userInfo )))
-            {
-#if defined(__APPLE__) && defined(__arm__)
-                // Restore FP state before leaving
-                RestoreFPState( &oldMode );
-#endif
-                return result;
-            }
+            if((task->error = func_ptr( currentJob, 0, userInfo )))
+                break;
 
 #if defined(__APPLE__) && defined(__arm__)
         // Restore FP state before leaving
         RestoreFPState( &oldMode );
 #endif
 
+        task->remaining = 0;
+        *handle = task;
         return CL_SUCCESS;
     }
 
-    if( count >= MAX_COUNT )
+    if( 0 == count )
     {
-        log_error("Error: ThreadPool_Do count %d >= max threadpool count of %d\n", count, MAX_COUNT );
-        return -1;
+        *handle = task;
+        return CL_SUCCESS;
     }
 
-    // Enter critical region
-#if defined( _WIN32 )
-    EnterCriticalSection( gThreadPoolLock );
-#else // !_WIN32
-    if( (err = pthread_mutex_lock( &gThreadPoolLock )))
+    // Work submitted from a worker thread goes onto that worker's own deque, where it will be run next.
+    // Other workers will steal it from there if they are idle. Otherwise spread it over all the deques.
+    rangeCount = tWorkerID ? 1 : (cl_uint) gThreadCount;
+    if( rangeCount > count )
+        rangeCount = count;
+
+    ranges = (ThreadPool_Range**) calloc( rangeCount, sizeof( *ranges ) );
+    for( i = 0; NULL != ranges && i < rangeCount; i++ )
     {
-        switch (err)
-        {
-            case EDEADLK:
-                log_error("Error EDEADLK returned in ThreadPool_Do(). ThreadPool_Do is not designed to work recursively!\n" );
-                break;
-            case EINVAL:
-                log_error("Error EINVAL returned in ThreadPool_Do(). How did we end up with an invalid gThreadPoolLock?\n" );
-                break;
-            default:
-                break;
-        }
-        return err;
+        if( NULL == (ranges[i] = (ThreadPool_Range*) malloc( sizeof( ThreadPool_Range ) )) )
+            break;
+        ranges[i]->task = task;
+        ranges[i]->begin = (cl_uint) (((cl_ulong) count * i) / rangeCount);
+        ranges[i]->end = (cl_uint) (((cl_ulong) count * (i + 1)) / rangeCount);
     }
-#endif // !_WIN32
-
-    // Start modifying the job state observable by worker threads
-#if defined( _WIN32 )
-    EnterCriticalSection( cond_lock );
-#else // !_WIN32
-    if((err = pthread_mutex_lock( &cond_lock) ))
+    if( NULL == ranges || i < rangeCount )
     {
-        log_error("Error %d from pthread_mutex_lock. Unable to wake up work threads. ThreadPool_Do failed.\n", err );
-        goto exit;
+        log_error( "Error: Unable to allocate ThreadPool work ranges.\n" );
+        if( ranges )
+            for( i = 0; i < rangeCount; i++ )
+                free( ranges[i] );
+        free( ranges );
+        free( task );
+        return CL_OUT_OF_HOST_MEMORY;
     }
-#endif // !_WIN32
 
-    // Make sure the last thread done in the work pool doesn't signal us to wake before we get to the point where we are supposed to wait
-    //  That would cause a deadlock.
-#if !defined( _WIN32 )
-    if((err = pthread_mutex_lock( &caller_cond_lock) ))
+    for( i = 0; i < rangeCount; i++ )
     {
-        log_error("Error %d from pthread_mutex_lock. Unable to block for work to finish. ThreadPool_Do failed.\n", err );
-        goto exit;
+        ThreadPool_Deque *d = &gDeques[ tWorkerID ? tWorkerID - 1 : i ].d;
+        ThreadPool_LockAcquire( &d->lock );
+        ThreadPool_PushRange( d, ranges[i] );
+        ThreadPool_LockRelease( &d->lock );
     }
-#endif // !_WIN32
+    free( ranges );
 
-    // Prime the worker threads to get going
-    jobError = CL_SUCCESS;
-    gRunCount = gJobCount = count;
-    gFunc_ptr = func_ptr;
-    gUserInfo = userInfo;
+    ThreadPool_WakeWorkers();
 
-#if defined( _WIN32 )
-    ResetEvent(caller_event);
-    _WakeAllConditionVariable( cond_var );
-    LeaveCriticalSection( cond_lock );
-#else // !_WIN32
-    if( (err = pthread_cond_broadcast( &cond_var )))
-    {
-        log_error("Error %d from pthread_cond_broadcast. Unable to wake up work threads. ThreadPool_Do failed.\n", err );
-        goto exit;
-    }
-    if((err = pthread_mutex_unlock( &cond_lock) ))
-    {
-        log_error("Error %d from pthread_mutex_unlock. Unable to wake up work threads. ThreadPool_Do failed.\n", err );
-        goto exit;
-    }
-#endif // !_WIN32
+    // Workers blocked in ThreadPool_Wait may be able to help, too
+    if( tWorkerID )
+        ThreadPool_WakeWaiters();
 
-// block until they are done.  It would be slightly more efficient to do some of the work here though.
-    do
+    *handle = task;
+    return CL_SUCCESS;
+}
+
+// Blocks until every job in the task has run, then releases the handle.
+// Returns first non-zero result from func_ptr, or CL_SUCCESS if all are zero.
+cl_int ThreadPool_Wait( TPTaskHandle task )
+{
+    cl_int err = CL_SUCCESS;
+
+    if( NULL == task )
+        return CL_INVALID_VALUE;
+
+    while( task->remaining )
     {
+        cl_int generation = gJobGeneration;
+
+        // Worker threads help out rather than sleep, so that nested waits can't starve the pool
+        if( tWorkerID )
+        {
+            ThreadPool_Task *t;
+            cl_uint job;
+            if( ThreadPool_PopJob( tWorkerID - 1, &t, &job ) || ThreadPool_StealJob( tWorkerID - 1, &t, &job ) )
+            {
+                ThreadPool_RunJob( t, job, tWorkerID - 1 );
+                continue;
+            }
+        }
+
+        // Nothing we can do. Sleep until a task completes, or, on a worker thread, until there is new work.
 #if defined( _WIN32 )
-        WaitForSingleObject( caller_event, INFINITE );
+        EnterCriticalSection( caller_cond_lock );
+        while( task->remaining && ( ! tWorkerID || generation == gJobGeneration ) )
+            _SleepConditionVariableCS( caller_cond_var, caller_cond_lock, INFINITE );
+        LeaveCriticalSection( caller_cond_lock );
 #else // !_WIN32
-        if((err = pthread_cond_wait( &caller_cond_var, &caller_cond_lock) ))
+        if((err = pthread_mutex_lock( &caller_cond_lock) ))
         {
-            log_error("Error %d from pthread_cond_wait. Unable to block for work to finish. ThreadPool_Do failed.\n", err );
-            pthread_mutex_unlock( &caller_cond_lock);
-            goto exit;
+            log_error("Error %d from pthread_mutex_lock. Unable to block for work to finish. ThreadPool_Wait failed.\n", err );
+            break;
+        }
+        while( task->remaining && ( ! tWorkerID || generation == gJobGeneration ) )
+        {
+            if((err = pthread_cond_wait( &caller_cond_var, &caller_cond_lock) ))
+            {
+                log_error("Error %d from pthread_cond_wait. Unable to block for work to finish. ThreadPool_Wait failed.\n", err );
+                break;
+            }
         }
+        pthread_mutex_unlock( &caller_cond_lock);
+        if( err )
+            break;
 #endif // !_WIN32
     }
-    while( gRunning );
-#if !defined(_WIN32)
-    if((err = pthread_mutex_unlock( &caller_cond_lock) ))
-    {
-        log_error("Error %d from pthread_mutex_unlock. Unable to block for work to finish. ThreadPool_Do failed.\n", err );
-        goto exit;
-    }
+
+#if !defined( _WIN32 )
+    // The task may still be in use by the workers, so we can't leave until they are done with it
+    if( err )
+        while( task->remaining )
+            usleep(1000);
 #endif // !_WIN32
 
-    err = jobError;
+    if( CL_SUCCESS == err )
+        err = task->error;
+    free( task );
 
-exit:
-    // exit critical region
-#if defined( _WIN32 )
-    LeaveCriticalSection( gThreadPoolLock );
-#else // !_WIN32
-    newErr = pthread_mutex_unlock( &gThreadPoolLock );
-    if( newErr)
-    {
-        log_error("Error %d from pthread_mutex_unlock. Unable to exit critical region. ThreadPool_Do failed.\n", newErr );
+    return err;
+}
+
+// Blocking API that farms out count jobs to a thread pool.
+// It may return with some work undone if func_ptr() returns a non-zero
+// result.
+//
+// If clEnqueueNativeKernelFn, out of order queues and a CL_DEVICE_TYPE_CPU were
+// all available then it would make more sense to use those features.
+cl_int ThreadPool_Do( TPFuncPtr func_ptr,
+                      cl_uint count,
+                      void *userInfo )
+{
+    TPTaskHandle task;
+    cl_int err;
+
+    if( (err = ThreadPool_Submit( func_ptr, count, userInfo, &task )) )
         return err;
-    }
-#endif // !_WIN32
 
-    return err;
+    return ThreadPool_Wait( task );
 }
 
-cl_uint GetThreadCount( void )
+// Runs func_ptr once on every worker thread, passing the thread id as the job id, and waits for
+// all of them. Unlike ThreadPool_Do the jobs are never stolen.
+cl_int ThreadPool_DoOnEachWorker( TPFuncPtr func_ptr, void *userInfo )
 {
-    // Lazily set up our threads
-#if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
-    cl_int err = !_InitOnceExecuteOnce( &threadpool_init_control, _ThreadPool_Init, NULL, NULL );
-#elif defined (_WIN32)
-    if (threadpool_init_control == 0) {
-    #warning  This is buggy and race prone.  Find a better way.
-        ThreadPool_Init();
-        threadpool_init_control = 1;
+    ThreadPool_Task *task;
+    cl_int i, err;
+
+    if( tWorkerID )
+    {
+        log_error( "Error: ThreadPool_DoOnEachWorker may not be called from a worker thread.\n" );
+        return CL_INVALID_OPERATION;
     }
-#else
-    cl_int err = pthread_once( &threadpool_init_control, ThreadPool_Init );
-    if( err )
+
+    // Running single threaded the caller stands in for the one worker
+    if( (err = ThreadPool_LazyInit()) || threadPoolInitErr )
+        return ThreadPool_Do( func_ptr, 1, userInfo );
+
+    task = (ThreadPool_Task*) malloc( sizeof( *task ) );
+    if( NULL == task )
     {
-        log_error("Error %d from pthread_once. Unable to init threads. ThreadPool_Do failed.\n", err );
-        return err;
+        log_error( "Error: Unable to allocate ThreadPool task.\n" );
+        return CL_OUT_OF_HOST_MEMORY;
     }
-#endif // !_WIN32
+    task->func_ptr = func_ptr;
+    task->userInfo = userInfo;
+    task->remaining = gThreadCount;
+    task->error = CL_SUCCESS;
+
+    for( i = 0; i < gThreadCount; i++ )
+    {
+        ThreadPool_Deque *d = &gDeques[i].d;
+        ThreadPool_LockAcquire( &d->lock );
+        d->pinned = task;
+        ThreadPool_LockRelease( &d->lock );
+    }
+
+    ThreadPool_WakeWorkers();
+
+    return ThreadPool_Wait( task );
+}
+
+cl_uint GetThreadCount( void )
+{
+    if( ThreadPool_LazyInit() )
+        return 1;
 
     if( gThreadCount < 1 )
         return 1;
@@ -859,6 +1316,14 @@ cl_uint GetThreadCount( void )
     return gThreadCount;
 }
 
+cl_uint GetThreadNode( cl_uint thread_id )
+{
+    if( NULL == gThreadNode || thread_id >= (cl_uint) gThreadCount )
+        return 0;
+
+    return gThreadNode[thread_id];
+}
+
 #else
 
 #ifndef MY_OS_REALLY_REALLY_DOESNT_SUPPORT_THREADS
@@ -917,6 +1382,42 @@ cl_int ThreadPool_Do(   TPFuncPtr func_ptr,
     return CL_SUCCESS;
 }
 
+cl_int ThreadPool_DoOnEachWorker( TPFuncPtr func_ptr, void *userInfo )
+{
+    return ThreadPool_Do( func_ptr, 1, userInfo );
+}
+
+struct ThreadPool_Task
+{
+    cl_int error;
+};
+
+// Runs the jobs right away. ThreadPool_Wait just collects the result.
+cl_int ThreadPool_Submit( TPFuncPtr func_ptr,
+                          cl_uint count,
+                          void *userInfo,
+                          TPTaskHandle *handle )
+{
+    *handle = (TPTaskHandle) malloc( sizeof( **handle ) );
+    if( NULL == *handle )
+        return CL_OUT_OF_HOST_MEMORY;
+
+    (*handle)->error = ThreadPool_Do( func_ptr, count, userInfo );
+    return CL_SUCCESS;
+}
+
+cl_int ThreadPool_Wait( TPTaskHandle task )
+{
+    cl_int err;
+
+    if( NULL == task )
+        return CL_INVALID_VALUE;
+
+    err = task->error;
+    free( task );
+    return err;
+}
+
 cl_uint GetThreadCount( void )
 {
     return 1;
@@ -928,4 +1429,15 @@ void SetThreadCount( int count )
         log_info( "WARNING: SetThreadCount(%d) ignored\n", count );
 }
 
+void SetThreadAffinity( int enable )
+{
+    if( enable )
+        log_info( "WARNING: SetThreadAffinity(%d) ignored\n", enable );
+}
+
+cl_uint GetThreadNode( cl_uint thread_id )
+{
+    return 0;
+}
+
 #endif
@@ -33,22 +33,52 @@ cl_int     ThreadPool_AtomicAdd( volatile cl_int *a, cl_int b );    // returns o
 // Your function prototype
 //
 // A function pointer to the function you want to execute in a multithreaded context.  No
-// synchronization primitives are provided, other than the atomic add above. You may not
-// call ThreadPool_Do from your function. ThreadPool_AtomicAdd() and GetThreadCount() should
-// work, however.
+// synchronization primitives are provided, other than the atomic add above. You may call
+// ThreadPool_Do, ThreadPool_Submit and ThreadPool_Wait from your function to run nested work.
+// ThreadPool_AtomicAdd() and GetThreadCount() should work, too.
 //
 // job ids and thread ids are 0 based.  If number of jobs or threads was 8, they will numbered be 0 through 7.
 // Note that while every job will be run, it is not guaranteed that every thread will wake up before
 // the work is done.
+//
+// A thread that waits on nested work from inside your function helps run the pool's outstanding jobs
+// while it waits. Those jobs are passed the same thread_id as the job that is waiting, so per-thread
+// state indexed by thread_id must not be held across a nested ThreadPool_Do or ThreadPool_Wait.
 typedef cl_int (*TPFuncPtr)( cl_uint /*job_id*/, cl_uint /* thread_id */, void *userInfo );
 
+// Handle to a batch of jobs started by ThreadPool_Submit
+typedef struct ThreadPool_Task *TPTaskHandle;
+
 // returns first non-zero result from func_ptr, or CL_SUCCESS if all are zero.
 // Some workitems may not run if a non-zero result is returned from func_ptr().
-// This function may not be called from a TPFuncPtr.
+// Equivalent to ThreadPool_Submit() followed by ThreadPool_Wait().
 cl_int      ThreadPool_Do(  TPFuncPtr func_ptr,
                             cl_uint count,
                             void *userInfo );
 
+// Starts count jobs on the thread pool and returns without waiting for them. Several
+// submissions may be in flight at once, so callers can overlap independent work, e.g.
+// building kernels while generating reference data. userInfo must stay valid until
+// ThreadPool_Wait returns. Returns CL_SUCCESS and a handle in *task, or an error and NULL.
+// If the thread pool is running single threaded the jobs are run before this returns.
+cl_int      ThreadPool_Submit(  TPFuncPtr func_ptr,
+                                cl_uint count,
+                                void *userInfo,
+                                TPTaskHandle *task );
+
+// Blocks until all the jobs of a submitted task have run and releases the handle.
+// Must be called exactly once for each handle returned by ThreadPool_Submit.
+// returns first non-zero result from func_ptr, or CL_SUCCESS if all are zero.
+cl_int      ThreadPool_Wait( TPTaskHandle task );
+
+// Runs func_ptr exactly once on each worker thread, on that thread, and returns once all of them
+// are done. Both job_id and thread_id are the worker's thread id. Memory first touched from func_ptr
+// is placed on that worker's NUMA node, so this is the place to initialize per-thread data when
+// SetThreadAffinity() is on. Returns the first non-zero result from func_ptr, or CL_SUCCESS.
+// It may not be called from a TPFuncPtr, nor from several threads at once.
+cl_int      ThreadPool_DoOnEachWorker( TPFuncPtr func_ptr,
+                                       void *userInfo );
+
 // Returns the number of worker threads that underlie the threadpool.  The value passed
 // as the TPFuncPtrs thread_id will be between 0 and this value less one, inclusive.
 // This is safe to call from a TPFuncPtr.
@@ -68,6 +98,20 @@ cl_uint     GetThreadCount( void );
 // otherwise the behavior is indefined. It may not be called from a TPFuncPtr.
 void        SetThreadCount( int count );
 
+// SetThreadAffinity() may be used to pin each worker thread to its own core. The workers are
+// grouped by NUMA node, so that consecutive thread ids share a node. Memory first touched from
+// a TPFuncPtr is then normally allocated on that thread's node. Off by default. Setting the
+// CL_TEST_THREAD_AFFINITY environment variable also turns it on. It is ignored on platforms
+// other than Linux.
+//
+// Like SetThreadCount(), it must be called before the first call to GetThreadCount() or ThreadPool_Do().
+void        SetThreadAffinity( int enable );
+
+// Returns the NUMA node that the worker thread with this thread_id is pinned to, so that a TPFuncPtr
+// can place per-thread scratch memory on its own node. Returns 0 if the threads are not pinned.
+// This is safe to call from a TPFuncPtr.
+cl_uint     GetThreadNode( cl_uint thread_id );
+
 #ifdef __cplusplus
     }   /* extern "C" */
 #endif
@@ -874,9 +874,7 @@ void generate_random_data( ExplicitType type, size_t count, MTdata d, void *outD
     cl_uchar *ucharPtr;
     cl_short *shortPtr;
     cl_ushort *ushortPtr;
-    cl_int *intPtr;
     cl_uint *uintPtr;
-    cl_long *longPtr;
     cl_ulong *ulongPtr;
     cl_float *floatPtr;
     cl_double *doublePtr;
@@ -960,54 +958,43 @@ void generate_random_data( ExplicitType type, size_t count, MTdata d, void *outD
             break;
 
         case kInt:
-            intPtr = (cl_int *)outData;
-            for( i = 0; i < count; i++ )
-            {
-                intPtr[i] = (cl_int)genrand_int32(d);
-            }
-            break;
-
         case kUInt:
         case kUnsignedInt:
-            uintPtr = (cl_uint *)outData;
-            for( i = 0; i < count; i++ )
-            {
-                uintPtr[i] = (unsigned int)genrand_int32(d);
-            }
+            genrand_int32_block( d, (cl_uint *)outData, count );
             break;
 
+        // The 64 bit types take the low word first, as the one at a time code did
         case kLong:
-            longPtr = (cl_long *)outData;
-            for( i = 0; i < count; i++ )
-            {
-                longPtr[i] = (cl_long)genrand_int32(d) | ( (cl_long)genrand_int32(d) << 32 );
-            }
-            break;
-
         case kULong:
         case kUnsignedLong:
+            genrand_int32_block( d, (cl_uint *)outData, 2 * count );
             ulongPtr = (cl_ulong *)outData;
             for( i = 0; i < count; i++ )
             {
-                ulongPtr[i] = (cl_ulong)genrand_int32(d) | ( (cl_ulong)genrand_int32(d) << 32 );
+                cl_uint *w = (cl_uint *)( ulongPtr + i );
+                ulongPtr[i] = (cl_ulong)w[0] | ( (cl_ulong)w[1] << 32 );
             }
             break;
 
         case kFloat:
+            genrand_int32_block( d, (cl_uint *)outData, count );
             floatPtr = (cl_float *)outData;
+            uintPtr = (cl_uint *)outData;
             for( i = 0; i < count; i++ )
             {
-                // [ -(double) 0x7fffffff, (double) 0x7fffffff ]
-                double t = genrand_real1(d);
+                // [ -(double) 0x7fffffff, (double) 0x7fffffff ], t = genrand_real1(d)
+                double t = uintPtr[i] * (1.0/4294967295.0);
                 floatPtr[i] = (float) ((1.0 - t) * -(double) 0x7fffffff + t * (double) 0x7fffffff);
             }
             break;
 
         case kDouble:
+            genrand_int32_block( d, (cl_uint *)outData, 2 * count );
             doublePtr = (cl_double *)outData;
             for( i = 0; i < count; i++ )
             {
-                cl_long u = (cl_long)genrand_int32(d) | ( (cl_long)genrand_int32(d) << 32 );
+                cl_uint *w = (cl_uint *)( doublePtr + i );
+                cl_long u = (cl_long)w[0] | ( (cl_long)w[1] << 32 );
                 double t = (double) u;
                 t *= MAKE_HEX_DOUBLE( 0x1.0p-32, 0x1, -32 );        // scale [-2**63, 2**63] to [-2**31, 2**31]
                 doublePtr[i] = t;
@@ -1138,6 +1125,20 @@ float get_random_float(float low, float high, MTdata d)
     return (1.0f - t) * low + t * high;
 }
 
+// Same as count calls to get_random_float
+void get_random_float_array(float low, float high, MTdata d, float *out, size_t count)
+{
+    cl_uint *bits = (cl_uint *) out;
+    size_t i;
+
+    genrand_int32_block( d, bits, count );
+    for( i = 0; i < count; i++ )
+    {
+        float t = (float)((double)bits[i] / (double)0xFFFFFFFF);
+        out[i] = (1.0f - t) * low + t * high;
+    }
+}
+
 double get_random_double(double low, double high, MTdata d)
 {
     cl_ulong u = (cl_ulong) genrand_int32(d) | ((cl_ulong) genrand_int32(d) << 32 );
@@ -1176,6 +1177,20 @@ int          random_in_range( int minV, int maxV, MTdata d )
     return (cl_uint)(r >> 32) + minV;
 }
 
+// Same as count calls to random_in_range
+void random_in_range_array( int minV, int maxV, MTdata d, int *out, size_t count )
+{
+    cl_uint *bits = (cl_uint *) out;
+    size_t i;
+
+    genrand_int32_block( d, bits, count );
+    for( i = 0; i < count; i++ )
+    {
+        cl_ulong r = ((cl_ulong) bits[i] ) * (maxV - minV + 1);
+        out[i] = (cl_uint)(r >> 32) + minV;
+    }
+}
+
 size_t get_random_size_t(size_t low, size_t high, MTdata d)
 {
   enum { N = sizeof(size_t)/sizeof(int) };
@@ -82,11 +82,13 @@ extern cl_ulong         read_upscale_unsigned( void *inRaw, ExplicitType inType
 extern float            read_as_float( void *inRaw, ExplicitType inType );
 
 extern float            get_random_float(float low, float high, MTdata d);
+extern void             get_random_float_array(float low, float high, MTdata d, float *out, size_t count);
 extern double           get_random_double(double low, double high, MTdata d);
 extern float            any_float( MTdata d );
 extern double           any_double( MTdata d );
 
 extern int              random_in_range( int minV, int maxV, MTdata d );
+extern void             random_in_range_array( int minV, int maxV, MTdata d, int *out, size_t count );
 
 size_t get_random_size_t(size_t low, size_t high, MTdata d);
 
@@ -41,6 +41,7 @@
  */
 
 #include "crc32.h"
+#include <string.h>
 
 static uint32_t crc32_tab[] = {
 	0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
@@ -88,17 +89,254 @@ static uint32_t crc32_tab[] = {
 	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
-uint32_t
-crc32(const void *buf, size_t size)
+/*
+ * Slice-by-8: crc32_tab8[k][b] is the CRC of byte b followed by k zero
+ * bytes, so eight table lookups advance the CRC by eight bytes.
+ */
+static uint32_t crc32_tab8[8][256];
+static volatile int crc32_tab8_init = 0;
+
+static void
+crc32_init_tab8(void)
 {
-	const uint8_t *p;
+	int i, k;
 
-	p = (const uint8_t*)buf;
-	uint32_t crc = ~0U;
+	for (i = 0; i < 256; i++)
+		crc32_tab8[0][i] = crc32_tab[i];
+	for (k = 1; k < 8; k++)
+		for (i = 0; i < 256; i++)
+			crc32_tab8[k][i] = (crc32_tab8[k - 1][i] >> 8) ^
+			    crc32_tab[crc32_tab8[k - 1][i] & 0xFF];
+	crc32_tab8_init = 1;
+}
 
+/* These work on the raw register: crc32_update inverts it before and after */
+static uint32_t
+crc32_bytes(uint32_t crc, const uint8_t *p, size_t size)
+{
 	while (size--)
 		crc = crc32_tab[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+static uint32_t
+crc32_slice8(uint32_t crc, const uint8_t *p, size_t size)
+{
+	if (!crc32_tab8_init)
+		crc32_init_tab8();
+
+	for (; size >= 8; size -= 8, p += 8) {
+		uint32_t one = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+		    ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+		uint32_t two = (uint32_t)p[4] | ((uint32_t)p[5] << 8) |
+		    ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+		crc = crc32_tab8[7][one & 0xFF] ^
+		    crc32_tab8[6][(one >> 8) & 0xFF] ^
+		    crc32_tab8[5][(one >> 16) & 0xFF] ^
+		    crc32_tab8[4][one >> 24] ^
+		    crc32_tab8[3][two & 0xFF] ^
+		    crc32_tab8[2][(two >> 8) & 0xFF] ^
+		    crc32_tab8[1][(two >> 16) & 0xFF] ^
+		    crc32_tab8[0][two >> 24];
+	}
+	return crc32_bytes(crc, p, size);
+}
+
+/*
+ * x86: fold 64 bytes at a time with carry-less multiplies, then Barrett
+ * reduce to 32 bits. See "Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction", Intel, 2009. The constants are the ones
+ * for the bit reflected CRC-32 polynomial given at the end of the paper.
+ * The SSE4.2 crc32 instruction computes CRC-32C, a different polynomial,
+ * so it can't be used here.
+ */
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#include <immintrin.h>
+#define CRC32_HAS_PCLMUL 1
+
+__attribute__((target("pclmul,sse4.1"))) static uint32_t
+crc32_pclmul(uint32_t crc, const uint8_t *p, size_t size)
+{
+	static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+	static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0ULL, 0x00ccaa009eULL };
+	static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124ULL, 0x0000000000ULL };
+	static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641ULL, 0x01f7011641ULL };
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	if (size < 64)
+		return crc32_slice8(crc, p, size);
+
+	x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	x0 = _mm_load_si128((const __m128i *)k1k2);
+	p += 64;
+	size -= 64;
+
+	/* Fold four 16 byte lanes in parallel */
+	while (size >= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		y5 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+		y6 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+		y7 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+		y8 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+		p += 64;
+		size -= 64;
+	}
+
+	/* Fold the four lanes into one */
+	x0 = _mm_load_si128((const __m128i *)k3k4);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	/* Then any remaining 16 byte blocks */
+	while (size >= 16) {
+		x2 = _mm_loadu_si128((const __m128i *)p);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		p += 16;
+		size -= 16;
+	}
+
+	/* 128 to 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+	x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x0 = _mm_load_si128((const __m128i *)poly);
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	crc = (uint32_t)_mm_extract_epi32(x1, 1);
+
+	return crc32_slice8(crc, p, size);
+}
+#endif
 
-	return crc ^ ~0U;
+/*
+ * AArch64: the optional CRC32 instructions use the CRC-32 polynomial.
+ * Written in assembly so no compiler flags are needed to build it.
+ */
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32_HAS_ARMV8 1
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+static uint32_t
+crc32_armv8(uint32_t crc, const uint8_t *p, size_t size)
+{
+	for (; size && ((uintptr_t)p & 7); size--, p++)
+		__asm__(".arch_extension crc\n\tcrc32b %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p));
+	for (; size >= 8; size -= 8, p += 8) {
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		__asm__(".arch_extension crc\n\tcrc32x %w0, %w0, %x1" : "+r"(crc) : "r"(v));
+	}
+	for (; size; size--, p++)
+		__asm__(".arch_extension crc\n\tcrc32b %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p));
+	return crc;
+}
+
+static int
+crc32_has_armv8(void)
+{
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+	return 1;
+#elif defined(__linux__)
+	return (getauxval(AT_HWCAP) & (1 << 7)) != 0;	/* HWCAP_CRC32 */
+#else
+	return 0;
+#endif
+}
+#endif
+
+static const crc32_impl crc32_impls[] = {
+#if defined(CRC32_HAS_PCLMUL)
+	{ "pclmul", crc32_pclmul },
+#endif
+#if defined(CRC32_HAS_ARMV8)
+	{ "armv8", crc32_armv8 },
+#endif
+	{ "slice8", crc32_slice8 },
+	{ "byte", crc32_bytes },
+	{ NULL, NULL }
+};
+
+static crc32_impl crc32_host[sizeof(crc32_impls) / sizeof(crc32_impls[0])];
+static volatile int crc32_host_count = -1;
+
+const crc32_impl *
+crc32_implementations(void)
+{
+	size_t i;
+	int n = 0;
+
+	if (crc32_host_count >= 0)
+		return crc32_host;
+
+	for (i = 0; crc32_impls[i].name; i++) {
+#if defined(CRC32_HAS_PCLMUL)
+		if (crc32_impls[i].update == crc32_pclmul &&
+		    !(__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")))
+			continue;
+#endif
+#if defined(CRC32_HAS_ARMV8)
+		if (crc32_impls[i].update == crc32_armv8 && !crc32_has_armv8())
+			continue;
+#endif
+		crc32_host[n++] = crc32_impls[i];
+	}
+	crc32_host[n].name = NULL;
+	crc32_host[n].update = NULL;
+	crc32_host_count = n;
+	return crc32_host;
+}
+
+uint32_t
+crc32_update(uint32_t crc, const void *buf, size_t size)
+{
+	static crc32_fn update = NULL;
+
+	if (update == NULL)
+		update = crc32_implementations()[0].update;
+
+	return update(crc ^ ~0U, (const uint8_t *)buf, size) ^ ~0U;
 }
 
+uint32_t
+crc32(const void *buf, size_t size)
+{
+	return crc32_update(0, buf, size);
+}
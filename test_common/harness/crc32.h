@@ -27,6 +27,26 @@ extern "C" {
 
 uint32_t crc32(const void *buf, size_t size);
 
+/*
+ * Continues a CRC: crc32_update(crc32(a, n), b, m) is the CRC of a
+ * followed by b. crc32_update(0, buf, size) is crc32(buf, size).
+ */
+uint32_t crc32_update(uint32_t crc, const void *buf, size_t size);
+
+/*
+ * The implementations this CPU can run, fastest first, ending with a NULL
+ * name. crc32 and crc32_update use the first. They work on the raw CRC
+ * register, without the inversions before and after.
+ */
+typedef uint32_t (*crc32_fn)(uint32_t crc, const uint8_t *buf, size_t size);
+
+typedef struct crc32_impl {
+	const char *name;
+	crc32_fn update;
+} crc32_impl;
+
+const crc32_impl *crc32_implementations(void);
+
 #ifdef __cplusplus
 }
 #endif
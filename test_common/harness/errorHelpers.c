@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 
 #include "errorHelpers.h"
 
@@ -812,3 +813,49 @@ int check_functions_for_offline_compiler(const char *subtestname, cl_device_id d
     }
     return 0;
 }
+
+// Where log_printf output from this thread goes, or NULL for stdout
+#if defined( _MSC_VER )
+static __declspec( thread ) std::string *gLogCapture = NULL;
+#else
+static __thread std::string *gLogCapture = NULL;
+#endif
+
+std::string *log_set_capture( std::string *capture )
+{
+    std::string *previous = gLogCapture;
+    gLogCapture = capture;
+    return previous;
+}
+
+int log_printf( const char *format, ... )
+{
+    va_list args;
+    int length;
+
+    va_start( args, format );
+    if( NULL == gLogCapture )
+    {
+        length = vprintf( format, args );
+        va_end( args );
+        return length;
+    }
+
+    char buffer[1024];
+    va_list copy;
+    va_copy( copy, args );
+    length = vsnprintf( buffer, sizeof( buffer ), format, copy );
+    va_end( copy );
+    if( length >= (int) sizeof( buffer ) )
+    {
+        std::string big( length + 1, '\0' );
+        vsnprintf( &big[0], big.size(), format, args );
+        gLogCapture->append( big.c_str(), length );
+    }
+    else if( length > 0 )
+    {
+        gLogCapture->append( buffer, length );
+    }
+    va_end( args );
+    return length;
+}
@@ -49,13 +49,13 @@ extern "C" {
 #else
     #include <stdio.h>
     #define test_start()
-    #define log_info printf
-    #define log_error printf
-    #define log_missing_feature printf
-    #define log_perf(_number, _higherBetter, _numType, _format, ...) printf("Performance Number " _format " (in %s, %s): %g\n",##__VA_ARGS__, _numType,        \
+    #define log_info log_printf
+    #define log_error log_printf
+    #define log_missing_feature log_printf
+    #define log_perf(_number, _higherBetter, _numType, _format, ...) log_printf("Performance Number " _format " (in %s, %s): %g\n",##__VA_ARGS__, _numType,        \
                         _higherBetter?"higher is better":"lower is better", _number )
     #define test_finish()
-    #define vlog_perf(_number, _higherBetter, _numType, _format, ...) printf("Performance Number " _format " (in %s, %s): %g\n",##__VA_ARGS__, _numType,    \
+    #define vlog_perf(_number, _higherBetter, _numType, _format, ...) log_printf("Performance Number " _format " (in %s, %s): %g\n",##__VA_ARGS__, _numType,    \
                         _higherBetter?"higher is better":"lower is better" , _number)
     #ifdef _WIN32
         #ifdef __MINGW32__
@@ -69,11 +69,23 @@ extern "C" {
         #define vlog_error vlog_win32
         #endif
     #else
-        #define vlog_error printf
-        #define vlog printf
+        #define vlog_error log_printf
+        #define vlog log_printf
     #endif
 #endif
 
+// printf, except that when runTestHarness runs tests in parallel (--jobs) the output of each test
+// is collected while it runs, and printed in test order once it is done.
+#if defined( __GNUC__ )
+extern int log_printf( const char *format, ... ) __attribute__(( format( printf, 1, 2 ) ));
+#else
+extern int log_printf( const char *format, ... );
+#endif
+
+// Sends log_printf output from the calling thread to capture instead of stdout, until called
+// again with NULL. Returns the capture it replaces, so nested captures can be restored.
+extern std::string *log_set_capture( std::string *capture );
+
 #define ct_assert(b)          ct_assert_i(b, __LINE__)
 #define ct_assert_i(b, line)  ct_assert_ii(b, line)
 #define ct_assert_ii(b, line) int _compile_time_assertion_on_line_##line[b ? 1 : -1];
@@ -14,13 +14,26 @@
 // limitations under the License.
 //
 #include "imageHelpers.h"
+#include "ThreadPool.h"
 #include <limits.h>
+#include <atomic>
+#include <vector>
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define IMAGE_ROWS_SSE2 1
+#endif
 #if defined( __APPLE__ )
 #include <sys/mman.h>
 #endif
 #if !defined (_WIN32) && !defined(__APPLE__)
 #include <malloc.h>
 #endif
+#if defined( _WIN32 )
+#include <windows.h>
+#elif defined( __APPLE__ )
+#include <sys/sysctl.h>
+#endif
+#include "parseParameters.h"
 
 int gTestCount = 0;
 int gTestFailure = 0;
@@ -479,6 +492,20 @@ struct AddressingTable
 
 static AddressingTable  sAddressingTable;
 
+// Compile time version of the table above, for the specialized samplers
+template <cl_addressing_mode addressing>
+static inline int address_coord( int value, size_t maxValue )
+{
+    switch( addressing )
+    {
+        case CL_ADDRESS_REPEAT:             return RepeatAddressFn( value, maxValue );
+        case CL_ADDRESS_MIRRORED_REPEAT:    return MirroredRepeatAddressFn( value, maxValue );
+        case CL_ADDRESS_CLAMP:              return ClampAddressFn( value, maxValue );
+        case CL_ADDRESS_CLAMP_TO_EDGE:      return ClampToEdgeNearestFn( value, maxValue );
+        default:                            return NoAddressFn( value, maxValue );
+    }
+}
+
 bool is_sRGBA_order(cl_channel_order image_channel_order){
     switch (image_channel_order) {
         case CL_sRGB:
@@ -548,6 +575,82 @@ int has_alpha(cl_image_format *format) {
     #define MAX( _a, _b )   ((_a) > (_b) ? (_a) : (_b))
 #endif
 
+// Results are streamed back in slabs of at most this many bytes; see get_image_slab_rows
+#define kImageSlabBytes     ( 64 * 1024 * 1024 )
+
+cl_ulong get_host_memory_size( void )
+{
+#if defined( _WIN32 )
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof( status );
+    if( !GlobalMemoryStatusEx( &status ) )
+        return 0;
+    return status.ullTotalPhys;
+#elif defined( __APPLE__ )
+    uint64_t size = 0;
+    size_t length = sizeof( size );
+    if( sysctlbyname( "hw.memsize", &size, &length, NULL, 0 ) )
+        return 0;
+    return size;
+#else
+    long pages = sysconf( _SC_PHYS_PAGES );
+    long pageSize = sysconf( _SC_PAGESIZE );
+    if( pages <= 0 || pageSize <= 0 )
+        return 0;
+    return (cl_ulong) pages * (cl_ulong) pageSize;
+#endif
+}
+
+static cl_ulong compute_image_memory_budget( void )
+{
+    cl_ulong budget = get_host_memory_size() / 2;
+    const char *env = getenv( "CL_TEST_IMAGE_MEMORY_MB" );
+    if( env && atol( env ) > 0 )
+        budget = (cl_ulong) atol( env ) * 1024 * 1024;
+
+    // Tests run with --jobs share the host between them
+    if( gTestJobs > 1 )
+        budget /= gTestJobs;
+
+    if( budget )
+        log_info( "Image tests limited to %gMB of host memory%s.\n", budget / ( 1024.0 * 1024.0 ),
+                  gTestJobs > 1 ? " per job" : "" );
+    return budget;
+}
+
+cl_ulong get_image_memory_budget( void )
+{
+    static cl_ulong budget = compute_image_memory_budget();
+    return budget;
+}
+
+void apply_image_memory_budget( cl_ulong *maxAllocSize, cl_ulong *memSize )
+{
+    cl_ulong budget = get_image_memory_budget();
+    if( 0 == budget )
+        return;
+
+    // The size loops keep ( size * IMAGE_HOST_COPIES ) under memSize, which then holds
+    // for the host as well
+    if( *memSize > budget )
+        *memSize = budget;
+    if( *maxAllocSize > budget / IMAGE_HOST_COPIES )
+        *maxAllocSize = budget / IMAGE_HOST_COPIES;
+}
+
+size_t get_image_slab_rows( size_t rowBytes, size_t rows )
+{
+    cl_ulong slabBytes = kImageSlabBytes;
+    cl_ulong budget = get_image_memory_budget();
+    if( budget && budget / IMAGE_HOST_COPIES < slabBytes )
+        slabBytes = budget / IMAGE_HOST_COPIES;
+
+    size_t slabRows = rowBytes ? (size_t)( slabBytes / rowBytes ) : rows;
+    if( slabRows < 1 )
+        slabRows = 1;
+    return slabRows < rows ? slabRows : rows;
+}
+
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight, size_t maxDepth, size_t maxArraySize,
                    const cl_ulong maxIndividualAllocSize,       // CL_DEVICE_MAX_MEM_ALLOC_SIZE
@@ -589,6 +692,14 @@ void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
     if (adjustedMaxTotalAllocSize < adjustedMaxIndividualAllocSize*2)
         maxAllocSize = adjustedMaxTotalAllocSize/2;
 
+    // The test keeps a few host copies of each image, which must fit in the host budget too
+    cl_ulong budget = get_image_memory_budget();
+    if (budget && maxAllocSize > budget / IMAGE_HOST_COPIES) {
+      maxAllocSize = budget / IMAGE_HOST_COPIES;
+      log_info("Limiting max allocation size to %gMB for a host memory budget of %gMB.\n",
+               maxAllocSize/(1024.0*1024.0), budget/(1024.0*1024.0));
+    }
+
     size_t raw_pixel_size = get_pixel_size(format);
     // If the test will be creating input (src) buffer of type int4 or float4, number of pixels will be
     // governed by sizeof(int4 or float4) and not sizeof(dest fomat)
@@ -1191,10 +1302,32 @@ extern bool gTestRounding;
 uint64_t gRoundingStartValue = 0;
 
 
-void escape_inf_nan_values( char* data, size_t allocSize ) {
+// Host side image buffers are processed in tiles of whole rows small enough to stay in the L2
+// cache. Regions of at least kImageTileParallelBytes are handed to the ThreadPool a tile per job.
+#define kImageTileBytes             ( 256 * 1024 )
+#define kImageTileParallelBytes     ( 4 * 1024 * 1024 )
+
+static void escape_inf_nan_values_tile( char* data, size_t size ) {
+#if defined( IMAGE_ROWS_SSE2 )
+    // Both passes below at once, 16 bytes at a time. Each short only depends on the int it is part
+    // of, so fixing the ints and then the shorts in a register gives the same bits.
+    const __m128i intMask = _mm_set1_epi32( 0x7F800000 ), intFlip = _mm_set1_epi32( 0x40000000 );
+    const __m128i shortMask = _mm_set1_epi16( 0x7C00 ), shortFlip = _mm_set1_epi16( 0x4000 );
+    size_t done = size & ~(size_t)15;
+    for( size_t i = 0; i < done; i += 16 )
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)( data + i ) );
+        v = _mm_xor_si128( v, _mm_and_si128( _mm_cmpeq_epi32( _mm_and_si128( v, intMask ), intMask ), intFlip ) );
+        v = _mm_xor_si128( v, _mm_and_si128( _mm_cmpeq_epi16( _mm_and_si128( v, shortMask ), shortMask ), shortFlip ) );
+        _mm_storeu_si128( (__m128i *)( data + i ), v );
+    }
+    data += done;
+    size -= done;
+#endif
+
     // filter values with 8 not-quite-highest bits
     unsigned int *intPtr = (unsigned int *)data;
-    for( size_t i = 0; i < allocSize >> 2; i++ )
+    for( size_t i = 0; i < size >> 2; i++ )
     {
         if( ( intPtr[ i ] & 0x7F800000 ) == 0x7F800000 )
             intPtr[ i ] ^= 0x40000000;
@@ -1202,13 +1335,169 @@ void escape_inf_nan_values( char* data, size_t allocSize ) {
 
     // Ditto with half floats (16-bit numbers with the 5 not-quite-highest bits = 0x7C00 are special)
     unsigned short *shortPtr = (unsigned short *)data;
-    for( size_t i = 0; i < allocSize >> 1; i++ )
+    for( size_t i = 0; i < size >> 1; i++ )
     {
         if( ( shortPtr[ i ] & 0x7C00 ) == 0x7C00 )
             shortPtr[ i ] ^= 0x4000;
     }
 }
 
+typedef struct EscapeTilesInfo
+{
+    char    *data;
+    size_t  size;
+} EscapeTilesInfo;
+
+static cl_int escape_inf_nan_values_job( cl_uint job_id, cl_uint thread_id, void *userInfo )
+{
+    EscapeTilesInfo *info = (EscapeTilesInfo *) userInfo;
+    size_t offset = (size_t) job_id * kImageTileBytes;
+    size_t size = info->size - offset < kImageTileBytes ? info->size - offset : kImageTileBytes;
+    escape_inf_nan_values_tile( info->data + offset, size );
+    return CL_SUCCESS;
+}
+
+// Tiles are a multiple of 4 bytes, so doing the int pass and then the short pass per tile gives
+// the same result as doing each over the whole buffer
+void escape_inf_nan_values( char* data, size_t allocSize ) {
+    if( allocSize >= kImageTileParallelBytes && GetThreadCount() > 1 )
+    {
+        EscapeTilesInfo info = { data, allocSize };
+        cl_uint tileCount = (cl_uint)( ( allocSize + kImageTileBytes - 1 ) / kImageTileBytes );
+        if( ThreadPool_Do( escape_inf_nan_values_job, tileCount, &info ) == CL_SUCCESS )
+            return;
+    }
+
+    for( size_t offset = 0; offset < allocSize; offset += kImageTileBytes )
+        escape_inf_nan_values_tile( data + offset, allocSize - offset < kImageTileBytes ? allocSize - offset : kImageTileBytes );
+}
+
+// Returns true if the size bytes at a and b are the same. Unlike memcmp it doesn't need to find
+// which byte is larger, so it can compare 64 bytes per branch.
+static bool image_row_equal( const char *a, const char *b, size_t size )
+{
+    size_t i = 0;
+#if defined( IMAGE_ROWS_SSE2 )
+    for( ; i + 64 <= size; i += 64 )
+    {
+        __m128i e0 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)( a + i ) ), _mm_loadu_si128( (const __m128i *)( b + i ) ) );
+        __m128i e1 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)( a + i + 16 ) ), _mm_loadu_si128( (const __m128i *)( b + i + 16 ) ) );
+        __m128i e2 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)( a + i + 32 ) ), _mm_loadu_si128( (const __m128i *)( b + i + 32 ) ) );
+        __m128i e3 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)( a + i + 48 ) ), _mm_loadu_si128( (const __m128i *)( b + i + 48 ) ) );
+        if( _mm_movemask_epi8( _mm_and_si128( _mm_and_si128( e0, e1 ), _mm_and_si128( e2, e3 ) ) ) != 0xFFFF )
+            return false;
+    }
+    for( ; i + 16 <= size; i += 16 )
+    {
+        __m128i e = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)( a + i ) ), _mm_loadu_si128( (const __m128i *)( b + i ) ) );
+        if( _mm_movemask_epi8( e ) != 0xFFFF )
+            return false;
+    }
+#endif
+    return memcmp( a + i, b + i, size - i ) == 0;
+}
+
+typedef struct ImageRowsInfo
+{
+    char                *dst;               // only written by copies
+    const char          *src;
+    size_t              dstRowPitch, dstSlicePitch;
+    size_t              srcRowPitch, srcSlicePitch;
+    size_t              rowBytes, rows, slices;
+    size_t              rowsPerTile;
+    bool                compare;
+    std::atomic<size_t> firstMismatch;      // lowest row index found to differ so far
+} ImageRowsInfo;
+
+static void image_rows_tile( ImageRowsInfo *info, size_t begin, size_t end )
+{
+    for( size_t r = begin; r < end; r++ )
+    {
+        size_t y = r % info->rows, z = r / info->rows;
+        const char *src = info->src + z * info->srcSlicePitch + y * info->srcRowPitch;
+        char *dst = info->dst + z * info->dstSlicePitch + y * info->dstRowPitch;
+
+        if( !info->compare )
+            memcpy( dst, src, info->rowBytes );
+        else if( !image_row_equal( dst, src, info->rowBytes ) )
+        {
+            size_t first = info->firstMismatch.load();
+            while( r < first && !info->firstMismatch.compare_exchange_weak( first, r ) )
+                ;
+            return;
+        }
+    }
+}
+
+static cl_int image_rows_job( cl_uint job_id, cl_uint thread_id, void *userInfo )
+{
+    ImageRowsInfo *info = (ImageRowsInfo *) userInfo;
+    size_t count = info->rows * info->slices;
+    size_t begin = (size_t) job_id * info->rowsPerTile;
+    size_t end = begin + info->rowsPerTile < count ? begin + info->rowsPerTile : count;
+
+    // No point comparing rows after a mismatch that was already found
+    if( info->compare && begin > info->firstMismatch.load() )
+        return CL_SUCCESS;
+    image_rows_tile( info, begin, end );
+    return CL_SUCCESS;
+}
+
+static size_t process_image_rows( ImageRowsInfo *info )
+{
+    size_t count = info->rows * info->slices;
+    info->firstMismatch = count;
+    if( count == 0 || info->rowBytes == 0 )
+        return count;
+
+    info->rowsPerTile = info->rowBytes < kImageTileBytes ? kImageTileBytes / info->rowBytes : 1;
+    if( count * info->rowBytes >= kImageTileParallelBytes && GetThreadCount() > 1 )
+    {
+        cl_uint tileCount = (cl_uint)( ( count + info->rowsPerTile - 1 ) / info->rowsPerTile );
+        if( ThreadPool_Do( image_rows_job, tileCount, info ) == CL_SUCCESS )
+            return info->firstMismatch;
+    }
+
+    image_rows_tile( info, 0, count );
+    return info->firstMismatch;
+}
+
+void copy_image_rows( void *dst, size_t dstRowPitch, size_t dstSlicePitch,
+                      const void *src, size_t srcRowPitch, size_t srcSlicePitch,
+                      size_t rowBytes, size_t rows, size_t slices )
+{
+    ImageRowsInfo info;
+    info.dst = (char *) dst;
+    info.src = (const char *) src;
+    info.dstRowPitch = dstRowPitch;
+    info.dstSlicePitch = dstSlicePitch;
+    info.srcRowPitch = srcRowPitch;
+    info.srcSlicePitch = srcSlicePitch;
+    info.rowBytes = rowBytes;
+    info.rows = rows;
+    info.slices = slices;
+    info.compare = false;
+    process_image_rows( &info );
+}
+
+size_t compare_image_rows( const void *a, size_t aRowPitch, size_t aSlicePitch,
+                           const void *b, size_t bRowPitch, size_t bSlicePitch,
+                           size_t rowBytes, size_t rows, size_t slices )
+{
+    ImageRowsInfo info;
+    info.dst = (char *) a;
+    info.src = (const char *) b;
+    info.dstRowPitch = aRowPitch;
+    info.dstSlicePitch = aSlicePitch;
+    info.srcRowPitch = bRowPitch;
+    info.srcSlicePitch = bSlicePitch;
+    info.rowBytes = rowBytes;
+    info.rows = rows;
+    info.slices = slices;
+    info.compare = true;
+    return process_image_rows( &info );
+}
+
 char * generate_random_image_data( image_descriptor *imageInfo, BufferOwningPtr<char> &P, MTdata d )
 {
     size_t allocSize = get_image_size( imageInfo );
@@ -1288,10 +1577,9 @@ char * generate_random_image_data( image_descriptor *imageInfo, BufferOwningPtr<
 
     // Otherwise, we should be able to just fill with random bits no matter what
     cl_uint *p = (cl_uint*) data;
-    for( i = 0; i + 4 <= allocSize; i += 4 )
-        p[ i / 4 ] = genrand_int32(d);
+    genrand_int32_block( d, p, allocSize / 4 );
 
-    for( ; i < allocSize; i++ )
+    for( i = allocSize & ~(size_t)3; i < allocSize; i++ )
         data[i] = genrand_int32(d);
 
     // Note: inf or nan float values would cause problems, although we don't know this will
@@ -1840,6 +2128,17 @@ inline float calculate_array_index( float coord, float extent ) {
     return ret;
 }
 
+// The image types the reference sampler treats differently. Everything that isn't an array or
+// 1D goes through the 2D/3D code, as before.
+enum
+{
+    kSampleImage1D,
+    kSampleImage1DArray,
+    kSampleImage2DArray,
+    kSampleImageOther,
+    kSampleImageKindCount
+};
+
 /*
  * Utility function to unnormalized a coordinate given a particular sampler.
  *
@@ -1848,12 +2147,13 @@ inline float calculate_array_index( float coord, float extent ) {
  * offset   - an addressing offset to be added to the coordinate
  * extent   - the max value for this coordinate (e.g. width for x)
  */
+template <cl_addressing_mode addressing>
 static float unnormalize_coordinate( const char* name, float coord,
-    float offset, float extent, cl_addressing_mode addressing_mode, int verbose )
+    float offset, float extent, int verbose )
 {
     float ret = 0.0f;
 
-    switch (addressing_mode) {
+    switch (addressing) {
         case CL_ADDRESS_REPEAT:
             ret = RepeatNormalizedAddressFn( coord, extent );
 
@@ -1925,11 +2225,11 @@ FloatPixel sample_image_pixel_float( void *imageData, image_descriptor *imageInf
                                     image_sampler_data *imageSampler, float *outData, int verbose, int *containsDenorms , int lod) {
     return sample_image_pixel_float_offset(imageData, imageInfo, x, y, z, 0.0f, 0.0f, 0.0f, imageSampler, outData, verbose, containsDenorms, lod);
 }
-FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *imageInfo,
-                                           float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
-                                           image_sampler_data *imageSampler, float *outData, int verbose, int *containsDenorms , int lod)
+template <int imageKind, cl_addressing_mode addressing, bool linear, bool normalized>
+static FloatPixel sample_image_pixel_float_specialized( void *imageData, image_descriptor *imageInfo,
+                                                       float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
+                                                       float *outData, int verbose, int *containsDenorms, int lod )
 {
-    AddressFn adFn = sAddressingTable[ imageSampler ];
     FloatPixel returnVal;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height, depth_lod = imageInfo->depth;
     size_t slice_pitch_lod = 0, row_pitch_lod = 0;
@@ -1961,34 +2261,34 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
     if( containsDenorms )
         *containsDenorms = 0;
 
-    if( imageSampler->normalized_coords ) {
+    if( normalized ) {
 
         // We need to unnormalize our coordinates differently depending on
         // the image type, but 'x' is always processed the same way.
 
-        x = unnormalize_coordinate("x", x, xAddressOffset, (float)width_lod,
-            imageSampler->addressing_mode, verbose);
+        x = unnormalize_coordinate<addressing>("x", x, xAddressOffset, (float)width_lod,
+            verbose);
 
-        switch (imageInfo->type) {
+        switch (imageKind) {
 
             // The image array types require special care:
 
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            case kSampleImage1DArray:
                 z = 0; // don't care -- unused for 1D arrays
                 break;
 
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                y = unnormalize_coordinate("y", y, yAddressOffset, (float)height_lod,
-                    imageSampler->addressing_mode, verbose);
+            case kSampleImage2DArray:
+                y = unnormalize_coordinate<addressing>("y", y, yAddressOffset, (float)height_lod,
+                    verbose);
                 break;
 
             // Everybody else:
 
             default:
-                y = unnormalize_coordinate("y", y, yAddressOffset, (float)height_lod,
-                    imageSampler->addressing_mode, verbose);
-                z = unnormalize_coordinate("z", z, zAddressOffset, (float)depth_lod,
-                    imageSampler->addressing_mode, verbose);
+                y = unnormalize_coordinate<addressing>("y", y, yAddressOffset, (float)height_lod,
+                    verbose);
+                z = unnormalize_coordinate<addressing>("z", z, zAddressOffset, (float)depth_lod,
+                    verbose);
         }
 
     } else if ( verbose ) {
@@ -2015,7 +2315,7 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
 
     // At this point, we have unnormalized coordinates.
 
-    if( imageSampler->filter_mode == CL_FILTER_NEAREST )
+    if( !linear )
     {
         int ix, iy, iz;
 
@@ -2023,27 +2323,27 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
         // coordinates.  Note that the array cases again require special
         // care, per section 8.4 in the OpenCL 1.2 Specification.
 
-        ix = adFn( floorf( x ), width_lod );
+        ix = address_coord<addressing>( floorf( x ), width_lod );
 
-        switch (imageInfo->type) {
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+        switch (imageKind) {
+            case kSampleImage1DArray:
                 iy = calculate_array_index( y, (float)(imageInfo->arraySize - 1) );
                 iz = 0;
                 if( verbose ) {
                   log_info("\tArray index %f evaluates to %d\n",y, iy );
                 }
                 break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                iy = adFn( floorf( y ), height_lod );
+            case kSampleImage2DArray:
+                iy = address_coord<addressing>( floorf( y ), height_lod );
                 iz = calculate_array_index( z, (float)(imageInfo->arraySize - 1) );
                 if( verbose ) {
                     log_info("\tArray index %f evaluates to %d\n",z, iz );
                 }
                 break;
             default:
-                iy = adFn( floorf( y ), height_lod );
+                iy = address_coord<addressing>( floorf( y ), height_lod );
                 if( depth_lod != 0 )
-                    iz = adFn( floorf( z ), depth_lod );
+                    iz = address_coord<addressing>( floorf( z ), depth_lod );
                 else
                     iz = 0;
         }
@@ -2070,18 +2370,18 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
         // Image arrays can use 2D filtering, but require us to walk into the
         // image a certain number of slices before reading.
 
-        if( depth == 0 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY ||
-                          imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+        if( depth == 0 || imageKind == kSampleImage2DArray ||
+                          imageKind == kSampleImage1DArray)
         {
             float array_index = 0;
 
             size_t layer_offset = 0;
 
-            if (imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY) {
+            if (imageKind == kSampleImage2DArray) {
                 array_index = calculate_array_index(z, (float)(imageInfo->arraySize - 1));
                 layer_offset = slice_pitch_lod * (size_t)array_index;
             }
-            else if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY) {
+            else if (imageKind == kSampleImage1DArray) {
                 array_index = calculate_array_index(y, (float)(imageInfo->arraySize - 1));
                 layer_offset = slice_pitch_lod * (size_t)array_index;
 
@@ -2090,15 +2390,14 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
                 height = 1;
             }
 
-            int x1 = adFn( floorf( x - 0.5f ), width );
+            int x1 = address_coord<addressing>( floorf( x - 0.5f ), width );
             int y1 = 0;
-            int x2 = adFn( floorf( x - 0.5f ) + 1, width );
+            int x2 = address_coord<addressing>( floorf( x - 0.5f ) + 1, width );
             int y2 = 0;
-            if ((imageInfo->type != CL_MEM_OBJECT_IMAGE1D) &&
-                (imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY) &&
-                (imageInfo->type != CL_MEM_OBJECT_IMAGE1D_BUFFER)) {
-                y1 = adFn( floorf( y - 0.5f ), height );
-                y2 = adFn( floorf( y - 0.5f ) + 1, height );
+            if ((imageKind != kSampleImage1D) &&
+                (imageKind != kSampleImage1DArray)) {
+                y1 = address_coord<addressing>( floorf( y - 0.5f ), height );
+                y2 = address_coord<addressing>( floorf( y - 0.5f ) + 1, height );
             } else {
               y = 0.5f;
             }
@@ -2176,12 +2475,12 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
         else
         {
             // 3D linear filtering
-            int x1 = adFn( floorf( x - 0.5f ), width_lod );
-            int y1 = adFn( floorf( y - 0.5f ), height_lod );
-            int z1 = adFn( floorf( z - 0.5f ), depth_lod );
-            int x2 = adFn( floorf( x - 0.5f ) + 1, width_lod );
-            int y2 = adFn( floorf( y - 0.5f ) + 1, height_lod );
-            int z2 = adFn( floorf( z - 0.5f ) + 1, depth_lod );
+            int x1 = address_coord<addressing>( floorf( x - 0.5f ), width_lod );
+            int y1 = address_coord<addressing>( floorf( y - 0.5f ), height_lod );
+            int z1 = address_coord<addressing>( floorf( z - 0.5f ), depth_lod );
+            int x2 = address_coord<addressing>( floorf( x - 0.5f ) + 1, width_lod );
+            int y2 = address_coord<addressing>( floorf( y - 0.5f ) + 1, height_lod );
+            int z2 = address_coord<addressing>( floorf( z - 0.5f ) + 1, depth_lod );
 
             if( verbose )
                 log_info( "\tActual integer coords used (i = floor(x-.5)): i0:{%d, %d, %d} and i1:{%d, %d, %d}\n", x1, y1, z1, x2, y2, z2 );
@@ -2286,6 +2585,60 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
     }
 }
 
+#define SAMPLE_FNS_FOR_MODE( kind, mode ) \
+    { { sample_image_pixel_float_specialized<kind, mode, false, false>, sample_image_pixel_float_specialized<kind, mode, false, true> }, \
+      { sample_image_pixel_float_specialized<kind, mode, true, false>, sample_image_pixel_float_specialized<kind, mode, true, true> } }
+#define SAMPLE_FNS_FOR_KIND( kind ) \
+    { SAMPLE_FNS_FOR_MODE( kind, CL_ADDRESS_NONE ), SAMPLE_FNS_FOR_MODE( kind, CL_ADDRESS_CLAMP_TO_EDGE ), \
+      SAMPLE_FNS_FOR_MODE( kind, CL_ADDRESS_CLAMP ), SAMPLE_FNS_FOR_MODE( kind, CL_ADDRESS_REPEAT ), \
+      SAMPLE_FNS_FOR_MODE( kind, CL_ADDRESS_MIRRORED_REPEAT ) }
+
+// [image kind][addressing mode - CL_ADDRESS_NONE][linear][normalized]
+static const SampleImagePixelFloatFn sSampleFns[ kSampleImageKindCount ][ 5 ][ 2 ][ 2 ] =
+{
+    SAMPLE_FNS_FOR_KIND( kSampleImage1D ),
+    SAMPLE_FNS_FOR_KIND( kSampleImage1DArray ),
+    SAMPLE_FNS_FOR_KIND( kSampleImage2DArray ),
+    SAMPLE_FNS_FOR_KIND( kSampleImageOther )
+};
+
+#undef SAMPLE_FNS_FOR_KIND
+#undef SAMPLE_FNS_FOR_MODE
+
+SampleImagePixelFloatFn get_sample_image_pixel_float_fn( image_descriptor *imageInfo, image_sampler_data *imageSampler )
+{
+    static_assert( CL_ADDRESS_MIRRORED_REPEAT - CL_ADDRESS_NONE < 5, "sSampleFns is indexed by addressing mode" );
+
+    int kind;
+    switch( imageInfo->type )
+    {
+        case CL_MEM_OBJECT_IMAGE1D:
+        case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+            kind = kSampleImage1D;
+            break;
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            kind = kSampleImage1DArray;
+            break;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            kind = kSampleImage2DArray;
+            break;
+        default:
+            kind = kSampleImageOther;
+    }
+
+    return sSampleFns[ kind ][ (int)imageSampler->addressing_mode - CL_ADDRESS_NONE ]
+                     [ imageSampler->filter_mode != CL_FILTER_NEAREST ][ imageSampler->normalized_coords ? 1 : 0 ];
+}
+
+FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *imageInfo,
+                                           float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
+                                           image_sampler_data *imageSampler, float *outData, int verbose, int *containsDenorms , int lod)
+{
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+    return sampleFn( imageData, imageInfo, x, y, z, xAddressOffset, yAddressOffset, zAddressOffset,
+                     outData, verbose, containsDenorms, lod );
+}
+
 FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *imageInfo,
                                            float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
                                            image_sampler_data *imageSampler, float *outData, int verbose, int *containsDenorms )
@@ -3199,8 +3552,8 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                         inputValues[ i++ ] = 1.f;
                         inputValues[ i++ ] = -1.f;
                         inputValues[ i++ ] = 2.f;
-                        for( ; i < numPixels * 4; i++ )
-                            inputValues[ i ] = get_random_float( -HALF_MAX - 2.f, HALF_MAX + 2.f, d );
+                        if( i < numPixels * 4 )
+                            get_random_float_array( -HALF_MAX - 2.f, HALF_MAX + 2.f, d, inputValues + i, numPixels * 4 - i );
                     }
                     break;
 #ifdef CL_SFIXED14_APPLE
@@ -3218,8 +3571,8 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                             inputValues[ i++ ] = -0x1.0p31f;
                             inputValues[ i++ ] = -0x1.1p31f;
                         }
-                        for( ; i < numPixels * 4; i++ )
-                            inputValues[ i ] = get_random_float( -1.1f, 3.1f, d );
+                        if( i < numPixels * 4 )
+                            get_random_float_array( -1.1f, 3.1f, d, inputValues + i, numPixels * 4 - i );
                     }
                     break;
 #endif
@@ -3231,8 +3584,8 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                         inputValues[ i++ ] = 0.0f;
                         inputValues[ i++ ] = 0.0f;
                         cl_uint *p = (cl_uint *)data;
-                        for( ; i < numPixels * 4; i++ )
-                            p[ i ] = genrand_int32(d);
+                        if( i < numPixels * 4 )
+                            genrand_int32_block( d, p + i, numPixels * 4 - i );
                     }
                     break;
 
@@ -3279,13 +3632,13 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                     }
                     if( is_format_signed(imageInfo->format) )
                     {
-                        for( ; i < numPixels * 4; i++ )
-                            inputValues[ i ] = get_random_float( -1.1f, 1.1f, d );
+                        if( i < numPixels * 4 )
+                            get_random_float_array( -1.1f, 1.1f, d, inputValues + i, numPixels * 4 - i );
                     }
                     else
                     {
-                        for( ; i < numPixels * 4; i++ )
-                            inputValues[ i ] = get_random_float( -0.1f, 1.1f, d );
+                        if( i < numPixels * 4 )
+                            get_random_float_array( -0.1f, 1.1f, d, inputValues + i, numPixels * 4 - i );
                     }
                     break;
             }
@@ -3311,10 +3664,7 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                 formatMin -= 2;
 
             // Now gen
-            for( size_t i = 0; i < numPixels * 4; i++ )
-            {
-                imageData[ i ] = random_in_range( formatMin, (int)formatMax, d );
-            }
+            random_in_range_array( formatMin, (int)formatMax, d, imageData, numPixels * 4 );
             break;
         }
 
@@ -3333,10 +3683,7 @@ char *create_random_image_data( ExplicitType dataType, image_descriptor *imageIn
                 formatMax += 2;
 
             // Now gen
-            for( size_t i = 0; i < numPixels * 4; i++ )
-            {
-                imageData[ i ] = random_in_range( formatMin, (int)formatMax, d );
-            }
+            random_in_range_array( formatMin, (int)formatMax, d, (int *)imageData, numPixels * 4 );
             break;
         }
         default:
@@ -3530,20 +3877,8 @@ void copy_image_data( image_descriptor *srcImageInfo, image_descriptor *dstImage
   char *sourcePtr = (char *)imageValues + sourcePos_lod[ 2 ] * src_slice_pitch_lod + sourcePos_lod[ 1 ] * src_row_pitch_lod + pixelSize * sourcePos_lod[ 0 ] + src_mip_level_offset;
   char *destPtr = (char *)destImageValues + destPos_lod[ 2 ] * dst_slice_pitch_lod + destPos_lod[ 1 ] * dst_row_pitch_lod + pixelSize * destPos_lod[ 0 ] + dst_mip_level_offset;
 
-  for( size_t z = 0; z < ( regionSize[ 2 ] > 0 ? regionSize[ 2 ] : 1 ); z++ )
-  {
-    char *rowSourcePtr = sourcePtr;
-    char *rowDestPtr = destPtr;
-    for( size_t y = 0; y < regionSize[ 1 ]; y++ )
-    {
-      memcpy( rowDestPtr, rowSourcePtr, pixelSize * regionSize[ 0 ] );
-      rowSourcePtr += src_row_pitch_lod;
-      rowDestPtr += dst_row_pitch_lod;
-    }
-
-    sourcePtr += src_slice_pitch_lod;
-    destPtr += dst_slice_pitch_lod;
-  }
+  copy_image_rows( destPtr, dst_row_pitch_lod, dst_slice_pitch_lod, sourcePtr, src_row_pitch_lod, src_slice_pitch_lod,
+                   pixelSize * regionSize[ 0 ], regionSize[ 1 ], regionSize[ 2 ] > 0 ? regionSize[ 2 ] : 1 );
 }
 
 float random_float(float low, float high, MTdata d)
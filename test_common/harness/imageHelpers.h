@@ -111,6 +111,17 @@ typedef struct
     float p[4];
 }FloatPixel;
 
+// Host memory planning for the image tests. The budget is half the host's physical memory, or
+// CL_TEST_IMAGE_MEMORY_MB megabytes when that is set, split between the --jobs threads.
+// apply_image_memory_budget lowers CL_DEVICE_MAX_MEM_ALLOC_SIZE and CL_DEVICE_GLOBAL_MEM_SIZE
+// values so that the IMAGE_HOST_COPIES copies of an image a test keeps on the host fit in the
+// budget. get_image_slab_rows returns how many rows of rowBytes to read back and validate at once.
+#define IMAGE_HOST_COPIES   3
+extern cl_ulong get_host_memory_size( void );
+extern cl_ulong get_image_memory_budget( void );
+extern void apply_image_memory_budget( cl_ulong *maxAllocSize, cl_ulong *memSize );
+extern size_t get_image_slab_rows( size_t rowBytes, size_t rows );
+
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight, size_t maxDepth, size_t maxArraySize,
                    const cl_ulong maxIndividualAllocSize, const cl_ulong maxTotalAllocSize, cl_mem_object_type image_type, cl_image_format *format, int usingMaxPixelSize=0);
@@ -134,6 +145,17 @@ extern int debug_find_pixel_in_image( void *imagePtr, image_descriptor *imageInf
 extern void copy_image_data( image_descriptor *srcImageInfo, image_descriptor *dstImageInfo, void *imageValues, void *destImageValues,
                             const size_t sourcePos[], const size_t destPos[], const size_t regionSize[] );
 
+// Copy or compare slices * rows rows of rowBytes bytes, laid out with the given row and slice
+// pitches. Large regions are split into cache sized tiles of rows that the ThreadPool works on in
+// parallel. compare_image_rows returns the index ( slice * rows + row ) of the first row that
+// differs, or rows * slices if they all match.
+extern void copy_image_rows( void *dst, size_t dstRowPitch, size_t dstSlicePitch,
+                             const void *src, size_t srcRowPitch, size_t srcSlicePitch,
+                             size_t rowBytes, size_t rows, size_t slices );
+extern size_t compare_image_rows( const void *a, size_t aRowPitch, size_t aSlicePitch,
+                                  const void *b, size_t bRowPitch, size_t bSlicePitch,
+                                  size_t rowBytes, size_t rows, size_t slices );
+
 int has_alpha(cl_image_format *format);
 
 extern bool is_sRGBA_order(cl_channel_order image_channel_order);
@@ -578,6 +600,14 @@ FloatPixel sample_image_pixel_float_offset( void *imageData, image_descriptor *i
                                            float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
                                            image_sampler_data *imageSampler, float *outData, int verbose, int *containsDenorms, int lod );
 
+// sample_image_pixel_float_offset compiled for one image type and sampler, so the addressing,
+// filter and coordinate mode aren't decided again for every sample. Tests that sample a whole
+// image can look it up once with get_sample_image_pixel_float_fn.
+typedef FloatPixel (*SampleImagePixelFloatFn)( void *imageData, image_descriptor *imageInfo,
+                                               float x, float y, float z, float xAddressOffset, float yAddressOffset, float zAddressOffset,
+                                               float *outData, int verbose, int *containsDenorms, int lod );
+extern SampleImagePixelFloatFn get_sample_image_pixel_float_fn( image_descriptor *imageInfo, image_sampler_data *imageSampler );
+
 
 extern void pack_image_pixel( unsigned int *srcVector, const cl_image_format *imageFormat, void *outData );
 extern void pack_image_pixel( int *srcVector, const cl_image_format *imageFormat, void *outData );
@@ -22,11 +22,29 @@
 #include "parseParameters.h"
 
 #include <cassert>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <errno.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+extern char **environ;
+#endif
 
 #if defined(__MINGW32__)
 #include "mingw_compat.h"
@@ -38,24 +56,6 @@ std::string slash = "\\";
 std::string slash = "/";
 #endif
 
-std::string get_file_name(const std::string &baseName, int index, const std::string &extension)
-{
-    std::ostringstream fileName;
-    fileName << baseName << "." << index << extension;
-    return fileName.str();
-}
-
-long get_file_size(const std::string &fileName)
-{
-    std::ifstream ifs(fileName.c_str(), std::ios::binary);
-    if (!ifs.good())
-        return 0;
-    // get length of file:
-    ifs.seekg(0, std::ios::end);
-    std::ios::pos_type length = ifs.tellg();
-    return static_cast<long>(length);
-}
-
 std::vector<char> get_file_content(const std::string &fileName)
 {
     std::ifstream ifs(fileName.c_str(), std::ios::binary);
@@ -86,11 +86,9 @@ static std::string get_kernel_content(unsigned int numKernelLines, const char *c
     return kernel;
 }
 
-std::string get_kernel_name(const std::string &source)
+// List of the kernel names in source, used to make cache entry names readable
+static std::string get_kernel_list(const std::string &source)
 {
-    // Count CRC
-    cl_uint crc = crc32(source.data(), source.size());
-
     // Create list of kernel names
     std::string kernelsList;
     size_t kPos = source.find("kernel");
@@ -160,57 +158,14 @@ std::string get_kernel_name(const std::string &source)
         }
         kPos = source.find("kernel", kPos + 1);
     }
-    std::ostringstream oss;
-    if (MAX_LEN_FOR_KERNEL_LIST > 0)
-    {
-        if (kernelsList.size() > MAX_LEN_FOR_KERNEL_LIST + 1)
-        {
-            kernelsList = kernelsList.substr(0, MAX_LEN_FOR_KERNEL_LIST + 1);
-            kernelsList[kernelsList.size() - 1] = '.';
-            kernelsList[kernelsList.size() - 1] = '.';
-        }
-        oss << kernelsList;
-    }
-    oss << std::hex << std::setfill('0') << std::setw(8) << crc;
-    return oss.str();
-}
-
-std::string add_build_options(const std::string &baseName, const char *options)
-{
-    if (options == 0 || options[0] == 0)
-        return get_file_name(baseName, 0, "");
-
-    bool equal = false;
-    int i = 0;
-
-    do
-    {
-        i++;
-        std::string fileName = gCompilationCachePath + slash + get_file_name(baseName, i, ".options");
-        long fileSize = get_file_size(fileName);
-        if (fileSize == 0)
-            break;
-        //if(fileSize == strlen(options))
-        {
-            std::vector<char> options2 = get_file_content(fileName);
-            options2.push_back(0); //terminate string
-            equal = strcmp(options, &options2[0]) == 0;
-        }
-    } while (!equal);
-    if (equal)
-        return get_file_name(baseName, i, "");
-
-    std::string fileName = gCompilationCachePath + slash + get_file_name(baseName, i, ".options");
-    std::ofstream ofs(fileName.c_str(), std::ios::binary);
-    if (!ofs.good())
-    {
-        log_info("OfflineCompiler: can't create options: %s\n", fileName.c_str());
+    if (MAX_LEN_FOR_KERNEL_LIST <= 0)
         return "";
+    if (kernelsList.size() > MAX_LEN_FOR_KERNEL_LIST + 1)
+    {
+        kernelsList = kernelsList.substr(0, MAX_LEN_FOR_KERNEL_LIST + 1);
+        kernelsList[kernelsList.size() - 1] = '.';
     }
-    // write data as a block:
-    ofs.write(options, strlen(options));
-    log_info("OfflineCompiler: options added: %s\n", fileName.c_str());
-    return get_file_name(baseName, i, "");
+    return kernelsList;
 }
 
 static std::string get_offline_compilation_file_type_str(const CompilationMode compilationMode)
@@ -353,15 +308,14 @@ static std::string get_offline_compilation_command(const cl_uint device_address_
     return scriptToRunString;
 }
 
-static int invoke_offline_compiler(cl_context context,
-                                   const cl_uint device_address_space_size,
-                                   const CompilationMode compilationMode,
-                                   const std::string &bOptions,
-                                   const std::string &sourceFilename,
-                                   const std::string &outputFilename,
-                                   const bool openclCXX)
+static int get_offline_compiler_command(const cl_uint device_address_space_size,
+                                        const CompilationMode compilationMode,
+                                        const std::string &bOptions,
+                                        const std::string &sourceFilename,
+                                        const std::string &outputFilename,
+                                        const bool openclCXX,
+                                        std::string &runString)
 {
-    std::string runString;
     if (openclCXX)
     {
 #ifndef KHRONOS_OFFLINE_COMPILER
@@ -378,15 +332,274 @@ static int invoke_offline_compiler(cl_context context,
                                         sourceFilename, outputFilename);
     }
 
-    // execute script
-    log_info("Executing command: %s\n", runString.c_str());
-    fflush(stdout);
-    int returnCode = system(runString.c_str());
-    if (returnCode != 0)
+    return CL_SUCCESS;
+}
+
+// Everything about the device that can change the binary it builds
+static std::string get_device_identity(cl_device_id device)
+{
+    static const cl_device_info params[] = { CL_DEVICE_VENDOR, CL_DEVICE_NAME, CL_DEVICE_VERSION, CL_DRIVER_VERSION };
+    std::string identity;
+
+    for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++)
+    {
+        char buffer[1024] = "";
+        clGetDeviceInfo(device, params[i], sizeof(buffer) - 1, buffer, NULL);
+        identity += buffer;
+        identity += '\n';
+    }
+
+    return identity;
+}
+
+// The offline compilation cache is content addressed. Each entry is named after the kernels it holds
+// and a 64-bit hash of everything the compiler output depends on: source, build options, compilation
+// mode and, for binaries, the device. Looking an entry up is a single open, whatever the size of the
+// cache. Files are written under a temporary name and renamed into place, so processes sharing the
+// cache never see a partly written file. index.txt lists what each entry was built from.
+static cl_ulong get_cache_hash(const std::string &key)
+{
+    // 64-bit FNV-1a
+    cl_ulong hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < key.size(); i++)
     {
-        log_error("ERROR: Command finished with error: 0x%x\n", returnCode);
-        return CL_COMPILE_PROGRAM_FAILURE;
+        hash ^= (unsigned char) key[i];
+        hash *= 1099511628211ULL;
     }
+    return hash;
+}
+
+// Unique among all processes and threads using the cache
+static std::string get_temp_filename(const std::string &fileName)
+{
+    static std::mutex lock;
+    static unsigned int counter = 0;
+    std::lock_guard<std::mutex> guard(lock);
+    std::ostringstream name;
+#if defined(_WIN32)
+    name << fileName << ".tmp" << _getpid() << "." << counter++;
+#else
+    name << fileName << ".tmp" << getpid() << "." << counter++;
+#endif
+    return name.str();
+}
+
+// Moves a finished file into place. If another process got there first, its copy is kept.
+static bool rename_into_cache(const std::string &tempFilename, const std::string &fileName)
+{
+    if (rename(tempFilename.c_str(), fileName.c_str()) == 0)
+        return true;
+
+    remove(tempFilename.c_str());
+    return std::ifstream(fileName.c_str(), std::ios::binary).good();
+}
+
+static bool write_cache_file(const std::string &fileName, const std::string &content)
+{
+    std::string tempFilename = get_temp_filename(fileName);
+    std::ofstream ofs(tempFilename.c_str(), std::ios::binary);
+    if (!ofs.good())
+        return false;
+
+    ofs.write(content.data(), content.size());
+    ofs.close();
+    if (ofs.fail())
+    {
+        remove(tempFilename.c_str());
+        return false;
+    }
+    return rename_into_cache(tempFilename, fileName);
+}
+
+// Each record goes out in a single append, so records from different processes don't interleave
+static void append_cache_index(const std::string &record)
+{
+    std::string fileName = gCompilationCachePath + slash + "index.txt";
+    FILE *f = fopen(fileName.c_str(), "ab");
+    if (f == NULL)
+    {
+        log_info("OfflineCompiler: can't update cache index: %s\n", fileName.c_str());
+        return;
+    }
+    fwrite(record.data(), 1, record.size(), f);
+    fclose(f);
+}
+
+// Offline compiler driver. Commands are started with posix_spawn and at most --compilation-jobs of them
+// run at once, counting the ones started by other threads. Each command still goes through the shell,
+// as it did with system(), so the build scripts and the quoting of build options work as before.
+struct OfflineCompileJob
+{
+    std::string command;            // empty if the output is already there
+    std::string outputFilename;
+    std::string tempFilename;       // where the compiler writes, renamed to outputFilename when done
+    std::string indexRecord;        // line added to the cache index for a new entry
+    int         error;
+    double      seconds;            // wall time the compiler took
+};
+
+struct RunningCompiler
+{
+    size_t                                  job;
+    std::chrono::steady_clock::time_point   start;
+#if defined(_WIN32)
+    int                                     status;
+#else
+    pid_t                                   pid;
+#endif
+};
+
+static std::mutex gCompilerSlotLock;
+static std::condition_variable gCompilerSlotFree;
+static int gCompilersRunning = 0;
+
+// Outputs compiled by this process. They are up to date even with --compilation-cache-mode overwrite.
+static std::mutex gCompiledOutputsLock;
+static std::set<std::string> gCompiledOutputs;
+
+static int get_compilation_jobs(void)
+{
+    if (gCompilationJobs > 0)
+        return gCompilationJobs;
+
+    unsigned int cpus = std::thread::hardware_concurrency();
+    return cpus ? (int) cpus : 1;
+}
+
+// Takes a compiler slot. If wait is false, returns false instead of waiting for one to free up.
+static bool acquire_compiler_slot(bool wait)
+{
+    std::unique_lock<std::mutex> lock(gCompilerSlotLock);
+    int jobs = get_compilation_jobs();
+
+    if (wait)
+        gCompilerSlotFree.wait(lock, [jobs] { return gCompilersRunning < jobs; });
+    else if (gCompilersRunning >= jobs)
+        return false;
+
+    gCompilersRunning++;
+    return true;
+}
+
+static void release_compiler_slot(void)
+{
+    std::lock_guard<std::mutex> lock(gCompilerSlotLock);
+    gCompilersRunning--;
+    gCompilerSlotFree.notify_one();
+}
+
+#if defined(_WIN32)
+// No posix_spawn here, so the command runs to completion before this returns
+static int start_offline_compiler(const std::string &command, RunningCompiler &compiler)
+{
+    compiler.status = system(command.c_str());
+    return 0;
+}
+
+static bool reap_offline_compiler(RunningCompiler &compiler, int &status)
+{
+    status = compiler.status;
+    return true;
+}
+#else
+static int start_offline_compiler(const std::string &command, RunningCompiler &compiler)
+{
+    const char *argv[] = { "/bin/sh", "-c", command.c_str(), NULL };
+    return posix_spawn(&compiler.pid, "/bin/sh", NULL, NULL, (char *const *) argv, environ);
+}
+
+// Returns false if the compiler is still running
+static bool reap_offline_compiler(RunningCompiler &compiler, int &status)
+{
+    pid_t pid;
+    do
+    {
+        pid = waitpid(compiler.pid, &status, WNOHANG);
+    } while (pid == -1 && errno == EINTR);
+
+    if (pid == 0)
+        return false;
+    if (pid == -1)
+        status = -1;
+    return true;
+}
+#endif
+
+// Runs every job with a command and fills in its error and seconds. Returns the first error.
+static int run_offline_compile_jobs(std::vector<OfflineCompileJob> &jobs)
+{
+    std::vector<RunningCompiler> running;
+    size_t next = 0;
+
+    while (next < jobs.size() || !running.empty())
+    {
+        // Start as many jobs as there are free slots. Only wait for a slot when none of ours is running.
+        while (next < jobs.size() && (jobs[next].command.empty() || acquire_compiler_slot(running.empty())))
+        {
+            OfflineCompileJob &job = jobs[next];
+            RunningCompiler compiler;
+            compiler.job = next++;
+            if (job.command.empty())
+                continue;
+
+            log_info("Executing command: %s\n", job.command.c_str());
+            // Whatever the compiler prints must come after our own output
+            fflush(stdout);
+            compiler.start = std::chrono::steady_clock::now();
+            int error = start_offline_compiler(job.command, compiler);
+            if (error != 0)
+            {
+                log_error("ERROR: Unable to start command: %s\n", strerror(error));
+                job.error = CL_COMPILE_PROGRAM_FAILURE;
+                release_compiler_slot();
+                continue;
+            }
+            running.push_back(compiler);
+        }
+        if (running.empty())
+            continue;
+
+        // Collect a job that is done. Compiles take far longer than the poll interval, so polling
+        // keeps the timings accurate at no real cost.
+        int status = 0;
+        size_t i;
+        for (i = 0; i < running.size(); i++)
+            if (reap_offline_compiler(running[i], status))
+                break;
+        if (i == running.size())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        release_compiler_slot();
+
+        OfflineCompileJob &job = jobs[running[i].job];
+        job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - running[i].start).count();
+        running.erase(running.begin() + i);
+
+        if (status != 0)
+        {
+            log_error("ERROR: Command finished with error: 0x%x\n", status);
+            remove(job.tempFilename.c_str());
+            job.error = CL_COMPILE_PROGRAM_FAILURE;
+            continue;
+        }
+        if (!rename_into_cache(job.tempFilename, job.outputFilename))
+        {
+            log_error("ERROR: Unable to move compiler output into the cache: %s\n", job.outputFilename.c_str());
+            job.error = CL_COMPILE_PROGRAM_FAILURE;
+            continue;
+        }
+        append_cache_index(job.indexRecord);
+        log_info("OfflineCompiler: %s compiled in %.3f s\n", job.outputFilename.c_str(), job.seconds);
+
+        std::lock_guard<std::mutex> lock(gCompiledOutputsLock);
+        gCompiledOutputs.insert(job.outputFilename);
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++)
+        if (jobs[i].error != CL_SUCCESS)
+            return jobs[i].error;
 
     return CL_SUCCESS;
 }
@@ -432,15 +645,20 @@ static cl_int get_first_device_address_bits(const cl_context context, cl_uint &d
     return CL_SUCCESS;
 }
 
-static int get_offline_compiler_output(std::ifstream &ifs,
-                                       cl_context context,
+// Works out where the compiler output for kernel goes. If the output has to be built, writes the
+// source file and sets job.command, otherwise leaves the command empty.
+static int prepare_offline_compile_job(cl_context context,
                                        const std::string &kernel,
                                        const bool openclCXX,
                                        const CompilationMode compilationMode,
                                        const std::string &bOptions,
-                                       const std::string &kernelName)
+                                       OfflineCompileJob &job)
 {
-    std::string sourceFilename = gCompilationCachePath + slash + kernelName + ".cl";
+    job.command.clear();
+    job.tempFilename.clear();
+    job.indexRecord.clear();
+    job.error = CL_SUCCESS;
+    job.seconds = 0.0;
 
     // Get device CL_DEVICE_ADDRESS_BITS
     cl_uint device_address_space_size = 0;
@@ -448,61 +666,144 @@ static int get_offline_compiler_output(std::ifstream &ifs,
     if (error != CL_SUCCESS)
         return error;
 
-    std::string outputFilename = gCompilationCachePath + slash + kernelName;
+    // SPIR-V only depends on the address bits, which are in the file extension. Binaries depend on
+    // the whole device.
+    std::string file_type = get_offline_compilation_file_type_str(compilationMode);
+    std::ostringstream device;
+    if (compilationMode == kBinary)
+    {
+        cl_device_id id;
+        error = get_first_device_id(context, id);
+        if (error != CL_SUCCESS)
+            return error;
+        device << get_device_identity(id);
+    }
+    device << device_address_space_size;
+
+    std::string key = kernel + '\0' + bOptions + '\0' + file_type + (openclCXX ? " C++" : "") + '\0' + device.str();
+    std::ostringstream entryName;
+    entryName << get_kernel_list(kernel) << std::hex << std::setfill('0') << std::setw(16) << get_cache_hash(key);
+
+    std::string baseName = gCompilationCachePath + slash + entryName.str();
+    std::string sourceFilename = baseName + ".cl";
+    job.outputFilename = baseName;
     if (compilationMode == kSpir_v)
     {
         std::ostringstream extension;
         extension << ".spv" << device_address_space_size;
-        outputFilename += extension.str();
+        job.outputFilename += extension.str();
+    }
+
+    bool compiledHere;
+    {
+        std::lock_guard<std::mutex> lock(gCompiledOutputsLock);
+        compiledHere = gCompiledOutputs.count(job.outputFilename) != 0;
     }
 
     // try to read cached output file when test is run with gCompilationCacheMode != kCacheModeOverwrite
-    ifs.open(outputFilename.c_str(), std::ios::binary);
+    if (compiledHere
+        || (gCompilationCacheMode != kCacheModeOverwrite
+            && std::ifstream(job.outputFilename.c_str(), std::ios::binary).good()))
+        return CL_SUCCESS;
 
-    if (gCompilationCacheMode == kCacheModeOverwrite || !ifs.good())
+    if (gCompilationCacheMode == kCacheModeForceRead)
     {
-        std::string file_type = get_offline_compilation_file_type_str(compilationMode);
+        log_info("OfflineCompiler: can't open cached %s file: %s\n",
+                 file_type.c_str(), job.outputFilename.c_str());
+        return -1;
+    }
 
-        if (gCompilationCacheMode == kCacheModeForceRead)
-        {
-            log_info("OfflineCompiler: can't open cached %s file: %s\n",
-                     file_type.c_str(), outputFilename.c_str());
-            return -1;
-        }
+    if (gCompilationCacheMode != kCacheModeOverwrite)
+        log_info("OfflineCompiler: can't find cached %s file: %s\n",
+                 file_type.c_str(), job.outputFilename.c_str());
 
-        ifs.close();
+    // The options go next to the source, where generate_spirv_offline.py looks for them
+    if (!write_cache_file(sourceFilename, kernel)
+        || (!bOptions.empty() && !write_cache_file(baseName + ".options", bOptions)))
+    {
+        log_info("OfflineCompiler: can't create source file: %s\n", sourceFilename.c_str());
+        return -1;
+    }
 
-        if (gCompilationCacheMode != kCacheModeOverwrite)
-            log_info("OfflineCompiler: can't find cached %s file: %s\n",
-                     file_type.c_str(), outputFilename.c_str());
+    std::string deviceDescription = device.str();
+    std::replace(deviceDescription.begin(), deviceDescription.end(), '\n', ' ');
+    job.indexRecord = entryName.str() + "\t" + file_type + "\t" + deviceDescription + "\t" + bOptions + "\n";
+    job.tempFilename = get_temp_filename(job.outputFilename);
 
-        std::ofstream ofs(sourceFilename.c_str(), std::ios::binary);
-        if (!ofs.good())
-        {
-            log_info("OfflineCompiler: can't create source file: %s\n", sourceFilename.c_str());
-            return -1;
-        }
+    return get_offline_compiler_command(device_address_space_size, compilationMode, bOptions,
+                                        sourceFilename, job.tempFilename, openclCXX, job.command);
+}
 
-        // write source to input file
-        ofs.write(kernel.c_str(), kernel.size());
-        ofs.close();
+static int get_offline_compiler_output(std::ifstream &ifs,
+                                       cl_context context,
+                                       const std::string &kernel,
+                                       const bool openclCXX,
+                                       const CompilationMode compilationMode,
+                                       const std::string &bOptions)
+{
+    std::vector<OfflineCompileJob> jobs(1);
+    int error = prepare_offline_compile_job(context, kernel, openclCXX, compilationMode, bOptions, jobs[0]);
+    if (error != CL_SUCCESS)
+        return error;
 
-        error = invoke_offline_compiler(context, device_address_space_size, compilationMode,
-                                        bOptions, sourceFilename, outputFilename, openclCXX);
+    error = run_offline_compile_jobs(jobs);
+    if (error != CL_SUCCESS)
+        return error;
+
+    // read output file
+    ifs.open(jobs[0].outputFilename.c_str(), std::ios::binary);
+    if (!ifs.good())
+    {
+        std::string file_type = get_offline_compilation_file_type_str(compilationMode);
+        log_info("OfflineCompiler: can't read generated %s file: %s\n",
+                 file_type.c_str(), jobs[0].outputFilename.c_str());
+        return -1;
+    }
+
+    return CL_SUCCESS;
+}
+
+int compile_offline_programs(cl_context context,
+                             unsigned int numPrograms,
+                             const unsigned int *numKernelLines,
+                             const char **const *kernelPrograms,
+                             const char *const *buildOptions,
+                             const bool openclCXX)
+{
+    if (gCompilationMode == kOnline)
+        return CL_SUCCESS;
+
+    std::vector<OfflineCompileJob> jobs;
+    std::set<std::string> outputs;
+    for (unsigned int i = 0; i < numPrograms; i++)
+    {
+        const char *options = buildOptions ? buildOptions[i] : NULL;
+        std::string kernel = get_kernel_content(numKernelLines[i], kernelPrograms[i]);
+
+        OfflineCompileJob job;
+        int error = prepare_offline_compile_job(context, kernel, openclCXX, gCompilationMode,
+                                                options ? std::string(options) : "", job);
         if (error != CL_SUCCESS)
             return error;
 
-        // read output file
-        ifs.open(outputFilename.c_str(), std::ios::binary);
-        if (!ifs.good())
-        {
-            log_info("OfflineCompiler: can't read generated %s file: %s\n",
-                     file_type.c_str(), outputFilename.c_str());
-            return -1;
-        }
+        // The same program may be in the batch more than once
+        if (!job.command.empty() && outputs.insert(job.outputFilename).second)
+            jobs.push_back(job);
     }
+    if (jobs.empty())
+        return CL_SUCCESS;
 
-    return CL_SUCCESS;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int error = run_offline_compile_jobs(jobs);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double compilerSeconds = 0.0;
+    for (size_t i = 0; i < jobs.size(); i++)
+        compilerSeconds += jobs[i].seconds;
+    log_info("OfflineCompiler: compiled %u programs in %.3f s (%.3f s of compiler time, up to %d at once)\n",
+             (unsigned int) jobs.size(), seconds, compilerSeconds, get_compilation_jobs());
+
+    return error;
 }
 
 static int create_single_kernel_helper_create_program_offline(cl_context context,
@@ -515,16 +816,13 @@ static int create_single_kernel_helper_create_program_offline(cl_context context
 {
     int error;
     std::string kernel = get_kernel_content(numKernelLines, kernelProgram);
-    std::string kernelName = get_kernel_name(kernel);
 
     // set build options
     std::string bOptions;
     bOptions += buildOptions ? std::string(buildOptions) : "";
 
-    kernelName = add_build_options(kernelName, buildOptions);
-
     std::ifstream ifs;
-    error = get_offline_compiler_output(ifs, context, kernel, openclCXX, compilationMode, bOptions, kernelName);
+    error = get_offline_compiler_output(ifs, context, kernel, openclCXX, compilationMode, bOptions);
     if (error != CL_SUCCESS)
         return error;
 
@@ -642,6 +940,27 @@ int create_single_kernel_helper_with_build_options(cl_context context,
     return create_single_kernel_helper(context, outProgram, outKernel, numKernelLines, kernelProgram, kernelName, buildOptions, openclCXX);
 }
 
+static std::string remove_offline_compiler_options(const char *buildOptions)
+{
+    std::string newBuildOptions;
+    if (buildOptions != NULL)
+    {
+        newBuildOptions = buildOptions;
+        std::string offlineCompierOptions[] = {
+            "-cl-fp16-enable",
+            "-cl-fp64-enable",
+            "-cl-zero-init-local-mem-vars"
+        };
+        for(auto& s : offlineCompierOptions)
+        {
+            std::string::size_type i = newBuildOptions.find(s);
+            if (i != std::string::npos)
+                newBuildOptions.erase(i, s.length());
+        }
+    }
+    return newBuildOptions;
+}
+
 // Creates and builds OpenCL C/C++ program, and creates a kernel
 int create_single_kernel_helper(cl_context context,
                                 cl_program *outProgram,
@@ -653,6 +972,15 @@ int create_single_kernel_helper(cl_context context,
                                 const bool openclCXX)
 {
     int error;
+    // Programs built for a shared context are reused by every test that runs in it
+    if (!openclCXX && gCompilationMode == kOnline && is_shared_context(context))
+    {
+        if (outKernel == NULL)
+            return create_program_cached(context, outProgram, numKernelLines, kernelProgram, buildOptions);
+        return create_single_kernel_helper_cached(context, outProgram, outKernel, numKernelLines, kernelProgram,
+                                                  kernelName, buildOptions);
+    }
+
     // Create OpenCL C++ program
     if(openclCXX)
     {
@@ -697,22 +1025,7 @@ int create_single_kernel_helper(cl_context context,
         }
     }
     // Remove offline-compiler-only build options
-    std::string newBuildOptions;
-    if (buildOptions != NULL)
-    {
-        newBuildOptions = buildOptions;
-        std::string offlineCompierOptions[] = {
-            "-cl-fp16-enable",
-            "-cl-fp64-enable",
-            "-cl-zero-init-local-mem-vars"
-        };
-        for(auto& s : offlineCompierOptions)
-        {
-            std::string::size_type i = newBuildOptions.find(s);
-            if (i != std::string::npos)
-                newBuildOptions.erase(i, s.length());
-        }
-    }
+    std::string newBuildOptions = remove_offline_compiler_options(buildOptions);
     // Build program and create kernel
     return build_program_create_kernel_helper(
         context, outProgram, outKernel, numKernelLines, kernelProgram, kernelName, newBuildOptions.c_str()
@@ -745,7 +1058,9 @@ int build_program_create_kernel_helper(cl_context context,
     /* Compile the program */
     int buildProgramFailed = 0;
     int printedSource = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     error = clBuildProgram(*outProgram, 0, NULL, buildOptions, NULL, NULL);
+    test_metrics_add_build(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     if (error != CL_SUCCESS)
     {
         unsigned int i;
@@ -890,6 +1205,264 @@ int build_program_create_kernel_helper(cl_context context,
     return 0;
 }
 
+// Program cache used by create_program_cached. Every distinct (context, options, source) gets one entry.
+// The entry lock is held while the program is built, so identical requests made at the same time wait
+// for the first one rather than building the program again.
+struct CachedProgram
+{
+    std::mutex  lock;
+    bool        built;
+    cl_int      error;
+    cl_program  program;
+
+    CachedProgram() : built(false), error(CL_SUCCESS), program(NULL) {}
+};
+
+static std::mutex gProgramCacheLock;
+static std::map<std::string, std::shared_ptr<CachedProgram> > gProgramCache;
+
+#define PROGRAM_CACHE_MAGIC "CLPROGC1"
+
+// On disk, a program is stored in <CL_PROGRAM_CACHE>/<crc32 of key>.bin as
+//   magic, key size, key, binary size, binary
+// The key holds the device identity, options and full source. It is compared on load, so a crc32
+// collision is just a cache miss.
+static std::string get_program_cache_path(const std::string &key)
+{
+    std::ostringstream path;
+    path << getenv("CL_PROGRAM_CACHE") << slash << std::hex << std::setfill('0') << std::setw(8)
+         << crc32(key.data(), key.size()) << ".bin";
+    return path.str();
+}
+
+static cl_program load_cached_binary(cl_context context, cl_device_id device, const std::string &key, const std::string &options)
+{
+    std::string path = get_program_cache_path(key);
+    std::vector<char> content = get_file_content(path);
+    size_t headerSize = sizeof(PROGRAM_CACHE_MAGIC) - 1 + 2 * sizeof(cl_ulong);
+    cl_ulong keySize, binarySize;
+
+    if (content.size() < headerSize + key.size()
+        || memcmp(&content[0], PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC) - 1))
+        return NULL;
+
+    const char *p = &content[0] + sizeof(PROGRAM_CACHE_MAGIC) - 1;
+    memcpy(&keySize, p, sizeof(keySize));
+    p += sizeof(keySize);
+    if (keySize != key.size() || memcmp(p, key.data(), key.size()))
+        return NULL;
+    p += key.size();
+    memcpy(&binarySize, p, sizeof(binarySize));
+    p += sizeof(binarySize);
+    if (binarySize == 0 || content.size() != headerSize + key.size() + binarySize)
+        return NULL;
+
+    // A binary the driver no longer accepts is just a miss
+    size_t length = (size_t) binarySize;
+    const unsigned char *binary = (const unsigned char *) p;
+    cl_int error, status;
+    cl_program program = clCreateProgramWithBinary(context, 1, &device, &length, &binary, &status, &error);
+    if (program == NULL || error != CL_SUCCESS || status != CL_SUCCESS)
+    {
+        if (program)
+            clReleaseProgram(program);
+        return NULL;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    error = clBuildProgram(program, 0, NULL, options.c_str(), NULL, NULL);
+    test_metrics_add_build(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (error != CL_SUCCESS)
+    {
+        clReleaseProgram(program);
+        return NULL;
+    }
+
+    return program;
+}
+
+static void save_cached_binary(cl_program program, const std::string &key)
+{
+    size_t length = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(length), &length, NULL) != CL_SUCCESS || length == 0)
+        return;
+
+    std::vector<unsigned char> binary(length);
+    unsigned char *binaries[] = { &binary[0] };
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL) != CL_SUCCESS)
+        return;
+
+    cl_ulong keySize = key.size(), binarySize = length;
+    std::string content(PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC) - 1);
+    content.append((const char *) &keySize, sizeof(keySize));
+    content.append(key);
+    content.append((const char *) &binarySize, sizeof(binarySize));
+    content.append((const char *) &binary[0], length);
+
+    // Other processes may share the cache, so the entry only appears once it is complete
+    std::string path = get_program_cache_path(key);
+    if (!write_cache_file(path, content))
+        log_info("Program cache: can't create %s\n", path.c_str());
+}
+
+static int build_program_for_cache(cl_context context,
+                                   cl_program *outProgram,
+                                   unsigned int numKernelLines,
+                                   const char **kernelProgram,
+                                   const std::string &source,
+                                   const std::string &options)
+{
+    std::string diskKey;
+    cl_uint numDevices = 0;
+    cl_device_id device = NULL;
+    int error;
+
+    // Binaries are only kept on disk for single device contexts
+    if (getenv("CL_PROGRAM_CACHE")
+        && clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES, sizeof(numDevices), &numDevices, NULL) == CL_SUCCESS
+        && numDevices == 1
+        && get_first_device_id(context, device) == CL_SUCCESS)
+    {
+        diskKey = get_device_identity(device) + options + '\n' + source;
+        if ((*outProgram = load_cached_binary(context, device, diskKey, options)) != NULL)
+            return CL_SUCCESS;
+    }
+
+    *outProgram = clCreateProgramWithSource(context, numKernelLines, kernelProgram, NULL, &error);
+    if (*outProgram == NULL || error != CL_SUCCESS)
+    {
+        print_error(error, "clCreateProgramWithSource failed");
+        return error;
+    }
+
+    error = build_program_create_kernel_helper(context, outProgram, NULL, numKernelLines, kernelProgram, NULL, options.c_str());
+    if (error != CL_SUCCESS)
+    {
+        clReleaseProgram(*outProgram);
+        *outProgram = NULL;
+        return error;
+    }
+
+    if (!diskKey.empty())
+        save_cached_binary(*outProgram, diskKey);
+
+    return CL_SUCCESS;
+}
+
+int create_program_cached(cl_context context,
+                          cl_program *outProgram,
+                          unsigned int numKernelLines,
+                          const char **kernelProgram,
+                          const char *buildOptions)
+{
+    if (gCompilationMode != kOnline)
+        return create_single_kernel_helper(context, outProgram, NULL, numKernelLines, kernelProgram, NULL, buildOptions);
+
+    std::string source = get_kernel_content(numKernelLines, kernelProgram);
+    std::string options = remove_offline_compiler_options(buildOptions);
+    std::ostringstream key;
+    key << (void *) context << '\n' << options << '\n' << source;
+
+    std::shared_ptr<CachedProgram> entry;
+    {
+        std::lock_guard<std::mutex> guard(gProgramCacheLock);
+        std::shared_ptr<CachedProgram> &slot = gProgramCache[key.str()];
+        if (!slot)
+            slot = std::make_shared<CachedProgram>();
+        entry = slot;
+    }
+
+    std::lock_guard<std::mutex> guard(entry->lock);
+    if (!entry->built)
+    {
+        entry->error = build_program_for_cache(context, &entry->program, numKernelLines, kernelProgram, source, options);
+        entry->built = true;
+    }
+
+    // A failed build is remembered too, so the build log is only printed once
+    if (entry->error != CL_SUCCESS)
+        return entry->error;
+
+    clRetainProgram(entry->program);
+    *outProgram = entry->program;
+    return CL_SUCCESS;
+}
+
+int create_single_kernel_helper_cached(cl_context context,
+                                       cl_program *outProgram,
+                                       cl_kernel *outKernel,
+                                       unsigned int numKernelLines,
+                                       const char **kernelProgram,
+                                       const char *kernelName,
+                                       const char *buildOptions)
+{
+    int error = create_program_cached(context, outProgram, numKernelLines, kernelProgram, buildOptions);
+    if (error != CL_SUCCESS)
+        return error;
+
+    *outKernel = clCreateKernel(*outProgram, kernelName, &error);
+    if (*outKernel == NULL || error != CL_SUCCESS)
+    {
+        print_error(error, "Unable to create kernel");
+        return error;
+    }
+
+    return CL_SUCCESS;
+}
+
+void release_program_cache(void)
+{
+    std::lock_guard<std::mutex> guard(gProgramCacheLock);
+    for (auto &entry : gProgramCache)
+        if (entry.second->program)
+            clReleaseProgram(entry.second->program);
+    gProgramCache.clear();
+}
+
+// Contexts handed out by get_shared_context, one per device
+static std::mutex gSharedContextLock;
+static std::map<cl_device_id, cl_context> gSharedContexts;
+
+int get_shared_context(cl_device_id device, cl_context *outContext)
+{
+    std::lock_guard<std::mutex> guard(gSharedContextLock);
+    cl_context &context = gSharedContexts[device];
+    if (context == NULL)
+    {
+        int error;
+        context = clCreateContext(NULL, 1, &device, notify_callback, NULL, &error);
+        if (context == NULL || error != CL_SUCCESS)
+        {
+            print_error(error, "Unable to create shared testing context");
+            gSharedContexts.erase(device);
+            return error != CL_SUCCESS ? error : -1;
+        }
+    }
+
+    clRetainContext(context);
+    *outContext = context;
+    return CL_SUCCESS;
+}
+
+bool is_shared_context(cl_context context)
+{
+    std::lock_guard<std::mutex> guard(gSharedContextLock);
+    for (auto &entry : gSharedContexts)
+        if (entry.second == context)
+            return true;
+    return false;
+}
+
+void release_shared_contexts(void)
+{
+    // Cached programs hold references to their contexts
+    release_program_cache();
+
+    std::lock_guard<std::mutex> guard(gSharedContextLock);
+    for (auto &entry : gSharedContexts)
+        clReleaseContext(entry.second);
+    gSharedContexts.clear();
+}
+
 int get_device_version( cl_device_id id, size_t* major, size_t* minor)
 {
     cl_char buffer[ 4098 ];
@@ -96,6 +96,16 @@ extern int create_openclcpp_program(cl_context context,
                                     const char **kernelProgram,
                                     const char *buildOptions = NULL);
 
+/* Runs the offline compiler for several programs at once, up to --compilation-jobs at a time, so that
+ * later calls for the same sources and options find the compiler output ready. Honours
+ * --compilation-cache-mode and logs how long each compile took. Does nothing in online compilation mode. */
+extern int compile_offline_programs(cl_context context,
+                                    unsigned int numPrograms,
+                                    const unsigned int *numKernelLines,
+                                    const char **const *kernelPrograms,
+                                    const char *const *buildOptions = NULL,
+                                    const bool openclCXX = false);
+
 /* Builds program (outProgram) and creates one kernel */
 int build_program_create_kernel_helper(cl_context context,
                                        cl_program *outProgram,
@@ -105,6 +115,41 @@ int build_program_create_kernel_helper(cl_context context,
                                        const char *kernelName,
                                        const char *buildOptions = NULL);
 
+/* Creates and builds a program, sharing the result between all identical requests (same context, source
+ * and options) made by the process. Safe to call from several threads at once, e.g. from ThreadPool jobs,
+ * and a request made while an identical one is being built waits for it instead of building again.
+ * When the CL_PROGRAM_CACHE environment variable names a directory, program binaries are also kept there
+ * across runs, keyed by device, driver version, options and source. The caller owns a reference to
+ * *outProgram. Offline compilation modes bypass the cache. */
+extern int create_program_cached(cl_context context,
+                                 cl_program *outProgram,
+                                 unsigned int numKernelLines,
+                                 const char **kernelProgram,
+                                 const char *buildOptions = NULL);
+
+/* Same as create_single_kernel_helper, built through create_program_cached */
+extern int create_single_kernel_helper_cached(cl_context context,
+                                              cl_program *outProgram,
+                                              cl_kernel *outKernel,
+                                              unsigned int numKernelLines,
+                                              const char **kernelProgram,
+                                              const char *kernelName,
+                                              const char *buildOptions = NULL);
+
+/* Drops the references held by the program cache. Call before releasing the context. */
+extern void release_program_cache(void);
+
+/* Returns a new reference to a context on the device that is kept until release_shared_contexts, so
+ * that tests run with --shared-context don't pay for a context and for their builds every time.
+ * create_single_kernel_helper builds programs for these contexts through create_program_cached. */
+extern int get_shared_context(cl_device_id device, cl_context *outContext);
+
+/* True for contexts returned by get_shared_context */
+extern bool is_shared_context(cl_context context);
+
+/* Drops the program cache and the references held to the shared contexts */
+extern void release_shared_contexts(void);
+
 /* Helper to obtain the biggest fit work group size for all the devices in a given group and for the given global thread size */
 extern int get_max_common_work_group_size( cl_context context, cl_kernel kernel, size_t globalThreadSize, size_t *outSize );
 
@@ -46,6 +46,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "mt19937.h"
 #include "mingw_compat.h"
 
@@ -136,104 +137,216 @@ void    free_mtdata( MTdata d )
         align_free(d);
 }
 
-/* generates a random number on [0,0xffffffff]-interval */
-cl_uint genrand_int32( MTdata d)
+/* mag01[x] = x * MATRIX_A  for x=0,1 */
+static const cl_uint mag01[2]={0x0UL, MATRIX_A};
+
+#if defined( __SSE2__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) ) && ( defined( __clang__ ) || ( defined( __GNUC__ ) && __GNUC__ >= 5 ) )
+    #include <immintrin.h>
+    #define MT_HAS_AVX2 1
+
+/* Same as the SSE2 code in mt_generate, 8 words at a time */
+__attribute__(( target( "avx2" ) )) static void mt_generate_avx2( MTdata d )
+{
+    const __m256i upper_mask = _mm256_set1_epi32( (int) UPPER_MASK );
+    const __m256i lower_mask = _mm256_set1_epi32( (int) LOWER_MASK );
+    const __m256i one = _mm256_set1_epi32( 1 );
+    const __m256i matrix_a = _mm256_set1_epi32( (int) MATRIX_A );
+    const __m256i c0 = _mm256_set1_epi32( (int) 0x9d2c5680UL );
+    const __m256i c1 = _mm256_set1_epi32( (int) 0xefc60000UL );
+    cl_uint *mt = d->mt;
+    cl_uint y;
+    int kk = 0;
+
+    for( ; kk + 8 <= N-M; kk += 8 )
+    {
+        __m256i vy = _mm256_or_si256( _mm256_and_si256( _mm256_loadu_si256( (__m256i*)(mt + kk) ), upper_mask ),
+                                      _mm256_and_si256( _mm256_loadu_si256( (__m256i*)(mt + kk + 1) ), lower_mask ));
+        __m256i vmag01 = _mm256_and_si256( _mm256_cmpeq_epi32( _mm256_and_si256( vy, one ), one ), matrix_a );
+        __m256i vr = _mm256_xor_si256( _mm256_loadu_si256( (__m256i*)(mt + kk + M) ), _mm256_srli_epi32( vy, 1 ) );
+        _mm256_storeu_si256( (__m256i*)(mt + kk), _mm256_xor_si256( vr, vmag01 ) );
+    }
+    for ( ;kk<N-M;kk++) {
+        y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
+        mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    }
+
+    // mt[kk+M-N] was written at least N-M words ago, so 8 at a time is safe here too
+    for( ; kk + 8 <= N-1; kk += 8 )
+    {
+        __m256i vy = _mm256_or_si256( _mm256_and_si256( _mm256_loadu_si256( (__m256i*)(mt + kk) ), upper_mask ),
+                                      _mm256_and_si256( _mm256_loadu_si256( (__m256i*)(mt + kk + 1) ), lower_mask ));
+        __m256i vmag01 = _mm256_and_si256( _mm256_cmpeq_epi32( _mm256_and_si256( vy, one ), one ), matrix_a );
+        __m256i vr = _mm256_xor_si256( _mm256_loadu_si256( (__m256i*)(mt + kk + M - N) ), _mm256_srli_epi32( vy, 1 ) );
+        _mm256_storeu_si256( (__m256i*)(mt + kk), _mm256_xor_si256( vr, vmag01 ) );
+    }
+    for (;kk<N-1;kk++) {
+        y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
+        mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    }
+    y = (cl_uint)((mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK));
+    mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+
+    for( kk = 0; kk + 8 <= N; kk += 8 )
+    {
+        __m256i vy = _mm256_loadu_si256( (__m256i*)(mt + kk) );
+        vy = _mm256_xor_si256( vy, _mm256_srli_epi32( vy, 11 ) );
+        vy = _mm256_xor_si256( vy, _mm256_and_si256( _mm256_slli_epi32( vy, 7 ), c0 ) );
+        vy = _mm256_xor_si256( vy, _mm256_and_si256( _mm256_slli_epi32( vy, 15 ), c1 ) );
+        vy = _mm256_xor_si256( vy, _mm256_srli_epi32( vy, 18 ) );
+        _mm256_storeu_si256( (__m256i*)(d->cache + kk), vy );
+    }
+
+    d->mti = 0;
+}
+#endif
+
+/* generate N words at one time */
+static void mt_generate( MTdata d )
 {
-    /* mag01[x] = x * MATRIX_A  for x=0,1 */
-    static const cl_uint mag01[2]={0x0UL, MATRIX_A};
 #ifdef __SSE2__
     static volatile int init = 0;
     static union{ __m128i v; cl_uint s[4]; } upper_mask, lower_mask, one, matrix_a, c0, c1;
 #endif
-
-
     cl_uint *mt = d->mt;
     cl_uint y;
+    int kk;
 
-    if (d->mti == N)
-    { /* generate N words at one time */
-        int kk;
+#ifdef MT_HAS_AVX2
+    static volatile int has_avx2 = -1;
+
+    if( has_avx2 < 0 )
+        has_avx2 = __builtin_cpu_supports( "avx2" ) ? 1 : 0;
+    if( has_avx2 )
+    {
+        mt_generate_avx2( d );
+        return;
+    }
+#endif
 
 #ifdef __SSE2__
-        if( 0 == init )
-        {
-            upper_mask.s[0] = upper_mask.s[1] = upper_mask.s[2] = upper_mask.s[3] = UPPER_MASK;
-            lower_mask.s[0] = lower_mask.s[1] = lower_mask.s[2] = lower_mask.s[3] = LOWER_MASK;
-            one.s[0] = one.s[1] = one.s[2] = one.s[3] = 1;
-            matrix_a.s[0] = matrix_a.s[1] = matrix_a.s[2] = matrix_a.s[3] = MATRIX_A;
-            c0.s[0] = c0.s[1] = c0.s[2] = c0.s[3] = (cl_uint) 0x9d2c5680UL;
-            c1.s[0] = c1.s[1] = c1.s[2] = c1.s[3] = (cl_uint) 0xefc60000UL;
-            init = 1;
-        }
+    if( 0 == init )
+    {
+        upper_mask.s[0] = upper_mask.s[1] = upper_mask.s[2] = upper_mask.s[3] = UPPER_MASK;
+        lower_mask.s[0] = lower_mask.s[1] = lower_mask.s[2] = lower_mask.s[3] = LOWER_MASK;
+        one.s[0] = one.s[1] = one.s[2] = one.s[3] = 1;
+        matrix_a.s[0] = matrix_a.s[1] = matrix_a.s[2] = matrix_a.s[3] = MATRIX_A;
+        c0.s[0] = c0.s[1] = c0.s[2] = c0.s[3] = (cl_uint) 0x9d2c5680UL;
+        c1.s[0] = c1.s[1] = c1.s[2] = c1.s[3] = (cl_uint) 0xefc60000UL;
+        init = 1;
+    }
 #endif
 
-        kk = 0;
+    kk = 0;
 #ifdef __SSE2__
-        // vector loop
-        for( ; kk + 4 <= N-M; kk += 4 )
-        {
-            __m128i vy = _mm_or_si128(  _mm_and_si128( _mm_load_si128( (__m128i*)(mt + kk) ), upper_mask.v ),
-                                        _mm_and_si128( _mm_loadu_si128( (__m128i*)(mt + kk + 1) ), lower_mask.v ));        //  ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
-
-            __m128i mask = _mm_cmpeq_epi32( _mm_and_si128( vy, one.v), one.v );                                         // y & 1 ? -1 : 0
-            __m128i vmag01 = _mm_and_si128( mask, matrix_a.v );                                                         // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
-            __m128i vr = _mm_xor_si128( _mm_loadu_si128( (__m128i*)(mt + kk + M)), (__m128i) _mm_srli_epi32( vy, 1 ) );    // mt[kk+M] ^ (y >> 1)
-            vr = _mm_xor_si128( vr, vmag01 );                                                                           // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
-            _mm_store_si128( (__m128i*) (mt + kk ), vr );
-        }
+    // vector loop
+    for( ; kk + 4 <= N-M; kk += 4 )
+    {
+        __m128i vy = _mm_or_si128(  _mm_and_si128( _mm_load_si128( (__m128i*)(mt + kk) ), upper_mask.v ),
+                                    _mm_and_si128( _mm_loadu_si128( (__m128i*)(mt + kk + 1) ), lower_mask.v ));        //  ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
+
+        __m128i mask = _mm_cmpeq_epi32( _mm_and_si128( vy, one.v), one.v );                                         // y & 1 ? -1 : 0
+        __m128i vmag01 = _mm_and_si128( mask, matrix_a.v );                                                         // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
+        __m128i vr = _mm_xor_si128( _mm_loadu_si128( (__m128i*)(mt + kk + M)), (__m128i) _mm_srli_epi32( vy, 1 ) );    // mt[kk+M] ^ (y >> 1)
+        vr = _mm_xor_si128( vr, vmag01 );                                                                           // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
+        _mm_store_si128( (__m128i*) (mt + kk ), vr );
+    }
 #endif
-        for ( ;kk<N-M;kk++) {
-            y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
-            mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
-        }
+    for ( ;kk<N-M;kk++) {
+        y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
+        mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    }
 
 #ifdef __SSE2__
-        // advance to next aligned location
-        for (;kk<N-1 && (kk & 3);kk++) {
-            y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
-            mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
-        }
+    // advance to next aligned location
+    for (;kk<N-1 && (kk & 3);kk++) {
+        y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
+        mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    }
 
-        // vector loop
-        for( ; kk + 4 <= N-1; kk += 4 )
-        {
-            __m128i vy = _mm_or_si128(  _mm_and_si128( _mm_load_si128( (__m128i*)(mt + kk) ), upper_mask.v ),
-                                        _mm_and_si128( _mm_loadu_si128( (__m128i*)(mt + kk + 1) ), lower_mask.v ));        //  ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
-
-            __m128i mask = _mm_cmpeq_epi32( _mm_and_si128( vy, one.v), one.v );                                         // y & 1 ? -1 : 0
-            __m128i vmag01 = _mm_and_si128( mask, matrix_a.v );                                                         // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
-            __m128i vr = _mm_xor_si128( _mm_loadu_si128( (__m128i*)(mt + kk + M - N)), _mm_srli_epi32( vy, 1 ) );          // mt[kk+M-N] ^ (y >> 1)
-            vr = _mm_xor_si128( vr, vmag01 );                                                                           // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
-            _mm_store_si128( (__m128i*) (mt + kk ), vr );
-        }
+    // vector loop
+    for( ; kk + 4 <= N-1; kk += 4 )
+    {
+        __m128i vy = _mm_or_si128(  _mm_and_si128( _mm_load_si128( (__m128i*)(mt + kk) ), upper_mask.v ),
+                                    _mm_and_si128( _mm_loadu_si128( (__m128i*)(mt + kk + 1) ), lower_mask.v ));        //  ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
+
+        __m128i mask = _mm_cmpeq_epi32( _mm_and_si128( vy, one.v), one.v );                                         // y & 1 ? -1 : 0
+        __m128i vmag01 = _mm_and_si128( mask, matrix_a.v );                                                         // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
+        __m128i vr = _mm_xor_si128( _mm_loadu_si128( (__m128i*)(mt + kk + M - N)), _mm_srli_epi32( vy, 1 ) );          // mt[kk+M-N] ^ (y >> 1)
+        vr = _mm_xor_si128( vr, vmag01 );                                                                           // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
+        _mm_store_si128( (__m128i*) (mt + kk ), vr );
+    }
 #endif
 
-        for (;kk<N-1;kk++) {
-            y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
-            mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
-        }
-        y = (cl_uint)((mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK));
-        mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    for (;kk<N-1;kk++) {
+        y = (cl_uint) ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK));
+        mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    }
+    y = (cl_uint)((mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK));
+    mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+
+#ifdef __SSE2__
+    // Do the tempering ahead of time in vector code
+    for( kk = 0; kk + 4 <= N; kk += 4 )
+    {
+        __m128i vy = _mm_load_si128( (__m128i*)(mt + kk ) );                            // y = mt[k];
+        vy = _mm_xor_si128( vy, _mm_srli_epi32( vy, 11 ) );                             // y ^= (y >> 11);
+        vy = _mm_xor_si128( vy, _mm_and_si128( _mm_slli_epi32( vy, 7 ), c0.v) );        // y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
+        vy = _mm_xor_si128( vy, _mm_and_si128( _mm_slli_epi32( vy, 15 ), c1.v) );       // y ^= (y << 15) & (cl_uint) 0xefc60000UL;
+        vy = _mm_xor_si128( vy, _mm_srli_epi32( vy, 18 ) );                             // y ^= (y >> 18);
+        _mm_store_si128( (__m128i*)(d->cache+kk), vy );
+    }
+#endif
+
+    d->mti = 0;
+}
+
+/* Returns the next n numbers on [0,0xffffffff]-interval, the same as n calls to genrand_int32 */
+void genrand_int32_block( MTdata d, cl_uint *out, size_t n )
+{
+    while( n > 0 )
+    {
+        size_t count;
 
+        if( d->mti == N )
+            mt_generate( d );
+
+        count = (size_t)(N - d->mti);
+        if( count > n )
+            count = n;
 #ifdef __SSE2__
-        // Do the tempering ahead of time in vector code
-        for( kk = 0; kk + 4 <= N; kk += 4 )
+        memcpy( out, d->cache + d->mti, count * sizeof( cl_uint ) );
+#else
+        size_t i;
+        for( i = 0; i < count; i++ )
         {
-            __m128i vy = _mm_load_si128( (__m128i*)(mt + kk ) );                            // y = mt[k];
-            vy = _mm_xor_si128( vy, _mm_srli_epi32( vy, 11 ) );                             // y ^= (y >> 11);
-            vy = _mm_xor_si128( vy, _mm_and_si128( _mm_slli_epi32( vy, 7 ), c0.v) );        // y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
-            vy = _mm_xor_si128( vy, _mm_and_si128( _mm_slli_epi32( vy, 15 ), c1.v) );       // y ^= (y << 15) & (cl_uint) 0xefc60000UL;
-            vy = _mm_xor_si128( vy, _mm_srli_epi32( vy, 18 ) );                             // y ^= (y >> 18);
-            _mm_store_si128( (__m128i*)(d->cache+kk), vy );
+            cl_uint y = d->mt[d->mti + i];
+
+            /* Tempering */
+            y ^= (y >> 11);
+            y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
+            y ^= (y << 15) & (cl_uint) 0xefc60000UL;
+            y ^= (y >> 18);
+            out[i] = y;
         }
 #endif
-
-        d->mti = 0;
+        d->mti += (cl_int) count;
+        out += count;
+        n -= count;
     }
+}
+
+/* generates a random number on [0,0xffffffff]-interval */
+cl_uint genrand_int32( MTdata d)
+{
+    cl_uint y;
+
+    if (d->mti == N)
+        mt_generate( d );
+
 #ifdef __SSE2__
     y = d->cache[d->mti++];
 #else
-    y = mt[d->mti++];
+    y = d->mt[d->mti++];
 
     /* Tempering */
     y ^= (y >> 11);
@@ -278,3 +391,291 @@ double genrand_res53(MTdata d)
     unsigned long a=genrand_int32(d)>>5, b=genrand_int32(d)>>6;
     return(a*67108864.0+b)*(1.0/9007199254740992.0);
 }
+
+/*
+   Jump ahead
+
+   Advancing the generator by J outputs is multiplying its state by A**J, where A is the
+   linear map over GF(2) that steps the generator by one word. A**J = h(A) for the polynomial
+   h(x) = x**J mod phi(x), where phi is the characteristic polynomial of A. h has degree less
+   than 19937, so h(A) can be applied with 19937 steps of the generator. The polynomial only
+   depends on J, so it is computed once in init_genrand_jump and then applied to any number of
+   generators with genrand_jump.
+*/
+
+#define MT_DEGREE       19937
+#define MT_POLY_WORDS   ((2 * MT_DEGREE + 63) / 64 + 1)
+
+typedef struct _MTjump
+{
+    cl_ulong poly[MT_POLY_WORDS];   /* x**(J-1) mod phi(x), see genrand_jump */
+}_MTjump;
+
+static int mt_poly_bit( const cl_ulong *p, size_t i )
+{
+    return (int)(p[i / 64] >> (i % 64)) & 1;
+}
+
+/* The 64 bits of p starting at bit i */
+static cl_ulong mt_poly_bits( const cl_ulong *p, size_t i )
+{
+    size_t w = i / 64, s = i % 64;
+    if( 0 == s )
+        return p[w];
+    return (p[w] >> s) | (p[w + 1] << (64 - s));
+}
+
+/* dst ^= src * x**shift, for src of srcWords words */
+static void mt_poly_xor_shifted( cl_ulong *dst, const cl_ulong *src, size_t srcWords, size_t shift )
+{
+    size_t w = shift / 64, s = shift % 64, i;
+    if( 0 == s )
+    {
+        for( i = 0; i < srcWords; i++ )
+            dst[i + w] ^= src[i];
+        return;
+    }
+    for( i = 0; i < srcWords; i++ )
+    {
+        dst[i + w] ^= src[i] << s;
+        dst[i + w + 1] ^= src[i] >> (64 - s);
+    }
+}
+
+static int mt_parity( cl_ulong x )
+{
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return (int)(x & 1);
+}
+
+/*
+   Finds phi with Berlekamp-Massey on 2*19937 bits of output. phi is irreducible, so any
+   nonzero output bit has phi as its minimal polynomial. Returns 0 on success.
+*/
+static int mt_char_poly( cl_ulong *phi )
+{
+    enum { T = 2 * MT_DEGREE, WORDS = MT_POLY_WORDS + 4 };
+    cl_ulong *r = (cl_ulong*) calloc( 4 * WORDS, sizeof( cl_ulong ) );
+    cl_ulong *c, *b, *t;
+    MTdata d = init_genrand( 5489 );
+    size_t n, i, words, L = 0, m = 1;
+    int result = -1;
+
+    if( NULL == r || NULL == d )
+        goto exit;
+    c = r + WORDS;
+    b = c + WORDS;
+    t = b + WORDS;
+
+    /* The sequence in reverse, so s[n-i] for i = 0...L is the bit string r starting at T-1-n */
+    for( n = 0; n < T; n++ )
+        if( genrand_int32( d ) & 1 )
+            r[(T - 1 - n) / 64] |= (cl_ulong) 1 << ((T - 1 - n) % 64);
+
+    c[0] = b[0] = 1;
+    for( n = 0; n < T; n++ )
+    {
+        /* discrepancy = s[n] + sum c[i] s[n-i]. c has no bits above L. */
+        cl_ulong sum = 0;
+        for( i = 0; i <= L / 64; i++ )
+            sum ^= c[i] & mt_poly_bits( r, T - 1 - n + 64 * i );
+        if( 0 == mt_parity( sum ) )
+        {
+            m++;
+            continue;
+        }
+
+        /* b has no bits above L, and b * x**m has none above T */
+        words = L / 64 + 1;
+        if( words > WORDS - 2 - m / 64 )
+            words = WORDS - 2 - m / 64;
+        if( 2 * L <= n )
+        {
+            memcpy( t, c, WORDS * sizeof( cl_ulong ) );
+            mt_poly_xor_shifted( c, b, words, m );
+            L = n + 1 - L;
+            memcpy( b, t, WORDS * sizeof( cl_ulong ) );
+            m = 1;
+        }
+        else
+        {
+            mt_poly_xor_shifted( c, b, words, m );
+            m++;
+        }
+    }
+
+    if( MT_DEGREE != L )
+        goto exit;
+
+    /* phi(x) = x**L c(1/x) */
+    memset( phi, 0, MT_POLY_WORDS * sizeof( cl_ulong ) );
+    for( i = 0; i <= L; i++ )
+        if( mt_poly_bit( c, i ) )
+            phi[(L - i) / 64] |= (cl_ulong) 1 << ((L - i) % 64);
+    result = 0;
+
+exit:
+    free_mtdata( d );
+    free( r );
+    return result;
+}
+
+/* Spreads the low 32 bits of x to the even bits, which squares it as a polynomial over GF(2) */
+static cl_ulong mt_spread( cl_ulong x )
+{
+    x &= 0xffffffffULL;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+MTjump init_genrand_jump( cl_uint log2Steps )
+{
+    enum { WORDS = MT_POLY_WORDS + 2 };
+    MTjump j = (MTjump) calloc( 1, sizeof( _MTjump ) );
+    cl_ulong *phi = (cl_ulong*) calloc( 3 * WORDS, sizeof( cl_ulong ) );
+    cl_ulong *p, *sq;
+    cl_uint k;
+    size_t i;
+
+    if( NULL == j || NULL == phi || mt_char_poly( phi ) )
+    {
+        free( j );
+        free( phi );
+        return NULL;
+    }
+    p = phi + WORDS;
+    sq = p + WORDS;
+
+    /* p = x**(2**log2Steps) mod phi, by repeated squaring */
+    p[0] = 2;
+    for( k = 0; k < log2Steps; k++ )
+    {
+        for( i = 0; i < MT_POLY_WORDS / 2; i++ )
+        {
+            sq[2 * i] = mt_spread( p[i] );
+            sq[2 * i + 1] = mt_spread( p[i] >> 32 );
+        }
+        for( i = 2 * MT_DEGREE - 2; i >= MT_DEGREE; i-- )
+            if( mt_poly_bit( sq, i ) )
+                mt_poly_xor_shifted( sq, phi, MT_DEGREE / 64 + 1, i - MT_DEGREE );
+        memcpy( p, sq, WORDS * sizeof( cl_ulong ) );
+    }
+
+    /*
+       genrand_jump steps the generator once before applying the polynomial, so divide by x.
+       phi(0) = 1, so adding phi first makes p divisible by x without changing it mod phi.
+    */
+    if( p[0] & 1 )
+        for( i = 0; i < WORDS; i++ )
+            p[i] ^= phi[i];
+    for( i = 0; i < MT_POLY_WORDS; i++ )
+        j->poly[i] = (p[i] >> 1) | (p[i + 1] << 63);
+
+    free( phi );
+    return j;
+}
+
+void free_genrand_jump( MTjump j )
+{
+    free( j );
+}
+
+/* Steps a circular window of the generator by one word */
+static int mt_step( cl_uint *w, int p )
+{
+    cl_uint y = (cl_uint) ((w[p]&UPPER_MASK)|(w[(p + 1) % N]&LOWER_MASK));
+    w[p] = w[(p + M) % N] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL];
+    return (p + 1) % N;
+}
+
+void genrand_jump( MTdata d, MTjump j )
+{
+    cl_uint w[N], acc[N];
+    int p = 0, i, k;
+
+    /*
+       w is the window of N words whose first word is the next output. A only has phi as its
+       characteristic polynomial on windows it can produce, so step once first, and then apply
+       x**(J-1) mod phi.
+    */
+    memcpy( w, d->mt, sizeof( w ) );
+    for( i = 0; i <= d->mti; i++ )
+        p = mt_step( w, p );
+
+    memset( acc, 0, sizeof( acc ) );
+    for( i = 0; i < MT_DEGREE; i++ )
+    {
+        if( mt_poly_bit( j->poly, i ) )
+        {
+            for( k = 0; k < N - p; k++ )
+                acc[k] ^= w[p + k];
+            for( ; k < N; k++ )
+                acc[k] ^= w[p + k - N];
+        }
+        p = mt_step( w, p );
+    }
+
+    memcpy( d->mt, acc, sizeof( acc ) );
+    d->mti = 0;
+#ifdef __SSE2__
+    for( i = 0; i < N; i++ )
+    {
+        cl_uint y = acc[i];
+        y ^= (y >> 11);
+        y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
+        y ^= (y << 15) & (cl_uint) 0xefc60000UL;
+        y ^= (y >> 18);
+        d->cache[i] = y;
+    }
+#endif
+}
+
+int init_genrand_streams( cl_uint seed, MTdata *streams, cl_uint count )
+{
+    MTjump j = NULL;
+    cl_uint i;
+
+    for( i = 0; i < count; i++ )
+        streams[i] = NULL;
+    if( 0 == count )
+        return 0;
+
+    streams[0] = init_genrand( seed );
+    if( NULL == streams[0] )
+        goto error;
+    if( count > 1 )
+    {
+        j = init_genrand_jump( GENRAND_STREAM_LOG2_SPACING );
+        if( NULL == j )
+            goto error;
+    }
+    for( i = 1; i < count; i++ )
+    {
+        streams[i] = (MTdata) align_malloc( sizeof( _MTdata ), 16 );
+        if( NULL == streams[i] )
+            goto error;
+        memcpy( streams[i], streams[i - 1], sizeof( _MTdata ) );
+        genrand_jump( streams[i], j );
+    }
+
+    free_genrand_jump( j );
+    return 0;
+
+error:
+    free_genrand_jump( j );
+    for( i = 0; i < count; i++ )
+    {
+        free_mtdata( streams[i] );
+        streams[i] = NULL;
+    }
+    return -1;
+}
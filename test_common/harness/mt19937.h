@@ -76,6 +76,9 @@ void   free_mtdata( MTdata /*data*/ );
 /* generates a random number on [0,0xffffffff]-interval */
 cl_uint genrand_int32( MTdata /*data*/);
 
+/* Writes the next n numbers to out. Same as n calls to genrand_int32, but much faster. */
+void genrand_int32_block( MTdata /*data*/, cl_uint * /*out*/, size_t /*n*/ );
+
 /* generates a random number on [0,0xffffffffffffffffULL]-interval */
 cl_ulong genrand_int64( MTdata /*data*/);
 
@@ -91,6 +94,28 @@ double genrand_real3( MTdata /*data*/);
 /* generates a random number on [0,1) with 53-bit resolution*/
 double genrand_res53( MTdata /*data*/ );
 
+/*
+   Jump ahead. init_genrand_jump precomputes what it takes to advance a generator by
+   2**log2Steps numbers. That takes a fraction of a second, so make it once and reuse it.
+   genrand_jump then advances data by that much in a few milliseconds.
+*/
+typedef struct _MTjump  *MTjump;
+
+MTjump init_genrand_jump( cl_uint /*log2Steps*/ );
+
+void   free_genrand_jump( MTjump /*jump*/ );
+
+void   genrand_jump( MTdata /*data*/, MTjump /*jump*/ );
+
+/*
+   Creates count generators for seed that are GENRAND_STREAM_LOG2_SPACING apart in its
+   sequence, so they never overlap. streams[0] is init_genrand( seed ). Free each stream with
+   free_mtdata. Returns 0 on success.
+*/
+#define GENRAND_STREAM_LOG2_SPACING     64
+
+int    init_genrand_streams( cl_uint /*seed*/, MTdata * /*streams*/, cl_uint /*count*/ );
+
 
 #ifdef __cplusplus
     }
@@ -30,6 +30,12 @@ using namespace std;
 CompilationMode      gCompilationMode = kOnline;
 CompilationCacheMode gCompilationCacheMode = kCacheModeCompileIfAbsent;
 std::string          gCompilationCachePath = ".";
+int                  gCompilationJobs = 0;
+unsigned int         gShardIndex = 0;
+unsigned int         gShardCount = 1;
+bool                 gShardSubDevices = false;
+unsigned int         gTestJobs = 1;
+bool                 gSharedContext = false;
 
 void helpInfo ()
 {
@@ -39,6 +45,10 @@ void helpInfo ()
              "                           online     Use online compilation (default)\n"
              "                           binary     Use binary offline compilation\n"
              "                           spir-v     Use SPIR-V offline compilation\n"
+             "        --jobs <n>                  Run up to n tests at once, each with its own context\n"
+             "                                    and queue. Output is printed in test order\n"
+             "        --shared-context            Run the tests that allow it in one context per device,\n"
+             "                                    and reuse the programs they build\n"
              "\n"
              "    For offline compilation (binary and spir-v modes) only:\n"
              "        --compilation-cache-mode <cache-mode>  Specify a compilation caching mode:\n"
@@ -47,6 +57,15 @@ void helpInfo ()
              "                                 force-read      Force reading from the cache\n"
              "                                 overwrite       Disable reading from the cache\n"
              "        --compilation-cache-path <path>   Path for offline compiler output and CL source\n"
+             "        --compilation-jobs <n>   Maximum number of offline compilers to run at once\n"
+             "                                 (default: one per CPU)\n"
+             "\n"
+             "    For the exhaustive tests (conversions and math_brute_force):\n"
+             "        --shard <i>/<n>          Only run part i of n of each input range. Run the\n"
+             "                                 other parts in other processes, on other devices\n"
+             "                                 or with run_sharded.py\n"
+             "        --shard-subdevices       Split the device into n equal sub-devices and run\n"
+             "                                 on sub-device i\n"
              "\n");
 }
 
@@ -159,6 +178,70 @@ int parseCustomParam (int argc, const char *argv[], const char *ignore)
             }
         }
 
+        else if (!strcmp(argv[i], "--compilation-jobs"))
+        {
+            delArg++;
+            if ((i + 1) < argc && atoi(argv[i + 1]) > 0)
+            {
+                delArg++;
+                gCompilationJobs = atoi(argv[i + 1]);
+            }
+            else
+            {
+                log_error("Compilation jobs parameters are incorrect. Usage:\n"
+                          "  --compilation-jobs <n>\n");
+                return -1;
+            }
+        }
+
+        else if (!strcmp(argv[i], "--jobs"))
+        {
+            delArg++;
+            if ((i + 1) < argc && atoi(argv[i + 1]) > 0)
+            {
+                delArg++;
+                gTestJobs = atoi(argv[i + 1]);
+            }
+            else
+            {
+                log_error("Jobs parameters are incorrect. Usage:\n"
+                          "  --jobs <n>\n");
+                return -1;
+            }
+        }
+
+        else if (!strcmp(argv[i], "--shared-context"))
+        {
+            delArg++;
+            gSharedContext = true;
+        }
+
+        else if (!strcmp(argv[i], "--shard"))
+        {
+            unsigned int index = 0, count = 0;
+            char extra = 0;
+
+            delArg++;
+            if ((i + 1) < argc && 2 == sscanf(argv[i + 1], "%u/%u%c", &index, &count, &extra) && index < count)
+            {
+                delArg++;
+                gShardIndex = index;
+                gShardCount = count;
+                log_info("Running shard %u of %u\n", gShardIndex, gShardCount);
+            }
+            else
+            {
+                log_error("Shard parameters are incorrect. Usage:\n"
+                          "  --shard <i>/<n>, with 0 <= i < n\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--shard-subdevices"))
+        {
+            delArg++;
+            gShardSubDevices = true;
+        }
+
         //cleaning parameters from argv tab
         for (int j = i; j < argc - delArg; j++)
             argv[j] = argv[j + delArg];
@@ -175,6 +258,16 @@ int parseCustomParam (int argc, const char *argv[], const char *ignore)
     return argc;
 }
 
+void get_shard_range(uint64_t count, uint64_t *begin, uint64_t *end)
+{
+    // The first count % gShardCount shards get one extra item
+    uint64_t size = count / gShardCount;
+    uint64_t extra = count % gShardCount;
+
+    *begin = size * gShardIndex + (gShardIndex < extra ? gShardIndex : extra);
+    *end = *begin + size + (gShardIndex < extra ? 1 : 0);
+}
+
 bool is_power_of_two(int number)
 {
     return number && !(number & (number - 1));
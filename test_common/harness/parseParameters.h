@@ -36,9 +36,18 @@ enum CompilationCacheMode
 extern CompilationMode gCompilationMode;
 extern CompilationCacheMode gCompilationCacheMode;
 extern std::string gCompilationCachePath;
+extern int gCompilationJobs;
+extern unsigned int gShardIndex;
+extern unsigned int gShardCount;
+extern bool gShardSubDevices;
+extern unsigned int gTestJobs;
+extern bool gSharedContext;
 
 extern int parseCustomParam (int argc, const char *argv[], const char *ignore = 0 );
 
+// Splits count items into gShardCount contiguous parts, and returns the part this process runs
+extern void get_shard_range(uint64_t count, uint64_t *begin, uint64_t *end);
+
 extern void parseWimpyReductionFactor(const char *&arg, int &wimpyReductionFactor);
 
 #endif // _parseParameters_h
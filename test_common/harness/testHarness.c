@@ -21,6 +21,11 @@
 #include <cassert>
 #include <stdexcept>
 #include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "threadTesting.h"
 #include "errorHelpers.h"
 #include "kernelHelpers.h"
@@ -30,6 +35,9 @@
 
 #if !defined(_WIN32)
 #include <unistd.h>
+#include <sys/resource.h>
+#else
+#include <windows.h>
 #endif
 
 #include <time.h>
@@ -40,6 +48,19 @@
 
 int gTestsPassed = 0;
 int gTestsFailed = 0;
+static std::mutex gTestCountLock;
+
+// Metrics of each test in the list being run, and of the test running on this thread
+static test_metrics *gTestMetrics = NULL;
+#if defined( _MSC_VER )
+static __declspec( thread ) test_metrics *gCurrentMetrics = NULL;
+#else
+static __thread test_metrics *gCurrentMetrics = NULL;
+#endif
+// Metrics of all tests running right now, so that work done on threads the tests start themselves
+// (e.g. ThreadPool workers) can be counted when only one test is running
+static std::mutex gRunningMetricsLock;
+static std::vector<test_metrics *> gRunningMetrics;
 cl_uint gRandomSeed = 0;
 cl_uint gReSeed = 0;
 
@@ -52,6 +73,57 @@ int     gHasLong = 1;
 
 #define DEFAULT_NUM_ELEMENTS        0x4000
 
+// Splits device into gShardCount equal sub-devices and returns a new reference to the one for this shard
+static int get_shard_sub_device( cl_device_id device, cl_device_id *subDevice )
+{
+    cl_uint computeUnits = 0, count = 0, i;
+    cl_device_id *subDevices;
+    int err;
+
+    if( (err = clGetDeviceInfo( device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof( computeUnits ), &computeUnits, NULL )) )
+    {
+        print_error( err, "Unable to get CL_DEVICE_MAX_COMPUTE_UNITS" );
+        return err;
+    }
+
+    if( computeUnits < gShardCount )
+    {
+        log_error( "Unable to split %u compute units into %u sub-devices\n", computeUnits, gShardCount );
+        return CL_INVALID_VALUE;
+    }
+
+    cl_device_partition_property props[] = { CL_DEVICE_PARTITION_EQUALLY, (cl_device_partition_property) (computeUnits / gShardCount), 0 };
+    if( (err = clCreateSubDevices( device, props, 0, NULL, &count )) )
+    {
+        print_error( err, "clCreateSubDevices failed to count sub-devices" );
+        return err;
+    }
+
+    subDevices = (cl_device_id*) malloc( count * sizeof( *subDevices ) );
+    if( NULL == subDevices )
+    {
+        log_error( "Unable to allocate storage for %u sub-devices\n", count );
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+
+    if( (err = clCreateSubDevices( device, props, count, subDevices, NULL )) )
+    {
+        print_error( err, "clCreateSubDevices failed" );
+        free( subDevices );
+        return err;
+    }
+
+    // Keep ours, and release the rest
+    *subDevice = subDevices[ gShardIndex % count ];
+    for( i = 0; i < count; i++ )
+        if( i != gShardIndex % count )
+            clReleaseDevice( subDevices[i] );
+    free( subDevices );
+
+    log_info( "Running on sub-device %u of %u, with %u compute units\n", gShardIndex % count, count, computeUnits / gShardCount );
+    return CL_SUCCESS;
+}
+
 int runTestHarness( int argc, const char *argv[], int testNum, test_definition testList[],
                     int imageSupportRequired, int forceNoContextCreation, cl_command_queue_properties queueProps )
 {
@@ -327,6 +399,17 @@ int runTestHarnessWithCheck( int argc, const char *argv[], int testNum, test_def
 
     device = devices[choosen_device_index];
 
+    cl_device_id shardDevice = NULL;
+    if( gShardSubDevices && gShardCount > 1 )
+    {
+        if( get_shard_sub_device( device, &shardDevice ) )
+        {
+            test_finish();
+            return EXIT_FAILURE;
+        }
+        device = shardDevice;
+    }
+
     if( printDeviceHeader( device ) != CL_SUCCESS )
     {
         test_finish();
@@ -484,6 +567,9 @@ int runTestHarnessWithCheck( int argc, const char *argv[], int testNum, test_def
     RestoreFPState( &oldMode );
 #endif
 
+    if( shardDevice )
+        clReleaseDevice( shardDevice );
+
     return (error == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -530,7 +616,8 @@ static int find_matching_tests( test_definition testList[], unsigned char select
 }
 
 static int saveResultsToJson( const char *fileName, const char *suiteName, test_definition testList[],
-                              unsigned char selectedTestList[], test_status resultTestList[], int testNum )
+                              unsigned char selectedTestList[], test_status resultTestList[],
+                              test_metrics metricsList[], int testNum )
 {
     FILE *file = fopen( fileName, "w" );
     if( NULL == file )
@@ -557,7 +644,24 @@ static int saveResultsToJson( const char *fileName, const char *suiteName, test_
         }
     }
     fprintf( file, "\n");
+    fprintf( file, "\t},\n" );
 
+    fprintf( file, "\t\"metrics\": {\n" );
+    add_linebreak = 0;
+    for( int i = 0; i < testNum; ++i )
+    {
+        if( selectedTestList[i] )
+        {
+            const test_metrics &m = metricsList[i];
+            fprintf( file, "%s\t\t\"%s\": { \"wall_seconds\": %.6f, \"cpu_seconds\": %.6f, ",
+                     linebreak[add_linebreak], testList[i].name, m.wall_seconds, m.cpu_seconds );
+            if( m.peak_rss_kb != 0 )
+                fprintf( file, "\"peak_rss_kb\": %lu, ", (unsigned long) m.peak_rss_kb );
+            fprintf( file, "\"programs_built\": %u, \"build_seconds\": %.6f }", m.programs_built, m.build_seconds );
+            add_linebreak = 1;
+        }
+    }
+    fprintf( file, "\n");
     fprintf( file, "\t}\n" );
     fprintf( file, "}\n" );
 
@@ -613,9 +717,11 @@ int parseAndCallCommandLineTests( int argc, const char *argv[], cl_device_id dev
     if( ret == EXIT_SUCCESS )
     {
         resultTestList = ( test_status* ) calloc( testNum, sizeof(*resultTestList) );
+        gTestMetrics = ( test_metrics* ) calloc( testNum, sizeof(*gTestMetrics) );
 
         callTestFunctions( testList, selectedTestList, resultTestList, testNum, device,
                            forceNoContextCreation, num_elements, queueProps );
+        release_shared_contexts();
 
         if( gTestsFailed == 0 )
         {
@@ -643,7 +749,8 @@ int parseAndCallCommandLineTests( int argc, const char *argv[], cl_device_id dev
         char *filename = getenv( "CL_CONFORMANCE_RESULTS_FILENAME" );
         if( filename != NULL )
         {
-            ret = saveResultsToJson( filename, argv[0], testList, selectedTestList, resultTestList, testNum );
+            ret = saveResultsToJson( filename, argv[0], testList, selectedTestList, resultTestList, gTestMetrics,
+                                     testNum );
         }
     }
 
@@ -651,21 +758,226 @@ int parseAndCallCommandLineTests( int argc, const char *argv[], cl_device_id dev
 
     free( selectedTestList );
     free( resultTestList );
+    free( gTestMetrics );
+    gTestMetrics = NULL;
 
     return ret;
 }
 
+void test_metrics_add_build( double seconds )
+{
+    std::lock_guard<std::mutex> lock( gRunningMetricsLock );
+    test_metrics *metrics = gCurrentMetrics;
+
+    if( metrics == NULL && gRunningMetrics.size() == 1 )
+        metrics = gRunningMetrics[0];
+
+    if( metrics != NULL )
+    {
+        metrics->programs_built++;
+        metrics->build_seconds += seconds;
+    }
+}
+
+// User plus system time of the whole process
+static double get_process_cpu_seconds( void )
+{
+#if defined( _WIN32 )
+    FILETIME creation, exit, kernel, user;
+    if( !GetProcessTimes( GetCurrentProcess(), &creation, &exit, &kernel, &user ) )
+        return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return ( k.QuadPart + u.QuadPart ) * 1e-7;
+#else
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) )
+        return 0.0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) * 1e-6;
+#endif
+}
+
+// Resets the high water mark of the process' resident set, so that get_peak_rss_kb only covers
+// what runs from here on. Only Linux can do that (since 4.0).
+static bool reset_peak_rss( void )
+{
+#if defined( __linux__ )
+    FILE *file = fopen( "/proc/self/clear_refs", "w" );
+    if( file == NULL )
+        return false;
+    bool written = fputs( "5", file ) >= 0;
+    return fclose( file ) == 0 && written;
+#else
+    return false;
+#endif
+}
+
+// High water mark of the process' resident set since reset_peak_rss, or 0 if it isn't known
+static size_t get_peak_rss_kb( void )
+{
+    size_t peak = 0;
+#if defined( __linux__ )
+    FILE *file = fopen( "/proc/self/status", "r" );
+    if( file == NULL )
+        return 0;
+    char line[ 256 ];
+    unsigned long kb;
+    while( fgets( line, sizeof( line ), file ) != NULL )
+    {
+        if( sscanf( line, "VmHWM: %lu kB", &kb ) == 1 )
+        {
+            peak = kb;
+            break;
+        }
+    }
+    fclose( file );
+#endif
+    return peak;
+}
+
+// callSingleTestFunction for testList[i], recording what it cost in gTestMetrics[i]
+static test_status callAndMeasureTestFunction( test_definition testList[], int i, cl_device_id deviceToUse,
+                                               int forceNoContextCreation, int numElementsToUse,
+                                               cl_command_queue_properties queueProps )
+{
+    test_metrics unused;
+    test_metrics *metrics = gTestMetrics != NULL ? &gTestMetrics[i] : &unused;
+
+    memset( metrics, 0, sizeof( *metrics ) );
+    gCurrentMetrics = metrics;
+    {
+        std::lock_guard<std::mutex> lock( gRunningMetricsLock );
+        gRunningMetrics.push_back( metrics );
+    }
+    bool measurePeakRSS = reset_peak_rss();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double cpuStart = get_process_cpu_seconds();
+
+    test_status status = callSingleTestFunction( testList[i], deviceToUse, forceNoContextCreation,
+                                                 numElementsToUse, queueProps );
+
+    metrics->wall_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    metrics->cpu_seconds = get_process_cpu_seconds() - cpuStart;
+    if( measurePeakRSS )
+        metrics->peak_rss_kb = get_peak_rss_kb();
+    gCurrentMetrics = NULL;
+    {
+        std::lock_guard<std::mutex> lock( gRunningMetricsLock );
+        for( size_t k = 0; k < gRunningMetrics.size(); k++ )
+        {
+            if( gRunningMetrics[k] == metrics )
+            {
+                gRunningMetrics.erase( gRunningMetrics.begin() + k );
+                break;
+            }
+        }
+    }
+
+    return status;
+}
+
+// Runs the given tests on up to gTestJobs threads. Each test's log output is captured and printed
+// in test order as soon as it and all tests before it are done.
+static void callTestFunctionsInParallel( test_definition testList[], const std::vector<int> &tests,
+                                         test_status resultTestList[], cl_device_id deviceToUse,
+                                         int numElementsToUse, cl_command_queue_properties queueProps )
+{
+    std::vector<std::string> logs( tests.size() );
+    std::vector<bool> done( tests.size(), false );
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable finished;
+    size_t next = 0;
+
+    auto worker = [&]()
+    {
+        for( ;; )
+        {
+            size_t k;
+            {
+                std::lock_guard<std::mutex> guard( lock );
+                if( next == tests.size() )
+                    return;
+                k = next++;
+            }
+
+            log_set_capture( &logs[k] );
+            test_status status = callAndMeasureTestFunction( testList, tests[k], deviceToUse, 0,
+                                                             numElementsToUse, queueProps );
+            log_set_capture( NULL );
+
+            {
+                std::lock_guard<std::mutex> guard( lock );
+                resultTestList[tests[k]] = status;
+                done[k] = true;
+            }
+            finished.notify_all();
+        }
+    };
+
+    size_t threadCount = gTestJobs < tests.size() ? gTestJobs : tests.size();
+    for( size_t t = 0; t < threadCount; t++ )
+        threads.push_back( std::thread( worker ) );
+
+    for( size_t k = 0; k < tests.size(); k++ )
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        finished.wait( guard, [&]() { return done[k]; } );
+        guard.unlock();
+
+        fputs( logs[k].c_str(), stdout );
+        fflush( stdout );
+        std::string().swap( logs[k] );
+    }
+
+    for( size_t t = 0; t < threads.size(); t++ )
+        threads[t].join();
+}
+
 void callTestFunctions( test_definition testList[], unsigned char selectedTestList[], test_status resultTestList[],
                         int testNum, cl_device_id deviceToUse, int forceNoContextCreation, int numElementsToUse,
                         cl_command_queue_properties queueProps )
 {
-    for( int i = 0; i < testNum; ++i )
+    // Suites that share one context between their tests can't run them concurrently
+    if( gTestJobs > 1 && forceNoContextCreation )
+        log_info( "This test suite doesn't create a context per test, ignoring --jobs\n" );
+
+    if( gTestJobs <= 1 || forceNoContextCreation )
     {
-        if( selectedTestList[i] )
+        for( int i = 0; i < testNum; ++i )
+        {
+            if( selectedTestList[i] )
+            {
+                resultTestList[i] = callAndMeasureTestFunction( testList, i, deviceToUse, forceNoContextCreation,
+                                                                numElementsToUse, queueProps );
+            }
+        }
+        return;
+    }
+
+    // Run each run of consecutive thread safe tests in parallel, and serial tests on their own
+    // in between, so the output stays in test order
+    std::vector<int> batch;
+    for( int i = 0; i <= testNum; ++i )
+    {
+        if( i < testNum && !selectedTestList[i] )
+            continue;
+
+        if( i == testNum || testList[i].serial )
         {
-            resultTestList[i] = callSingleTestFunction( testList[i], deviceToUse, forceNoContextCreation,
-                                                        numElementsToUse, queueProps );
+            callTestFunctionsInParallel( testList, batch, resultTestList, deviceToUse, numElementsToUse,
+                                         queueProps );
+            batch.clear();
+
+            if( i < testNum )
+                resultTestList[i] = callAndMeasureTestFunction( testList, i, deviceToUse, forceNoContextCreation,
+                                                                numElementsToUse, queueProps );
         }
+        else
+            batch.push_back( i );
     }
 }
 
@@ -688,7 +1000,14 @@ test_status callSingleTestFunction( test_definition test, cl_device_id deviceToU
     /* Create a context to work with, unless we're told not to */
     if( !forceNoContextCreation )
     {
-        context = clCreateContext(NULL, 1, &deviceToUse, notify_callback, NULL, &error );
+        if( gSharedContext && test.shared_context )
+        {
+            error = get_shared_context( deviceToUse, &context );
+            if( error != CL_SUCCESS )
+                context = NULL;
+        }
+        else
+            context = clCreateContext(NULL, 1, &deviceToUse, notify_callback, NULL, &error );
         if (!context)
         {
             print_error( error, "Unable to create testing context" );
@@ -738,12 +1057,14 @@ test_status callSingleTestFunction( test_definition test, cl_device_id deviceToU
             /* Print result */
             if( ret == 0 ) {
                 log_info( "%s passed\n", test.name );
+                std::lock_guard<std::mutex> guard( gTestCountLock );
                 gTestsPassed++;
                 status = TEST_PASS;
             }
             else
             {
                 log_error( "%s FAILED\n", test.name );
+                std::lock_guard<std::mutex> guard( gTestCountLock );
                 gTestsFailed++;
                 status = TEST_FAIL;
             }
@@ -30,6 +30,10 @@ extern "C" {
 #define ADD_TEST(fn) {test_##fn, #fn, Version(1, 0)}
 #define ADD_TEST_VERSION(fn, ver) {test_##fn, #fn, ver}
 #define NOT_IMPLEMENTED_TEST(fn) {NULL, #fn, Version(0, 0)}
+// For tests that must not run alongside other tests with --jobs
+#define ADD_TEST_SERIAL(fn) {test_##fn, #fn, Version(1, 0), true}
+// For tests that can run in a context used by other tests before them with --shared-context
+#define ADD_TEST_SHARED_CONTEXT(fn) {test_##fn, #fn, Version(1, 0), false, true}
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
@@ -59,6 +63,12 @@ typedef struct test_definition
     basefn func;
     const char* name;
     Version min_version;
+    // Set for tests that aren't thread safe (shared globals, whole-device
+    // allocations, timing); --jobs runs them on their own
+    bool serial;
+    // Set for tests that don't depend on getting a fresh context (leftover programs, kernels
+    // and memory from earlier tests); --shared-context runs them in a context kept per device
+    bool shared_context;
 } test_definition;
 
 
@@ -72,6 +82,24 @@ typedef enum test_status
 extern cl_uint gReSeed;
 extern cl_uint gRandomSeed;
 
+// What one test cost, saved next to the results in CL_CONFORMANCE_RESULTS_FILENAME.
+// cpu_seconds and peak_rss_kb are for the whole process, so they include the driver's threads
+// (and, with --jobs, the other tests running at the same time). peak_rss_kb is the high water
+// mark since the test started; it is only measured on Linux and is 0 (and left out of the file)
+// elsewhere. Builds on threads the test starts itself are only counted while no other test runs.
+typedef struct test_metrics
+{
+    double wall_seconds;
+    double cpu_seconds;
+    size_t peak_rss_kb;
+    unsigned int programs_built;
+    double build_seconds;
+} test_metrics;
+
+// Counts a clBuildProgram that took the given time towards the test running on this thread, or
+// towards the only test running if this thread isn't running one
+extern void test_metrics_add_build( double seconds );
+
 // Supply a list of functions to test here. This will allocate a CL device, create a context, all that
 // setup work, and then call each function in turn as dictatated by the passed arguments.
 // Returns EXIT_SUCCESS iff all tests succeeded or the tests were listed,
@@ -107,6 +135,9 @@ extern void callTestFunctions( test_definition testList[], unsigned char selecte
                                int testNum, cl_device_id deviceToUse, int forceNoContextCreation, int numElementsToUse,
                                cl_command_queue_properties queueProps );
 
+// Prints notifications from the contexts created by the harness
+extern void CL_CALLBACK notify_callback( const char *errinfo, const void *private_info, size_t cb, void *user_data );
+
 // This function is called by callTestFunctions, once per function, to do setup, call, logging and cleanup
 extern test_status callSingleTestFunction( test_definition test, cl_device_id deviceToUse, int forceNoContextCreation,
                                            int numElementsToUse, cl_command_queue_properties queueProps );
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Throughput benchmark for ThreadPool_Do. Reports jobs/sec for a range of thread counts,
+// with the worker threads unpinned and then pinned by SetThreadAffinity().
+// Also checks that asynchronous and nested submissions run every job exactly once.
+//
+//   test_threadpool                sweeps 1, 2, 4, ... up to the default thread count
+//   test_threadpool <threads>      measures a single thread count
+//   test_threadpool <threads> pin  measures a single thread count with pinned threads
+//
+// The thread count can only be set once per process, so the sweep re-runs this binary.
+#include "ThreadPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+static double GetSeconds( void )
+{
+#if defined( _WIN32 )
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &now );
+    return (double) now.QuadPart / (double) freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+typedef struct JobInfo
+{
+    cl_uint         work;           // LCG steps per job, to simulate a little bit of work
+    volatile cl_int done;
+}JobInfo;
+
+static cl_int BenchJob( cl_uint job_id, cl_uint thread_id, void *p )
+{
+    JobInfo *info = (JobInfo*) p;
+    cl_uint x = job_id;
+    cl_uint i;
+
+    for( i = 0; i < info->work; i++ )
+        x = x * 1664525U + 1013904223U;
+
+    // Don't let the compiler throw the loop away
+    if( x == 0xdeadbeefU )
+        info->done = 1;
+
+    ThreadPool_AtomicAdd( &info->done, 1 );
+    return CL_SUCCESS;
+}
+
+#define NESTED_OUTER_JOBS   64
+#define NESTED_INNER_JOBS   1000
+
+static cl_int NestedOuterJob( cl_uint job_id, cl_uint thread_id, void *p )
+{
+    JobInfo *info = (JobInfo*) p;
+    JobInfo inner = { info->work, 0 };
+    TPTaskHandle task;
+    cl_int err;
+
+    // Mix both flavours of nested submission
+    if( job_id & 1 )
+        err = ThreadPool_Do( BenchJob, NESTED_INNER_JOBS, &inner );
+    else if( CL_SUCCESS == (err = ThreadPool_Submit( BenchJob, NESTED_INNER_JOBS, &inner, &task )) )
+        err = ThreadPool_Wait( task );
+
+    if( CL_SUCCESS == err && inner.done != NESTED_INNER_JOBS )
+    {
+        printf( "ERROR: nested task ran %d of %d jobs\n", inner.done, NESTED_INNER_JOBS );
+        err = -1;
+    }
+
+    ThreadPool_AtomicAdd( &info->done, 1 );
+    return err;
+}
+
+static int CheckSubmit( void )
+{
+    JobInfo a = { 16, 0 };
+    JobInfo b = { 0, 0 };
+    JobInfo nested = { 16, 0 };
+    TPTaskHandle ta, tb;
+    cl_int err;
+
+    if( (err = ThreadPool_Submit( BenchJob, 100000, &a, &ta )) )
+        return err;
+    if( (err = ThreadPool_Submit( BenchJob, 3, &b, &tb )) )
+        return err;
+    if( (err = ThreadPool_Wait( tb )) || (err = ThreadPool_Wait( ta )) )
+        return err;
+    if( a.done != 100000 || b.done != 3 )
+    {
+        printf( "ERROR: concurrent tasks ran %d of 100000 and %d of 3 jobs\n", a.done, b.done );
+        return -1;
+    }
+
+    if( (err = ThreadPool_Do( NestedOuterJob, NESTED_OUTER_JOBS, &nested )) )
+        return err;
+    if( nested.done != NESTED_OUTER_JOBS )
+    {
+        printf( "ERROR: outer task ran %d of %d jobs\n", nested.done, NESTED_OUTER_JOBS );
+        return -1;
+    }
+
+    return CL_SUCCESS;
+}
+
+static int RunBenchmark( int threads, int pin )
+{
+    static const cl_uint jobCounts[] = { 64, 4096, 262144 };
+    static const cl_uint work[] = { 0, 1024 };
+    size_t i, j;
+    int errors = 0;
+
+    SetThreadCount( threads );
+    SetThreadAffinity( pin );
+    threads = (int) GetThreadCount();
+
+    if( CheckSubmit() )
+    {
+        printf( "ERROR: ThreadPool_Submit check failed with %d threads\n", threads );
+        return -1;
+    }
+
+    for( j = 0; j < sizeof( work ) / sizeof( work[0] ); j++ )
+        for( i = 0; i < sizeof( jobCounts ) / sizeof( jobCounts[0] ); i++ )
+        {
+            JobInfo info = { work[j], 0 };
+            cl_uint reps = 0;
+            double start = GetSeconds();
+            double elapsed;
+
+            // Repeat for at least a quarter second
+            do
+            {
+                cl_int err = ThreadPool_Do( BenchJob, jobCounts[i], &info );
+                if( err )
+                {
+                    printf( "ERROR: ThreadPool_Do returned %d\n", err );
+                    return -1;
+                }
+                reps++;
+                elapsed = GetSeconds() - start;
+            }while( elapsed < 0.25 );
+
+            if( (cl_uint) info.done != reps * jobCounts[i] )
+            {
+                printf( "ERROR: %d of %u jobs were run\n", info.done, reps * jobCounts[i] );
+                errors++;
+            }
+
+            printf( "threads: %4d %s  work: %5u  jobs/call: %7u  %12.0f jobs/sec\n",
+                    threads, pin ? "pinned  " : "unpinned", work[j], jobCounts[i], (double) reps * jobCounts[i] / elapsed );
+        }
+
+    return errors;
+}
+
+int main( int argc, const char *argv[] )
+{
+    int errors = 0;
+    int threads, pin;
+
+    if( argc > 1 )
+        return RunBenchmark( atoi( argv[1] ), argc > 2 && 0 == strcmp( argv[2], "pin" ) );
+
+    // The parent only learns the default thread count. Each measurement runs in a child.
+    int maxThreads = (int) GetThreadCount();
+    for( threads = 1; ; threads *= 2 )
+    {
+        char command[1024];
+
+        if( threads > maxThreads )
+            threads = maxThreads;
+
+        for( pin = 0; pin < 2; pin++ )
+        {
+            snprintf( command, sizeof( command ), "\"%s\" %d%s", argv[0], threads, pin ? " pin" : "" );
+            fflush( stdout );
+            if( system( command ) )
+                errors++;
+        }
+
+        if( threads == maxThreads )
+            break;
+    }
+
+    if( errors )
+        printf( "ThreadPool benchmark failed.\n" );
+    else
+        printf( "ThreadPool benchmark passed.\n" );
+
+    return errors;
+}
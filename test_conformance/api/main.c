@@ -64,23 +64,23 @@ test_definition test_list[] = {
     ADD_TEST( min_max_work_group_size ),
     ADD_TEST( min_max_read_image_args ),
     ADD_TEST( min_max_write_image_args ),
-    ADD_TEST( min_max_mem_alloc_size ),
-    ADD_TEST( min_max_image_2d_width ),
-    ADD_TEST( min_max_image_2d_height ),
-    ADD_TEST( min_max_image_3d_width ),
-    ADD_TEST( min_max_image_3d_height ),
-    ADD_TEST( min_max_image_3d_depth ),
-    ADD_TEST( min_max_image_array_size ),
-    ADD_TEST( min_max_image_buffer_size ),
+    ADD_TEST_SERIAL( min_max_mem_alloc_size ),
+    ADD_TEST_SERIAL( min_max_image_2d_width ),
+    ADD_TEST_SERIAL( min_max_image_2d_height ),
+    ADD_TEST_SERIAL( min_max_image_3d_width ),
+    ADD_TEST_SERIAL( min_max_image_3d_height ),
+    ADD_TEST_SERIAL( min_max_image_3d_depth ),
+    ADD_TEST_SERIAL( min_max_image_array_size ),
+    ADD_TEST_SERIAL( min_max_image_buffer_size ),
     ADD_TEST( min_max_parameter_size ),
     ADD_TEST( min_max_samplers ),
-    ADD_TEST( min_max_constant_buffer_size ),
+    ADD_TEST_SERIAL( min_max_constant_buffer_size ),
     ADD_TEST( min_max_constant_args ),
     ADD_TEST( min_max_compute_units ),
     ADD_TEST( min_max_address_bits ),
     ADD_TEST( min_max_single_fp_config ),
     ADD_TEST( min_max_double_fp_config ),
-    ADD_TEST( min_max_local_mem_size ),
+    ADD_TEST_SERIAL( min_max_local_mem_size ),
     ADD_TEST( min_max_kernel_preferred_work_group_size_multiple ),
     ADD_TEST( min_max_execution_capabilities ),
     ADD_TEST( min_max_queue_properties ),
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of each crc32 implementation the host can run, and checks that they
+// all agree.
+//
+//   test_bench_crc32 [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#include "../../../test_common/harness/crc32.h"
+
+static double now( void )
+{
+#if defined( _WIN32 )
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter( &count );
+    QueryPerformanceFrequency( &frequency );
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+int main( int argc, const char *argv[] )
+{
+    static const size_t sizes[] = { 64, 4096, 1 << 20, 64 << 20 };
+    const size_t maxSize = sizes[ sizeof( sizes ) / sizeof( sizes[0] ) - 1 ];
+    const crc32_impl *impls = crc32_implementations();
+    double seconds = argc > 1 ? atof( argv[1] ) : 0.5;
+    unsigned char *buffer = (unsigned char *) malloc( maxSize );
+    int errors = 0;
+    size_t count, i, s;
+
+    if( NULL == buffer )
+    {
+        printf( "ERROR: Unable to allocate %u bytes\n", (unsigned) maxSize );
+        return -1;
+    }
+    srand( 1 );
+    for( i = 0; i < maxSize; i++ )
+        buffer[i] = (unsigned char) rand();
+
+    // The last implementation is the byte at a time reference
+    for( count = 0; impls[count].name; count++ )
+        ;
+
+    printf( "%-8s", "" );
+    for( s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ )
+        printf( " %10u B", (unsigned) sizes[s] );
+    printf( "\n" );
+
+    for( i = 0; impls[i].name; i++ )
+    {
+        printf( "%-8s", impls[i].name );
+        for( s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ )
+        {
+            size_t size = sizes[s];
+            uint32_t crc = 0;
+            double start, elapsed;
+            size_t bytes = 0;
+
+            if( impls[i].update( ~0U, buffer, size ) != impls[count - 1].update( ~0U, buffer, size ) )
+            {
+                printf( "\nERROR: %s gives the wrong CRC for %u bytes\n", impls[i].name, (unsigned) size );
+                errors++;
+            }
+
+            start = now();
+            do
+            {
+                crc = impls[i].update( crc, buffer, size );
+                bytes += size;
+                elapsed = now() - start;
+            } while( elapsed < seconds );
+
+            printf( " %8.2f GB/s", bytes / elapsed * 1e-9 );
+
+            // Keep the calls from being optimized away
+            if( crc == 0x12345678 )
+                printf( "!" );
+        }
+        printf( "\n" );
+    }
+
+    free( buffer );
+    return errors;
+}
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of the host side image buffer helpers on a padded 3D image: random
+// data generation, copy_image_rows and compare_image_rows, next to the memcpy and memcmp row
+// loops they replace. Checks that the tiled copy and compare agree with the row loops.
+//
+//   test_bench_image_rows [width height depth]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#include "../../../test_common/harness/imageHelpers.h"
+#include "../../../test_common/harness/ThreadPool.h"
+
+bool gTestRounding = false;
+
+static double now( void )
+{
+#if defined( _WIN32 )
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter( &count );
+    QueryPerformanceFrequency( &frequency );
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+static void report( const char *name, size_t bytes, double seconds )
+{
+    printf( "%-28s %8.2f GB/s\n", name, bytes / seconds * 1e-9 );
+}
+
+int main( int argc, const char *argv[] )
+{
+    cl_image_format format = { CL_RGBA, CL_UNORM_INT8 };
+    image_descriptor imageInfo;
+    MTdata d = init_genrand( 1 );
+    int errors = 0;
+
+    memset( &imageInfo, 0, sizeof( imageInfo ) );
+    imageInfo.type = CL_MEM_OBJECT_IMAGE3D;
+    imageInfo.width = argc > 3 ? atoi( argv[1] ) : 1024;
+    imageInfo.height = argc > 3 ? atoi( argv[2] ) : 1024;
+    imageInfo.depth = argc > 3 ? atoi( argv[3] ) : 32;
+    imageInfo.format = &format;
+    imageInfo.num_mip_levels = 1;
+    // Padded like the image tests do, so rows aren't contiguous
+    imageInfo.rowPitch = imageInfo.width * get_pixel_size( &format ) + 64;
+    imageInfo.slicePitch = imageInfo.rowPitch * ( imageInfo.height + 1 );
+
+    size_t rowBytes = imageInfo.width * get_pixel_size( &format );
+    size_t rows = imageInfo.height, slices = imageInfo.depth;
+    size_t bytes = rowBytes * rows * slices;
+
+    printf( "%u x %u x %u RGBA8, %u threads\n", (unsigned) imageInfo.width, (unsigned) imageInfo.height,
+            (unsigned) imageInfo.depth, (unsigned) GetThreadCount() );
+
+    BufferOwningPtr<char> srcValues, dstValues;
+    double start = now();
+    char *src = generate_random_image_data( &imageInfo, srcValues, d );
+    report( "generate_random_image_data", (size_t) get_image_size( &imageInfo ), now() - start );
+    char *dst = generate_random_image_data( &imageInfo, dstValues, d );
+    if( NULL == src || NULL == dst )
+        return -1;
+
+    start = now();
+    for( size_t z = 0; z < slices; z++ )
+        for( size_t y = 0; y < rows; y++ )
+            memcpy( dst + z * imageInfo.slicePitch + y * imageInfo.rowPitch,
+                    src + z * imageInfo.slicePitch + y * imageInfo.rowPitch, rowBytes );
+    report( "memcpy per row", bytes, now() - start );
+
+    start = now();
+    copy_image_rows( dst, imageInfo.rowPitch, imageInfo.slicePitch, src, imageInfo.rowPitch, imageInfo.slicePitch,
+                     rowBytes, rows, slices );
+    report( "copy_image_rows", bytes, now() - start );
+
+    start = now();
+    size_t first = rows * slices;
+    for( size_t r = 0; r < rows * slices && first == rows * slices; r++ )
+        if( memcmp( dst + ( r / rows ) * imageInfo.slicePitch + ( r % rows ) * imageInfo.rowPitch,
+                    src + ( r / rows ) * imageInfo.slicePitch + ( r % rows ) * imageInfo.rowPitch, rowBytes ) )
+            first = r;
+    report( "memcmp per row", bytes, now() - start );
+
+    start = now();
+    size_t tiledFirst = compare_image_rows( dst, imageInfo.rowPitch, imageInfo.slicePitch, src, imageInfo.rowPitch,
+                                            imageInfo.slicePitch, rowBytes, rows, slices );
+    report( "compare_image_rows", bytes, now() - start );
+
+    if( first != rows * slices || tiledFirst != first )
+    {
+        printf( "ERROR: copied image compares as different (row %u, %u)\n", (unsigned) first, (unsigned) tiledFirst );
+        errors++;
+    }
+
+    // A difference late in the image, and one early that the later tiles should not go past
+    size_t late = rows * slices - 3, early = rows + 1;
+    dst[ ( late / rows ) * imageInfo.slicePitch + ( late % rows ) * imageInfo.rowPitch + rowBytes - 1 ] ^= 1;
+    if( compare_image_rows( dst, imageInfo.rowPitch, imageInfo.slicePitch, src, imageInfo.rowPitch,
+                            imageInfo.slicePitch, rowBytes, rows, slices ) != late )
+    {
+        printf( "ERROR: compare_image_rows missed the difference in row %u\n", (unsigned) late );
+        errors++;
+    }
+    dst[ ( early / rows ) * imageInfo.slicePitch + ( early % rows ) * imageInfo.rowPitch ] ^= 1;
+    if( compare_image_rows( dst, imageInfo.rowPitch, imageInfo.slicePitch, src, imageInfo.rowPitch,
+                            imageInfo.slicePitch, rowBytes, rows, slices ) != early )
+    {
+        printf( "ERROR: compare_image_rows didn't report row %u first\n", (unsigned) early );
+        errors++;
+    }
+
+    free_mtdata( d );
+    return errors;
+}
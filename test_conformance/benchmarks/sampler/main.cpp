@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures how many samples per second the host reference sampler produces for each image type
+// and sampler, calling sample_image_pixel_float_offset for every sample and calling the
+// specialized function from get_sample_image_pixel_float_fn directly.
+//
+//   test_bench_sampler [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#include "../../../test_common/harness/imageHelpers.h"
+
+bool gTestRounding = false;
+
+static double now( void )
+{
+#if defined( _WIN32 )
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter( &count );
+    QueryPerformanceFrequency( &frequency );
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+static const struct
+{
+    cl_mem_object_type type;
+    const char *name;
+    size_t width, height, depth, arraySize;
+} sImages[] = {
+    { CL_MEM_OBJECT_IMAGE1D, "1D", 4096, 0, 0, 0 },
+    { CL_MEM_OBJECT_IMAGE1D_ARRAY, "1D array", 256, 0, 0, 16 },
+    { CL_MEM_OBJECT_IMAGE2D, "2D", 64, 64, 0, 0 },
+    { CL_MEM_OBJECT_IMAGE2D_ARRAY, "2D array", 32, 32, 0, 4 },
+    { CL_MEM_OBJECT_IMAGE3D, "3D", 16, 16, 16, 0 },
+};
+
+static const struct
+{
+    cl_addressing_mode mode;
+    const char *name;
+} sModes[] = {
+    { CL_ADDRESS_NONE, "none" },
+    { CL_ADDRESS_CLAMP_TO_EDGE, "clamp_to_edge" },
+    { CL_ADDRESS_CLAMP, "clamp" },
+    { CL_ADDRESS_REPEAT, "repeat" },
+    { CL_ADDRESS_MIRRORED_REPEAT, "mirrored_repeat" },
+};
+
+#define COORD_COUNT 4096
+
+// Coordinates that stay inside the image for CL_ADDRESS_NONE and stray outside for the others
+static void make_coords( image_descriptor *imageInfo, image_sampler_data *sampler, float *coords, MTdata d )
+{
+    float inside = sampler->addressing_mode == CL_ADDRESS_NONE ? 0.f : 0.25f;
+    float extent[3] = { (float) imageInfo->width, (float) imageInfo->height, (float) imageInfo->depth };
+
+    if( imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY )
+        extent[1] = 0.f;
+    if( imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY )
+        extent[2] = 0.f;
+
+    for( size_t i = 0; i < COORD_COUNT * 3; i++ )
+    {
+        float e = extent[ i % 3 ];
+        float c = 0.f;
+        if( e != 0.f )
+        {
+            c = get_random_float( 0.05f - inside, 0.95f + inside, d );
+            if( !sampler->normalized_coords )
+                c *= e;
+        }
+        coords[i] = c;
+    }
+
+    // Array indices are never normalized
+    if( imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY )
+        for( size_t i = 0; i < COORD_COUNT; i++ )
+            coords[ i * 3 + 1 ] = (float) ( genrand_int32( d ) % imageInfo->arraySize );
+    if( imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY )
+        for( size_t i = 0; i < COORD_COUNT; i++ )
+            coords[ i * 3 + 2 ] = (float) ( genrand_int32( d ) % imageInfo->arraySize );
+}
+
+int main( int argc, const char *argv[] )
+{
+    double seconds = argc > 1 ? atof( argv[1] ) : 0.2;
+    cl_image_format format = { CL_RGBA, CL_UNORM_INT8 };
+    float *coords = (float *) malloc( COORD_COUNT * 3 * sizeof( float ) );
+    MTdata d = init_genrand( 1 );
+
+    printf( "%-9s %-16s %-8s %-10s %14s %14s\n", "image", "addressing", "filter", "coords",
+            "per call/s", "looked up/s" );
+
+    for( size_t i = 0; i < sizeof( sImages ) / sizeof( sImages[0] ); i++ )
+    {
+        image_descriptor imageInfo;
+        memset( &imageInfo, 0, sizeof( imageInfo ) );
+        imageInfo.type = sImages[i].type;
+        imageInfo.width = sImages[i].width;
+        imageInfo.height = sImages[i].height;
+        imageInfo.depth = sImages[i].depth;
+        imageInfo.arraySize = sImages[i].arraySize;
+        imageInfo.format = &format;
+        imageInfo.num_mip_levels = 1;
+        imageInfo.rowPitch = imageInfo.width * get_pixel_size( &format );
+        imageInfo.slicePitch = imageInfo.type == CL_MEM_OBJECT_IMAGE1D_ARRAY ? imageInfo.rowPitch
+                                                                             : imageInfo.rowPitch * imageInfo.height;
+
+        BufferOwningPtr<char> imageValues;
+        char *imagePtr = generate_random_image_data( &imageInfo, imageValues, d );
+
+        for( size_t m = 0; m < sizeof( sModes ) / sizeof( sModes[0] ); m++ )
+            for( int linear = 0; linear < 2; linear++ )
+                for( int normalized = 0; normalized < 2; normalized++ )
+                {
+                    image_sampler_data sampler = { sModes[m].mode, linear ? CL_FILTER_LINEAR : CL_FILTER_NEAREST,
+                                                   normalized != 0 };
+                    double rate[2];
+
+                    // Repeat modes need normalized coordinates
+                    if( !normalized && ( sampler.addressing_mode == CL_ADDRESS_REPEAT ||
+                                         sampler.addressing_mode == CL_ADDRESS_MIRRORED_REPEAT ) )
+                        continue;
+
+                    make_coords( &imageInfo, &sampler, coords, d );
+                    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( &imageInfo, &sampler );
+
+                    for( int specialized = 0; specialized < 2; specialized++ )
+                    {
+                        double start = now(), elapsed;
+                        size_t samples = 0;
+                        float sum = 0.f;
+                        do
+                        {
+                            for( size_t c = 0; c < COORD_COUNT; c++ )
+                            {
+                                float out[4];
+                                const float *xyz = coords + c * 3;
+                                if( specialized )
+                                    sampleFn( imagePtr, &imageInfo, xyz[0], xyz[1], xyz[2], 0.f, 0.f, 0.f,
+                                              out, 0, NULL, 0 );
+                                else
+                                    sample_image_pixel_float_offset( imagePtr, &imageInfo, xyz[0], xyz[1], xyz[2],
+                                                                     0.f, 0.f, 0.f, &sampler, out, 0, NULL, 0 );
+                                sum += out[0];
+                            }
+                            samples += COORD_COUNT;
+                            elapsed = now() - start;
+                        } while( elapsed < seconds );
+                        rate[ specialized ] = samples / elapsed;
+
+                        // Keep the calls from being optimized away
+                        if( sum == -1.f )
+                            printf( "!" );
+                    }
+
+                    printf( "%-9s %-16s %-8s %-10s %14.0f %14.0f\n", sImages[i].name, sModes[m].name,
+                            linear ? "linear" : "nearest", normalized ? "normalized" : "unnorm", rate[0], rate[1] );
+                }
+    }
+
+    free_mtdata( d );
+    free( coords );
+    return 0;
+}
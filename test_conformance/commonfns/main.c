@@ -34,23 +34,23 @@ static void initVecSizes() {
 
 
 test_definition test_list[] = {
-    ADD_TEST( clamp ),
-    ADD_TEST( degrees ),
-    ADD_TEST( fmax ),
-    ADD_TEST( fmaxf ),
-    ADD_TEST( fmin ),
-    ADD_TEST( fminf ),
-    ADD_TEST( max ),
-    ADD_TEST( maxf ),
-    ADD_TEST( min ),
-    ADD_TEST( minf ),
-    ADD_TEST( mix ),
-    ADD_TEST( radians ),
-    ADD_TEST( step ),
-    ADD_TEST( stepf ),
-    ADD_TEST( smoothstep ),
-    ADD_TEST( smoothstepf ),
-    ADD_TEST( sign ),
+    ADD_TEST_SHARED_CONTEXT( clamp ),
+    ADD_TEST_SHARED_CONTEXT( degrees ),
+    ADD_TEST_SHARED_CONTEXT( fmax ),
+    ADD_TEST_SHARED_CONTEXT( fmaxf ),
+    ADD_TEST_SHARED_CONTEXT( fmin ),
+    ADD_TEST_SHARED_CONTEXT( fminf ),
+    ADD_TEST_SHARED_CONTEXT( max ),
+    ADD_TEST_SHARED_CONTEXT( maxf ),
+    ADD_TEST_SHARED_CONTEXT( min ),
+    ADD_TEST_SHARED_CONTEXT( minf ),
+    ADD_TEST_SHARED_CONTEXT( mix ),
+    ADD_TEST_SHARED_CONTEXT( radians ),
+    ADD_TEST_SHARED_CONTEXT( step ),
+    ADD_TEST_SHARED_CONTEXT( stepf ),
+    ADD_TEST_SHARED_CONTEXT( smoothstep ),
+    ADD_TEST_SHARED_CONTEXT( smoothstepf ),
+    ADD_TEST_SHARED_CONTEXT( sign ),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
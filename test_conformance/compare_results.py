@@ -0,0 +1,89 @@
+#! /usr/bin/python
+
+# Compares two result files written by the harness (CL_CONFORMANCE_RESULTS_FILENAME) and flags
+# tests that got slower, bigger or stopped passing.
+#
+# Usage: compare_results.py [--threshold R] [--min-seconds S] <baseline.json> <new.json>
+#
+# A metric regresses when the new value is more than R times the baseline (default 1.5). Times
+# below S seconds in both files (default 0.1) are too noisy to compare and are ignored.
+# Exits with 1 if anything regressed.
+
+import json
+import sys
+
+def usage():
+    print('Usage: compare_results.py [--threshold R] [--min-seconds S] <baseline.json> <new.json>')
+    sys.exit(1)
+
+def parse_args(argv):
+    threshold = 1.5
+    min_seconds = 0.1
+    files = []
+    i = 0
+    while i < len(argv):
+        arg = argv[i]
+        if arg == '--threshold' and i + 1 < len(argv):
+            threshold = float(argv[i + 1])
+            i += 1
+        elif arg == '--min-seconds' and i + 1 < len(argv):
+            min_seconds = float(argv[i + 1])
+            i += 1
+        elif arg.startswith('-'):
+            usage()
+        else:
+            files.append(arg)
+        i += 1
+    if len(files) != 2 or threshold <= 0:
+        usage()
+    return threshold, min_seconds, files[0], files[1]
+
+def load(filename):
+    with open(filename) as f:
+        results = json.load(f)
+    return results.get('results', {}), results.get('metrics', {})
+
+# (metric, is a time)
+metrics = [('wall_seconds', True), ('cpu_seconds', True), ('build_seconds', True),
+           ('programs_built', False), ('peak_rss_kb', False)]
+
+def main():
+    threshold, min_seconds, baseline_file, new_file = parse_args(sys.argv[1:])
+    old_results, old_metrics = load(baseline_file)
+    new_results, new_metrics = load(new_file)
+
+    regressions = 0
+    for name in sorted(new_results):
+        if name not in old_results:
+            continue
+        if old_results[name] == 'pass' and new_results[name] != 'pass':
+            print('%s: %s -> %s' % (name, old_results[name], new_results[name]))
+            regressions += 1
+
+        old = old_metrics.get(name)
+        new = new_metrics.get(name)
+        if old is None or new is None:
+            continue
+        for metric, is_time in metrics:
+            if metric not in old or metric not in new:
+                continue
+            before = float(old[metric])
+            after = float(new[metric])
+            if is_time and max(before, after) < min_seconds:
+                continue
+            if after > before * threshold and after > before:
+                ratio = after / before if before > 0 else float('inf')
+                print('%s: %s %g -> %g (%.2fx)' % (name, metric, before, after, ratio))
+                regressions += 1
+
+    missing = [name for name in sorted(old_results) if name not in new_results]
+    if missing:
+        print('Not run in %s: %s' % (new_file, ' '.join(missing)))
+
+    if regressions:
+        print('%d regressions beyond %.2fx' % (regressions, threshold))
+        sys.exit(1)
+    print('No regressions beyond %.2fx' % threshold)
+
+if __name__ == '__main__':
+    main()
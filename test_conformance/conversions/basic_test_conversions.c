@@ -1812,430 +1812,374 @@ void init_long( void *out, SaturationMode sat, RoundingMode round, Type destType
 
 // ======
 
-void uchar2uchar_many( void *out, void *in, size_t n);
-void uchar2uchar_sat_many( void *out, void *in, size_t n);
-void char2uchar_many( void *out, void *in, size_t n);
-void char2uchar_sat_many( void *out, void *in, size_t n);
-void ushort2uchar_many( void *out, void *in, size_t n);
-void ushort2uchar_sat_many( void *out, void *in, size_t n);
-void short2uchar_many( void *out, void *in, size_t n);
-void short2uchar_sat_many( void *out, void *in, size_t n);
-void uint2uchar_many( void *out, void *in, size_t n);
-void uint2uchar_sat_many( void *out, void *in, size_t n);
-void int2uchar_many( void *out, void *in, size_t n);
-void int2uchar_sat_many( void *out, void *in, size_t n);
-void float2uchar_many( void *out, void *in, size_t n);
-void float2uchar_sat_many( void *out, void *in, size_t n);
-void double2uchar_many( void *out, void *in, size_t n);
-void double2uchar_sat_many( void *out, void *in, size_t n);
-void ulong2uchar_many( void *out, void *in, size_t n);
-void ulong2uchar_sat_many( void *out, void *in, size_t n);
-void long2uchar_many( void *out, void *in, size_t n);
-void long2uchar_sat_many( void *out, void *in, size_t n);
-void uchar2char_many( void *out, void *in, size_t n);
-void uchar2char_sat_many( void *out, void *in, size_t n);
-void char2char_many( void *out, void *in, size_t n);
-void char2char_sat_many( void *out, void *in, size_t n);
-void ushort2char_many( void *out, void *in, size_t n);
-void ushort2char_sat_many( void *out, void *in, size_t n);
-void short2char_many( void *out, void *in, size_t n);
-void short2char_sat_many( void *out, void *in, size_t n);
-void uint2char_many( void *out, void *in, size_t n);
-void uint2char_sat_many( void *out, void *in, size_t n);
-void int2char_many( void *out, void *in, size_t n);
-void int2char_sat_many( void *out, void *in, size_t n);
-void float2char_many( void *out, void *in, size_t n);
-void float2char_sat_many( void *out, void *in, size_t n);
-void double2char_many( void *out, void *in, size_t n);
-void double2char_sat_many( void *out, void *in, size_t n);
-void ulong2char_many( void *out, void *in, size_t n);
-void ulong2char_sat_many( void *out, void *in, size_t n);
-void long2char_many( void *out, void *in, size_t n);
-void long2char_sat_many( void *out, void *in, size_t n);
-void uchar2ushort_many( void *out, void *in, size_t n);
-void uchar2ushort_sat_many( void *out, void *in, size_t n);
-void char2ushort_many( void *out, void *in, size_t n);
-void char2ushort_sat_many( void *out, void *in, size_t n);
-void ushort2ushort_many( void *out, void *in, size_t n);
-void ushort2ushort_sat_many( void *out, void *in, size_t n);
-void short2ushort_many( void *out, void *in, size_t n);
-void short2ushort_sat_many( void *out, void *in, size_t n);
-void uint2ushort_many( void *out, void *in, size_t n);
-void uint2ushort_sat_many( void *out, void *in, size_t n);
-void int2ushort_many( void *out, void *in, size_t n);
-void int2ushort_sat_many( void *out, void *in, size_t n);
-void float2ushort_many( void *out, void *in, size_t n);
-void float2ushort_sat_many( void *out, void *in, size_t n);
-void double2ushort_many( void *out, void *in, size_t n);
-void double2ushort_sat_many( void *out, void *in, size_t n);
-void ulong2ushort_many( void *out, void *in, size_t n);
-void ulong2ushort_sat_many( void *out, void *in, size_t n);
-void long2ushort_many( void *out, void *in, size_t n);
-void long2ushort_sat_many( void *out, void *in, size_t n);
-void uchar2short_many( void *out, void *in, size_t n);
-void uchar2short_sat_many( void *out, void *in, size_t n);
-void char2short_many( void *out, void *in, size_t n);
-void char2short_sat_many( void *out, void *in, size_t n);
-void ushort2short_many( void *out, void *in, size_t n);
-void ushort2short_sat_many( void *out, void *in, size_t n);
-void short2short_many( void *out, void *in, size_t n);
-void short2short_sat_many( void *out, void *in, size_t n);
-void uint2short_many( void *out, void *in, size_t n);
-void uint2short_sat_many( void *out, void *in, size_t n);
-void int2short_many( void *out, void *in, size_t n);
-void int2short_sat_many( void *out, void *in, size_t n);
-void float2short_many( void *out, void *in, size_t n);
-void float2short_sat_many( void *out, void *in, size_t n);
-void double2short_many( void *out, void *in, size_t n);
-void double2short_sat_many( void *out, void *in, size_t n);
-void ulong2short_many( void *out, void *in, size_t n);
-void ulong2short_sat_many( void *out, void *in, size_t n);
-void long2short_many( void *out, void *in, size_t n);
-void long2short_sat_many( void *out, void *in, size_t n);
-void uchar2uint_many( void *out, void *in, size_t n);
-void uchar2uint_sat_many( void *out, void *in, size_t n);
-void char2uint_many( void *out, void *in, size_t n);
-void char2uint_sat_many( void *out, void *in, size_t n);
-void ushort2uint_many( void *out, void *in, size_t n);
-void ushort2uint_sat_many( void *out, void *in, size_t n);
-void short2uint_many( void *out, void *in, size_t n);
-void short2uint_sat_many( void *out, void *in, size_t n);
-void uint2uint_many( void *out, void *in, size_t n);
-void uint2uint_sat_many( void *out, void *in, size_t n);
-void int2uint_many( void *out, void *in, size_t n);
-void int2uint_sat_many( void *out, void *in, size_t n);
-void float2uint_many( void *out, void *in, size_t n);
-void float2uint_sat_many( void *out, void *in, size_t n);
-void double2uint_many( void *out, void *in, size_t n);
-void double2uint_sat_many( void *out, void *in, size_t n);
-void ulong2uint_many( void *out, void *in, size_t n);
-void ulong2uint_sat_many( void *out, void *in, size_t n);
-void long2uint_many( void *out, void *in, size_t n);
-void long2uint_sat_many( void *out, void *in, size_t n);
-void uchar2int_many( void *out, void *in, size_t n);
-void uchar2int_sat_many( void *out, void *in, size_t n);
-void char2int_many( void *out, void *in, size_t n);
-void char2int_sat_many( void *out, void *in, size_t n);
-void ushort2int_many( void *out, void *in, size_t n);
-void ushort2int_sat_many( void *out, void *in, size_t n);
-void short2int_many( void *out, void *in, size_t n);
-void short2int_sat_many( void *out, void *in, size_t n);
-void uint2int_many( void *out, void *in, size_t n);
-void uint2int_sat_many( void *out, void *in, size_t n);
-void int2int_many( void *out, void *in, size_t n);
-void int2int_sat_many( void *out, void *in, size_t n);
-void float2int_many( void *out, void *in, size_t n);
-void float2int_sat_many( void *out, void *in, size_t n);
-void double2int_many( void *out, void *in, size_t n);
-void double2int_sat_many( void *out, void *in, size_t n);
-void ulong2int_many( void *out, void *in, size_t n);
-void ulong2int_sat_many( void *out, void *in, size_t n);
-void long2int_many( void *out, void *in, size_t n);
-void long2int_sat_many( void *out, void *in, size_t n);
-void uchar2float_many( void *out, void *in, size_t n);
-void uchar2float_sat_many( void *out, void *in, size_t n);
-void char2float_many( void *out, void *in, size_t n);
-void char2float_sat_many( void *out, void *in, size_t n);
-void ushort2float_many( void *out, void *in, size_t n);
-void ushort2float_sat_many( void *out, void *in, size_t n);
-void short2float_many( void *out, void *in, size_t n);
-void short2float_sat_many( void *out, void *in, size_t n);
-void uint2float_many( void *out, void *in, size_t n);
-void uint2float_sat_many( void *out, void *in, size_t n);
-void int2float_many( void *out, void *in, size_t n);
-void int2float_sat_many( void *out, void *in, size_t n);
-void float2float_many( void *out, void *in, size_t n);
-void float2float_sat_many( void *out, void *in, size_t n);
-void double2float_many( void *out, void *in, size_t n);
-void double2float_sat_many( void *out, void *in, size_t n);
-void ulong2float_many( void *out, void *in, size_t n);
-void ulong2float_sat_many( void *out, void *in, size_t n);
-void long2float_many( void *out, void *in, size_t n);
-void long2float_sat_many( void *out, void *in, size_t n);
-void uchar2double_many( void *out, void *in, size_t n);
-void uchar2double_sat_many( void *out, void *in, size_t n);
-void char2double_many( void *out, void *in, size_t n);
-void char2double_sat_many( void *out, void *in, size_t n);
-void ushort2double_many( void *out, void *in, size_t n);
-void ushort2double_sat_many( void *out, void *in, size_t n);
-void short2double_many( void *out, void *in, size_t n);
-void short2double_sat_many( void *out, void *in, size_t n);
-void uint2double_many( void *out, void *in, size_t n);
-void uint2double_sat_many( void *out, void *in, size_t n);
-void int2double_many( void *out, void *in, size_t n);
-void int2double_sat_many( void *out, void *in, size_t n);
-void float2double_many( void *out, void *in, size_t n);
-void float2double_sat_many( void *out, void *in, size_t n);
-void double2double_many( void *out, void *in, size_t n);
-void double2double_sat_many( void *out, void *in, size_t n);
-void ulong2double_many( void *out, void *in, size_t n);
-void ulong2double_sat_many( void *out, void *in, size_t n);
-void long2double_many( void *out, void *in, size_t n);
-void long2double_sat_many( void *out, void *in, size_t n);
-void uchar2ulong_many( void *out, void *in, size_t n);
-void uchar2ulong_sat_many( void *out, void *in, size_t n);
-void char2ulong_many( void *out, void *in, size_t n);
-void char2ulong_sat_many( void *out, void *in, size_t n);
-void ushort2ulong_many( void *out, void *in, size_t n);
-void ushort2ulong_sat_many( void *out, void *in, size_t n);
-void short2ulong_many( void *out, void *in, size_t n);
-void short2ulong_sat_many( void *out, void *in, size_t n);
-void uint2ulong_many( void *out, void *in, size_t n);
-void uint2ulong_sat_many( void *out, void *in, size_t n);
-void int2ulong_many( void *out, void *in, size_t n);
-void int2ulong_sat_many( void *out, void *in, size_t n);
-void float2ulong_many( void *out, void *in, size_t n);
-void float2ulong_sat_many( void *out, void *in, size_t n);
-void double2ulong_many( void *out, void *in, size_t n);
-void double2ulong_sat_many( void *out, void *in, size_t n);
-void ulong2ulong_many( void *out, void *in, size_t n);
-void ulong2ulong_sat_many( void *out, void *in, size_t n);
-void long2ulong_many( void *out, void *in, size_t n);
-void long2ulong_sat_many( void *out, void *in, size_t n);
-void uchar2long_many( void *out, void *in, size_t n);
-void uchar2long_sat_many( void *out, void *in, size_t n);
-void char2long_many( void *out, void *in, size_t n);
-void char2long_sat_many( void *out, void *in, size_t n);
-void ushort2long_many( void *out, void *in, size_t n);
-void ushort2long_sat_many( void *out, void *in, size_t n);
-void short2long_many( void *out, void *in, size_t n);
-void short2long_sat_many( void *out, void *in, size_t n);
-void uint2long_many( void *out, void *in, size_t n);
-void uint2long_sat_many( void *out, void *in, size_t n);
-void int2long_many( void *out, void *in, size_t n);
-void int2long_sat_many( void *out, void *in, size_t n);
-void float2long_many( void *out, void *in, size_t n);
-void float2long_sat_many( void *out, void *in, size_t n);
-void double2long_many( void *out, void *in, size_t n);
-void double2long_sat_many( void *out, void *in, size_t n);
-void ulong2long_many( void *out, void *in, size_t n);
-void ulong2long_sat_many( void *out, void *in, size_t n);
-void long2long_many( void *out, void *in, size_t n);
-void long2long_sat_many( void *out, void *in, size_t n);
-
-void uchar2uchar_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_uchar )); }
-void uchar2uchar_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_uchar )); }
-void char2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_char)); }}
-void char2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_char)); }}
-void ushort2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_ushort)); }}
-void short2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_short)); }}
-void short2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_short)); }}
-void uint2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_uint)); }}
-void uint2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_uint)); }}
-void int2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_int)); }}
-void int2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_int)); }}
-void float2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_float)); }}
-void float2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_float)); }}
-void double2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_double)); }}
-void double2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_double)); }}
-void ulong2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_ulong)); }}
-void long2uchar_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2uchar( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_long)); }}
-void long2uchar_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2uchar_sat( (char*) out + i * sizeof(cl_uchar), (char*) in + i * sizeof(cl_long)); }}
-void uchar2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_uchar)); }}
-void char2char_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_char )); }
-void char2char_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_char )); }
-void ushort2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_ushort)); }}
-void short2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_short)); }}
-void short2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_short)); }}
-void uint2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_uint)); }}
-void uint2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_uint)); }}
-void int2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_int)); }}
-void int2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_int)); }}
-void float2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_float)); }}
-void float2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_float)); }}
-void double2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_double)); }}
-void double2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_double)); }}
-void ulong2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_ulong)); }}
-void long2char_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2char( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_long)); }}
-void long2char_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2char_sat( (char*) out + i * sizeof(cl_char), (char*) in + i * sizeof(cl_long)); }}
-void uchar2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_uchar)); }}
-void char2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_char)); }}
-void char2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_char)); }}
-void ushort2ushort_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_ushort )); }
-void ushort2ushort_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_ushort )); }
-void short2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_short)); }}
-void short2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_short)); }}
-void uint2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_uint)); }}
-void uint2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_uint)); }}
-void int2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_int)); }}
-void int2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_int)); }}
-void float2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_float)); }}
-void float2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_float)); }}
-void double2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_double)); }}
-void double2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_double)); }}
-void ulong2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_ulong)); }}
-void long2ushort_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2ushort( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_long)); }}
-void long2ushort_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2ushort_sat( (char*) out + i * sizeof(cl_ushort), (char*) in + i * sizeof(cl_long)); }}
-void uchar2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_uchar)); }}
-void char2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_char)); }}
-void char2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_char)); }}
-void ushort2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_ushort)); }}
-void short2short_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_short )); }
-void short2short_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_short )); }
-void uint2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_uint)); }}
-void uint2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_uint)); }}
-void int2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_int)); }}
-void int2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_int)); }}
-void float2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_float)); }}
-void float2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_float)); }}
-void double2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_double)); }}
-void double2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_double)); }}
-void ulong2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_ulong)); }}
-void long2short_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2short( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_long)); }}
-void long2short_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2short_sat( (char*) out + i * sizeof(cl_short), (char*) in + i * sizeof(cl_long)); }}
-void uchar2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_uchar)); }}
-void char2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_char)); }}
-void char2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_char)); }}
-void ushort2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_ushort)); }}
-void short2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_short)); }}
-void short2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_short)); }}
-void uint2uint_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_uint )); }
-void uint2uint_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_uint )); }
-void int2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_int)); }}
-void int2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_int)); }}
-void float2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_float)); }}
-void float2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_float)); }}
-void double2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_double)); }}
-void double2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_double)); }}
-void ulong2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_ulong)); }}
-void long2uint_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2uint( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_long)); }}
-void long2uint_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2uint_sat( (char*) out + i * sizeof(cl_uint), (char*) in + i * sizeof(cl_long)); }}
-void uchar2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_uchar)); }}
-void char2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_char)); }}
-void char2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_char)); }}
-void ushort2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_ushort)); }}
-void short2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_short)); }}
-void short2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_short)); }}
-void uint2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_uint)); }}
-void uint2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_uint)); }}
-void int2int_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_int )); }
-void int2int_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_int )); }
-void float2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_float)); }}
-void float2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_float)); }}
-void double2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_double)); }}
-void double2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_double)); }}
-void ulong2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_ulong)); }}
-void long2int_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2int( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_long)); }}
-void long2int_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2int_sat( (char*) out + i * sizeof(cl_int), (char*) in + i * sizeof(cl_long)); }}
-void uchar2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_uchar)); }}
-void char2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_char)); }}
-void char2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_char)); }}
-void ushort2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_ushort)); }}
-void short2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_short)); }}
-void short2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_short)); }}
-void uint2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_uint)); }}
-void uint2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_uint)); }}
-void int2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_int)); }}
-void int2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_int)); }}
-void float2float_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_float )); }
-void float2float_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_float )); }
-void double2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_double)); }}
-void double2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_double)); }}
-void ulong2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_ulong)); }}
-void long2float_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2float( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_long)); }}
-void long2float_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2float_sat( (char*) out + i * sizeof(cl_float), (char*) in + i * sizeof(cl_long)); }}
-void uchar2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_uchar)); }}
-void char2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_char)); }}
-void char2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_char)); }}
-void ushort2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_ushort)); }}
-void short2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_short)); }}
-void short2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_short)); }}
-void uint2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_uint)); }}
-void uint2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_uint)); }}
-void int2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_int)); }}
-void int2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_int)); }}
-void float2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_float)); }}
-void float2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_float)); }}
-void double2double_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_double )); }
-void double2double_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_double )); }
-void ulong2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_ulong)); }}
-void long2double_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2double( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_long)); }}
-void long2double_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2double_sat( (char*) out + i * sizeof(cl_double), (char*) in + i * sizeof(cl_long)); }}
-void uchar2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_uchar)); }}
-void char2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_char)); }}
-void char2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_char)); }}
-void ushort2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_ushort)); }}
-void short2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_short)); }}
-void short2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_short)); }}
-void uint2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_uint)); }}
-void uint2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_uint)); }}
-void int2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_int)); }}
-void int2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_int)); }}
-void float2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_float)); }}
-void float2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_float)); }}
-void double2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_double)); }}
-void double2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_double)); }}
-void ulong2ulong_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_ulong )); }
-void ulong2ulong_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_ulong )); }
-void long2ulong_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2ulong( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_long)); }}
-void long2ulong_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ long2ulong_sat( (char*) out + i * sizeof(cl_ulong), (char*) in + i * sizeof(cl_long)); }}
-void uchar2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_uchar)); }}
-void uchar2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uchar2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_uchar)); }}
-void char2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_char)); }}
-void char2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ char2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_char)); }}
-void ushort2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_ushort)); }}
-void ushort2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ushort2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_ushort)); }}
-void short2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_short)); }}
-void short2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ short2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_short)); }}
-void uint2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_uint)); }}
-void uint2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ uint2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_uint)); }}
-void int2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_int)); }}
-void int2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ int2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_int)); }}
-void float2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_float)); }}
-void float2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ float2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_float)); }}
-void double2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_double)); }}
-void double2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ double2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_double)); }}
-void ulong2long_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2long( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_ulong)); }}
-void ulong2long_sat_many( void *out, void *in, size_t n){size_t i; for( i = 0; i < n; i++){ ulong2long_sat( (char*) out + i * sizeof(cl_long), (char*) in + i * sizeof(cl_ulong)); }}
-void long2long_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_long )); }
-void long2long_sat_many( void *out, void *in, size_t n){ memcpy( out, in, n * sizeof( cl_long )); }
+// Runs a scalar conversion over n values. The tables below instantiate this once per
+// [dest][source][saturation], so each loop calls its conversion directly. Rounding is not a
+// parameter: the conversions round in the current mode, which PrepareReference sets.
+template< typename OutType, typename InType, void (*f)( void *, void * ) >
+static void ConvertMany( void *out, void *in, size_t n )
+{
+    OutType *o = (OutType*) out;
+    InType *s = (InType*) in;
+    size_t i;
+
+    for( i = 0; i < n; i++ )
+        f( o + i, s + i );
+}
+
+template< typename T >
+static void CopyMany( void *out, void *in, size_t n )
+{
+    memcpy( out, in, n * sizeof( T ) );
+}
+
+#define CONVERT( _out, _in )        ConvertMany< cl_##_out, cl_##_in, _in##2##_out >
+#define CONVERT_SAT( _out, _in )    ConvertMany< cl_##_out, cl_##_in, _in##2##_out##_sat >
+#define COPY( _type )               CopyMany< cl_##_type >
 
 Convert gSaturatedConversions[kTypeCount][kTypeCount] = {
-    {    uchar2uchar_sat_many,    char2uchar_sat_many,    ushort2uchar_sat_many,    short2uchar_sat_many,    uint2uchar_sat_many,    int2uchar_sat_many,    float2uchar_sat_many,    double2uchar_sat_many,    ulong2uchar_sat_many,    long2uchar_sat_many,     },
-    {    uchar2char_sat_many,    char2char_sat_many,    ushort2char_sat_many,    short2char_sat_many,    uint2char_sat_many,    int2char_sat_many,    float2char_sat_many,    double2char_sat_many,    ulong2char_sat_many, long2char_sat_many,     },
-    {    uchar2ushort_sat_many,    char2ushort_sat_many,    ushort2ushort_sat_many,    short2ushort_sat_many,    uint2ushort_sat_many,    int2ushort_sat_many,    float2ushort_sat_many,    double2ushort_sat_many,    ulong2ushort_sat_many,    long2ushort_sat_many,     },
-    {    uchar2short_sat_many,    char2short_sat_many,    ushort2short_sat_many,    short2short_sat_many,    uint2short_sat_many,    int2short_sat_many,    float2short_sat_many,    double2short_sat_many,    ulong2short_sat_many,    long2short_sat_many,     },
-    {    uchar2uint_sat_many,    char2uint_sat_many,    ushort2uint_sat_many,    short2uint_sat_many,    uint2uint_sat_many,    int2uint_sat_many,    float2uint_sat_many,    double2uint_sat_many,    ulong2uint_sat_many, long2uint_sat_many,     },
-    {    uchar2int_sat_many,    char2int_sat_many,    ushort2int_sat_many,    short2int_sat_many,    uint2int_sat_many,    int2int_sat_many,    float2int_sat_many,    double2int_sat_many,    ulong2int_sat_many,long2int_sat_many,     },
-    {    uchar2float_sat_many,    char2float_sat_many,    ushort2float_sat_many,    short2float_sat_many,    uint2float_sat_many,    int2float_sat_many,    float2float_sat_many,    double2float_sat_many,    ulong2float_sat_many,    long2float_sat_many,     },
-    {    uchar2double_sat_many,    char2double_sat_many,    ushort2double_sat_many,    short2double_sat_many,    uint2double_sat_many,    int2double_sat_many,    float2double_sat_many,    double2double_sat_many,    ulong2double_sat_many,    long2double_sat_many,     },
-    {    uchar2ulong_sat_many,    char2ulong_sat_many,    ushort2ulong_sat_many,    short2ulong_sat_many,    uint2ulong_sat_many,    int2ulong_sat_many,    float2ulong_sat_many,    double2ulong_sat_many,    ulong2ulong_sat_many,    long2ulong_sat_many,     },
-    {    uchar2long_sat_many,    char2long_sat_many,    ushort2long_sat_many,    short2long_sat_many,    uint2long_sat_many,    int2long_sat_many,    float2long_sat_many,    double2long_sat_many,    ulong2long_sat_many, long2long_sat_many,     },
+    {   COPY( uchar ),                  CONVERT_SAT( uchar, char ),     CONVERT_SAT( uchar, ushort ),   CONVERT_SAT( uchar, short ),    CONVERT_SAT( uchar, uint ),
+        CONVERT_SAT( uchar, int ),      CONVERT_SAT( uchar, float ),    CONVERT_SAT( uchar, double ),   CONVERT_SAT( uchar, ulong ),    CONVERT_SAT( uchar, long ),     },
+    {   CONVERT_SAT( char, uchar ),     COPY( char ),                   CONVERT_SAT( char, ushort ),    CONVERT_SAT( char, short ),     CONVERT_SAT( char, uint ),
+        CONVERT_SAT( char, int ),       CONVERT_SAT( char, float ),     CONVERT_SAT( char, double ),    CONVERT_SAT( char, ulong ),     CONVERT_SAT( char, long ),      },
+    {   CONVERT_SAT( ushort, uchar ),   CONVERT_SAT( ushort, char ),    COPY( ushort ),                 CONVERT_SAT( ushort, short ),   CONVERT_SAT( ushort, uint ),
+        CONVERT_SAT( ushort, int ),     CONVERT_SAT( ushort, float ),   CONVERT_SAT( ushort, double ),  CONVERT_SAT( ushort, ulong ),   CONVERT_SAT( ushort, long ),    },
+    {   CONVERT_SAT( short, uchar ),    CONVERT_SAT( short, char ),     CONVERT_SAT( short, ushort ),   COPY( short ),                  CONVERT_SAT( short, uint ),
+        CONVERT_SAT( short, int ),      CONVERT_SAT( short, float ),    CONVERT_SAT( short, double ),   CONVERT_SAT( short, ulong ),    CONVERT_SAT( short, long ),     },
+    {   CONVERT_SAT( uint, uchar ),     CONVERT_SAT( uint, char ),      CONVERT_SAT( uint, ushort ),    CONVERT_SAT( uint, short ),     COPY( uint ),
+        CONVERT_SAT( uint, int ),       CONVERT_SAT( uint, float ),     CONVERT_SAT( uint, double ),    CONVERT_SAT( uint, ulong ),     CONVERT_SAT( uint, long ),      },
+    {   CONVERT_SAT( int, uchar ),      CONVERT_SAT( int, char ),       CONVERT_SAT( int, ushort ),     CONVERT_SAT( int, short ),      CONVERT_SAT( int, uint ),
+        COPY( int ),                    CONVERT_SAT( int, float ),      CONVERT_SAT( int, double ),     CONVERT_SAT( int, ulong ),      CONVERT_SAT( int, long ),       },
+    {   CONVERT_SAT( float, uchar ),    CONVERT_SAT( float, char ),     CONVERT_SAT( float, ushort ),   CONVERT_SAT( float, short ),    CONVERT_SAT( float, uint ),
+        CONVERT_SAT( float, int ),      COPY( float ),                  CONVERT_SAT( float, double ),   CONVERT_SAT( float, ulong ),    CONVERT_SAT( float, long ),     },
+    {   CONVERT_SAT( double, uchar ),   CONVERT_SAT( double, char ),    CONVERT_SAT( double, ushort ),  CONVERT_SAT( double, short ),   CONVERT_SAT( double, uint ),
+        CONVERT_SAT( double, int ),     CONVERT_SAT( double, float ),   COPY( double ),                 CONVERT_SAT( double, ulong ),   CONVERT_SAT( double, long ),    },
+    {   CONVERT_SAT( ulong, uchar ),    CONVERT_SAT( ulong, char ),     CONVERT_SAT( ulong, ushort ),   CONVERT_SAT( ulong, short ),    CONVERT_SAT( ulong, uint ),
+        CONVERT_SAT( ulong, int ),      CONVERT_SAT( ulong, float ),    CONVERT_SAT( ulong, double ),   COPY( ulong ),                  CONVERT_SAT( ulong, long ),     },
+    {   CONVERT_SAT( long, uchar ),     CONVERT_SAT( long, char ),      CONVERT_SAT( long, ushort ),    CONVERT_SAT( long, short ),     CONVERT_SAT( long, uint ),
+        CONVERT_SAT( long, int ),       CONVERT_SAT( long, float ),     CONVERT_SAT( long, double ),    CONVERT_SAT( long, ulong ),     COPY( long ),                   },
 };
 
 Convert gConversions[kTypeCount][kTypeCount] = {
-    {    uchar2uchar_many,    char2uchar_many,    ushort2uchar_many,    short2uchar_many,    uint2uchar_many,    int2uchar_many,    float2uchar_many,    double2uchar_many,    ulong2uchar_many,    long2uchar_many,     },
-    {    uchar2char_many,    char2char_many,    ushort2char_many,    short2char_many,    uint2char_many,    int2char_many,    float2char_many,    double2char_many,    ulong2char_many,    long2char_many,     },
-    {    uchar2ushort_many,    char2ushort_many,    ushort2ushort_many,    short2ushort_many,    uint2ushort_many,    int2ushort_many,    float2ushort_many,    double2ushort_many,    ulong2ushort_many,    long2ushort_many,     },
-    {    uchar2short_many,    char2short_many,    ushort2short_many,    short2short_many,    uint2short_many,    int2short_many,    float2short_many,    double2short_many,    ulong2short_many,    long2short_many,     },
-    {    uchar2uint_many,    char2uint_many,    ushort2uint_many,    short2uint_many,    uint2uint_many,    int2uint_many,    float2uint_many,    double2uint_many,    ulong2uint_many,    long2uint_many,     },
-    {    uchar2int_many,    char2int_many,    ushort2int_many,    short2int_many,    uint2int_many,    int2int_many,    float2int_many,    double2int_many,    ulong2int_many,    long2int_many,     },
-    {    uchar2float_many,    char2float_many,    ushort2float_many,    short2float_many,    uint2float_many,    int2float_many,    float2float_many,    double2float_many,    ulong2float_many,    long2float_many,     },
-    {    uchar2double_many,    char2double_many,    ushort2double_many,    short2double_many,    uint2double_many,    int2double_many,    float2double_many,    double2double_many,    ulong2double_many,    long2double_many,     },
-    {    uchar2ulong_many,    char2ulong_many,    ushort2ulong_many,    short2ulong_many,    uint2ulong_many,    int2ulong_many,    float2ulong_many,    double2ulong_many,    ulong2ulong_many,    long2ulong_many,     },
-    {    uchar2long_many,    char2long_many,    ushort2long_many,    short2long_many,    uint2long_many,    int2long_many,    float2long_many,    double2long_many,    ulong2long_many,    long2long_many,     },
+    {   COPY( uchar ),                  CONVERT( uchar, char ),         CONVERT( uchar, ushort ),       CONVERT( uchar, short ),        CONVERT( uchar, uint ),
+        CONVERT( uchar, int ),          CONVERT( uchar, float ),        CONVERT( uchar, double ),       CONVERT( uchar, ulong ),        CONVERT( uchar, long ),         },
+    {   CONVERT( char, uchar ),         COPY( char ),                   CONVERT( char, ushort ),        CONVERT( char, short ),         CONVERT( char, uint ),
+        CONVERT( char, int ),           CONVERT( char, float ),         CONVERT( char, double ),        CONVERT( char, ulong ),         CONVERT( char, long ),          },
+    {   CONVERT( ushort, uchar ),       CONVERT( ushort, char ),        COPY( ushort ),                 CONVERT( ushort, short ),       CONVERT( ushort, uint ),
+        CONVERT( ushort, int ),         CONVERT( ushort, float ),       CONVERT( ushort, double ),      CONVERT( ushort, ulong ),       CONVERT( ushort, long ),        },
+    {   CONVERT( short, uchar ),        CONVERT( short, char ),         CONVERT( short, ushort ),       COPY( short ),                  CONVERT( short, uint ),
+        CONVERT( short, int ),          CONVERT( short, float ),        CONVERT( short, double ),       CONVERT( short, ulong ),        CONVERT( short, long ),         },
+    {   CONVERT( uint, uchar ),         CONVERT( uint, char ),          CONVERT( uint, ushort ),        CONVERT( uint, short ),         COPY( uint ),
+        CONVERT( uint, int ),           CONVERT( uint, float ),         CONVERT( uint, double ),        CONVERT( uint, ulong ),         CONVERT( uint, long ),          },
+    {   CONVERT( int, uchar ),          CONVERT( int, char ),           CONVERT( int, ushort ),         CONVERT( int, short ),          CONVERT( int, uint ),
+        COPY( int ),                    CONVERT( int, float ),          CONVERT( int, double ),         CONVERT( int, ulong ),          CONVERT( int, long ),           },
+    {   CONVERT( float, uchar ),        CONVERT( float, char ),         CONVERT( float, ushort ),       CONVERT( float, short ),        CONVERT( float, uint ),
+        CONVERT( float, int ),          COPY( float ),                  CONVERT( float, double ),       CONVERT( float, ulong ),        CONVERT( float, long ),         },
+    {   CONVERT( double, uchar ),       CONVERT( double, char ),        CONVERT( double, ushort ),      CONVERT( double, short ),       CONVERT( double, uint ),
+        CONVERT( double, int ),         CONVERT( double, float ),       COPY( double ),                 CONVERT( double, ulong ),       CONVERT( double, long ),        },
+    {   CONVERT( ulong, uchar ),        CONVERT( ulong, char ),         CONVERT( ulong, ushort ),       CONVERT( ulong, short ),        CONVERT( ulong, uint ),
+        CONVERT( ulong, int ),          CONVERT( ulong, float ),        CONVERT( ulong, double ),       COPY( ulong ),                  CONVERT( ulong, long ),         },
+    {   CONVERT( long, uchar ),         CONVERT( long, char ),          CONVERT( long, ushort ),        CONVERT( long, short ),         CONVERT( long, uint ),
+        CONVERT( long, int ),           CONVERT( long, float ),         CONVERT( long, double ),        CONVERT( long, ulong ),         COPY( long ),                   },
 };
+
+#pragma mark -
+#pragma mark Vector conversions
+
+// A vectorized replacement for one entry in gConversions or gSaturatedConversions
+typedef struct VectorConversion
+{
+    Type        outType;
+    Type        inType;
+    int         sat;
+    Convert     f;
+}VectorConversion;
+
+// This file is built with -O0 to work around an old MSVC internal compiler error. The vector
+// conversions do not need that, and at -O0 every intrinsic goes through the stack, so let GCC
+// optimize them. They are checked against the scalar conversions at start up either way.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+    #define CONV_OPTIMIZE               __attribute__((optimize("O2")))
+#else
+    #define CONV_OPTIMIZE
+#endif
+
+// The x86 conversions are built with a target attribute and picked at run time, since the
+// conversions test is built for plain SSE2
+#if (defined( __i386__ ) || defined( __x86_64__ )) && (defined( __clang__ ) || (defined( __GNUC__ ) && __GNUC__ >= 5))
+    #include <immintrin.h>
+    #include <string.h>
+
+    #define CONV_SSE_STORE8( _p, _v )   do{ __m128i _t = _mm_and_si128( _v, _mm_set1_epi32( 0xff ) ); _t = _mm_packus_epi32( _t, _t ); \
+                                            cl_int _w = _mm_cvtsi128_si32( _mm_packus_epi16( _t, _t ) ); memcpy( _p, &_w, sizeof( _w ) ); }while(0)
+    #define CONV_SSE_STORE16( _p, _v )  do{ __m128i _t = _mm_and_si128( _v, _mm_set1_epi32( 0xffff ) ); \
+                                            _mm_storel_epi64( (__m128i*) (_p), _mm_packus_epi32( _t, _t ) ); }while(0)
+    #define CONV_SSE_STORE64( _p, _v )  do{ _mm_storeu_si128( (__m128i*) (_p), _mm_cvtepi32_epi64( _v ) ); \
+                                            _mm_storeu_si128( (__m128i*) (_p) + 1, _mm_cvtepi32_epi64( _mm_srli_si128( _v, 8 ) ) ); }while(0)
+    #define CONV_SSE_STOREU64( _p, _v ) do{ _mm_storeu_si128( (__m128i*) (_p), _mm_cvtepu32_epi64( _v ) ); \
+                                            _mm_storeu_si128( (__m128i*) (_p) + 1, _mm_cvtepu32_epi64( _mm_srli_si128( _v, 8 ) ) ); }while(0)
+    // Both halves of an unsigned int convert exactly, so the sum is the only rounding
+    #define CONV_SSE_UF( _v )           _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32( _v, 16 ) ), _mm_set1_ps( 65536.0f ) ), \
+                                                    _mm_cvtepi32_ps( _mm_and_si128( _v, _mm_set1_epi32( 0xffff ) ) ) )
+    #define CONV_SSE_STORED( _p, _v )   do{ _mm_storeu_pd( (double*) (_p), _mm_cvtepi32_pd( _v ) ); \
+                                            _mm_storeu_pd( (double*) (_p) + 2, _mm_cvtepi32_pd( _mm_srli_si128( _v, 8 ) ) ); }while(0)
+    #define CONV_SSE_UD( _v )           _mm_add_pd( _mm_mul_pd( _mm_cvtepi32_pd( _mm_srli_epi32( _v, 16 ) ), _mm_set1_pd( 65536.0 ) ), \
+                                                    _mm_cvtepi32_pd( _mm_and_si128( _v, _mm_set1_epi32( 0xffff ) ) ) )
+    #define CONV_SSE_STOREUD( _p, _v )  do{ _mm_storeu_pd( (double*) (_p), CONV_SSE_UD( _v ) ); \
+                                            _mm_storeu_pd( (double*) (_p) + 2, CONV_SSE_UD( _mm_srli_si128( _v, 8 ) ) ); }while(0)
+    // cvtps2dq gives 0x80000000 for anything out of range and NaN, which is what (long) gives
+    // for NaN and the negative side. Flip the lanes that are too large to INT_MAX.
+    #define CONV_SSE_RINT( _f )         _mm_xor_si128( _mm_cvtps_epi32( _f ), _mm_castps_si128( _mm_cmpge_ps( _f, _mm_set1_ps( 2147483648.0f ) ) ) )
+
+    #define CONV_NAME( _n )             _n##_sse41
+    #define CONV_ATTR                   __attribute__((target("sse4.1"))) CONV_OPTIMIZE
+    #define CONV_WIDTH                  4
+    #define CONV_V                      __m128i
+    #define CONV_VF                     __m128
+    #define CONV_LOAD( _p )             _mm_loadu_si128( (const __m128i*) (_p) )
+    #define CONV_LOADF                  _mm_loadu_ps
+    #define CONV_SPLAT                  _mm_set1_epi32
+    #define CONV_MIN                    _mm_min_epi32
+    #define CONV_MAX                    _mm_max_epi32
+    #define CONV_MINU                   _mm_min_epu32
+    #define CONV_RINT                   CONV_SSE_RINT
+    #define CONV_STORE8                 CONV_SSE_STORE8
+    #define CONV_STORE16                CONV_SSE_STORE16
+    #define CONV_STORE32( _p, _v )      _mm_storeu_si128( (__m128i*) (_p), _v )
+    #define CONV_STORE64                CONV_SSE_STORE64
+    #define CONV_STOREU64               CONV_SSE_STOREU64
+    #define CONV_STOREF( _p, _v )       _mm_storeu_ps( (float*) (_p), _mm_cvtepi32_ps( _v ) )
+    #define CONV_STOREUF( _p, _v )      _mm_storeu_ps( (float*) (_p), CONV_SSE_UF( _v ) )
+    #define CONV_STORED                 CONV_SSE_STORED
+    #define CONV_STOREUD                CONV_SSE_STOREUD
+    #include "basic_test_conversions_array.h"
+    #define HAS_CONV_SSE41 1
+
+    #undef  CONV_NAME
+    #undef  CONV_ATTR
+    #undef  CONV_WIDTH
+    #undef  CONV_V
+    #undef  CONV_VF
+    #undef  CONV_LOAD
+    #undef  CONV_LOADF
+    #undef  CONV_SPLAT
+    #undef  CONV_MIN
+    #undef  CONV_MAX
+    #undef  CONV_MINU
+    #undef  CONV_RINT
+    #undef  CONV_STORE8
+    #undef  CONV_STORE16
+    #undef  CONV_STORE32
+    #undef  CONV_STORE64
+    #undef  CONV_STOREU64
+    #undef  CONV_STOREF
+    #undef  CONV_STOREUF
+    #undef  CONV_STORED
+    #undef  CONV_STOREUD
+    // The narrowing and widening stores work on each 128 bit half
+    #define CONV_LO( _v )               _mm256_castsi256_si128( _v )
+    #define CONV_HI( _v )               _mm256_extracti128_si256( _v, 1 )
+    #define CONV_NAME( _n )             _n##_avx2
+    #define CONV_ATTR                   __attribute__((target("avx2"))) CONV_OPTIMIZE
+    #define CONV_WIDTH                  8
+    #define CONV_V                      __m256i
+    #define CONV_VF                     __m256
+    #define CONV_LOAD( _p )             _mm256_loadu_si256( (const __m256i*) (_p) )
+    #define CONV_LOADF                  _mm256_loadu_ps
+    #define CONV_SPLAT                  _mm256_set1_epi32
+    #define CONV_MIN                    _mm256_min_epi32
+    #define CONV_MAX                    _mm256_max_epi32
+    #define CONV_MINU                   _mm256_min_epu32
+    #define CONV_RINT( _f )             _mm256_xor_si256( _mm256_cvtps_epi32( _f ), \
+                                                          _mm256_castps_si256( _mm256_cmp_ps( _f, _mm256_set1_ps( 2147483648.0f ), _CMP_GE_OQ ) ) )
+    #define CONV_STORE8( _p, _v )       do{ CONV_SSE_STORE8( _p, CONV_LO( _v ) ); CONV_SSE_STORE8( (_p) + 4, CONV_HI( _v ) ); }while(0)
+    #define CONV_STORE16( _p, _v )      do{ CONV_SSE_STORE16( _p, CONV_LO( _v ) ); CONV_SSE_STORE16( (_p) + 4, CONV_HI( _v ) ); }while(0)
+    #define CONV_STORE32( _p, _v )      _mm256_storeu_si256( (__m256i*) (_p), _v )
+    #define CONV_STORE64( _p, _v )      do{ _mm256_storeu_si256( (__m256i*) (_p), _mm256_cvtepi32_epi64( CONV_LO( _v ) ) ); \
+                                            _mm256_storeu_si256( (__m256i*) (_p) + 1, _mm256_cvtepi32_epi64( CONV_HI( _v ) ) ); }while(0)
+    #define CONV_STOREU64( _p, _v )     do{ _mm256_storeu_si256( (__m256i*) (_p), _mm256_cvtepu32_epi64( CONV_LO( _v ) ) ); \
+                                            _mm256_storeu_si256( (__m256i*) (_p) + 1, _mm256_cvtepu32_epi64( CONV_HI( _v ) ) ); }while(0)
+    #define CONV_STOREF( _p, _v )       _mm256_storeu_ps( (float*) (_p), _mm256_cvtepi32_ps( _v ) )
+    #define CONV_STOREUF( _p, _v )      _mm256_storeu_ps( (float*) (_p), \
+                                                          _mm256_add_ps( _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_srli_epi32( _v, 16 ) ), _mm256_set1_ps( 65536.0f ) ), \
+                                                                         _mm256_cvtepi32_ps( _mm256_and_si256( _v, _mm256_set1_epi32( 0xffff ) ) ) ) )
+    #define CONV_STORED( _p, _v )       do{ _mm256_storeu_pd( (double*) (_p), _mm256_cvtepi32_pd( CONV_LO( _v ) ) ); \
+                                            _mm256_storeu_pd( (double*) (_p) + 4, _mm256_cvtepi32_pd( CONV_HI( _v ) ) ); }while(0)
+    #define CONV_AVX2_UD( _v )          _mm256_add_pd( _mm256_mul_pd( _mm256_cvtepi32_pd( _mm_srli_epi32( _v, 16 ) ), _mm256_set1_pd( 65536.0 ) ), \
+                                                       _mm256_cvtepi32_pd( _mm_and_si128( _v, _mm_set1_epi32( 0xffff ) ) ) )
+    #define CONV_STOREUD( _p, _v )      do{ _mm256_storeu_pd( (double*) (_p), CONV_AVX2_UD( CONV_LO( _v ) ) ); \
+                                            _mm256_storeu_pd( (double*) (_p) + 4, CONV_AVX2_UD( CONV_HI( _v ) ) ); }while(0)
+    #include "basic_test_conversions_array.h"
+    #define HAS_CONV_AVX2 1
+#endif
+
+// 32-bit ARM NEON flushes denormals and can not round in the current mode, so only AArch64 gets a NEON path
+#if defined( __aarch64__ ) && defined( __ARM_NEON )
+    #include <arm_neon.h>
+
+    #define CONV_U( _v )                vreinterpretq_u32_s32( _v )
+    #define CONV_NAME( _n )             _n##_neon
+    #define CONV_ATTR                   CONV_OPTIMIZE
+    #define CONV_WIDTH                  4
+    #define CONV_V                      int32x4_t
+    #define CONV_VF                     float32x4_t
+    #define CONV_LOAD( _p )             vld1q_s32( (const int32_t*) (_p) )
+    #define CONV_LOADF                  vld1q_f32
+    #define CONV_SPLAT                  vdupq_n_s32
+    #define CONV_MIN                    vminq_s32
+    #define CONV_MAX                    vmaxq_s32
+    #define CONV_MINU( _a, _b )         vreinterpretq_s32_u32( vminq_u32( CONV_U( _a ), CONV_U( _b ) ) )
+    // frintx rounds in the current mode. fcvtzs saturates and gives 0 for NaN, as (long) does here.
+    #define CONV_RINT( _f )             vcvtq_s32_f32( vrndxq_f32( _f ) )
+    #define CONV_STORE8( _p, _v )       do{ int16x4_t _t = vmovn_s32( _v ); \
+                                            vst1_lane_u32( (uint32_t*) (_p), vreinterpret_u32_s8( vmovn_s16( vcombine_s16( _t, _t ) ) ), 0 ); }while(0)
+    #define CONV_STORE16( _p, _v )      vst1_s16( (int16_t*) (_p), vmovn_s32( _v ) )
+    #define CONV_STORE32( _p, _v )      vst1q_s32( (int32_t*) (_p), _v )
+    #define CONV_STORE64( _p, _v )      do{ vst1q_s64( (int64_t*) (_p), vmovl_s32( vget_low_s32( _v ) ) ); \
+                                            vst1q_s64( (int64_t*) (_p) + 2, vmovl_high_s32( _v ) ); }while(0)
+    #define CONV_STOREU64( _p, _v )     do{ vst1q_u64( (uint64_t*) (_p), vmovl_u32( vget_low_u32( CONV_U( _v ) ) ) ); \
+                                            vst1q_u64( (uint64_t*) (_p) + 2, vmovl_high_u32( CONV_U( _v ) ) ); }while(0)
+    #define CONV_STOREF( _p, _v )       vst1q_f32( (float*) (_p), vcvtq_f32_s32( _v ) )
+    #define CONV_STOREUF( _p, _v )      vst1q_f32( (float*) (_p), vcvtq_f32_u32( CONV_U( _v ) ) )
+    #define CONV_STORED( _p, _v )       do{ vst1q_f64( (double*) (_p), vcvtq_f64_s64( vmovl_s32( vget_low_s32( _v ) ) ) ); \
+                                            vst1q_f64( (double*) (_p) + 2, vcvtq_f64_s64( vmovl_high_s32( _v ) ) ); }while(0)
+    #define CONV_STOREUD( _p, _v )      do{ vst1q_f64( (double*) (_p), vcvtq_f64_u64( vmovl_u32( vget_low_u32( CONV_U( _v ) ) ) ) ); \
+                                            vst1q_f64( (double*) (_p) + 2, vcvtq_f64_u64( vmovl_high_u32( CONV_U( _v ) ) ) ); }while(0)
+    #include "basic_test_conversions_array.h"
+    #define HAS_CONV_NEON 1
+#endif
+
+// Pick the widest instruction set the host supports
+static const VectorConversion *VectorConversionsForHost( const char **name )
+{
+#if defined( HAS_CONV_AVX2 )
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+        *name = "AVX2";
+        return gVectorConversions_avx2;
+    }
+#endif
+#if defined( HAS_CONV_SSE41 )
+    if( __builtin_cpu_supports( "sse4.1" ) )
+    {
+        *name = "SSE4.1";
+        return gVectorConversions_sse41;
+    }
+#endif
+#if defined( HAS_CONV_NEON )
+    *name = "NEON";
+    return gVectorConversions_neon;
+#else
+    *name = "none";
+    return NULL;
+#endif
+}
+
+int InitVectorConversions( void )
+{
+    // Zeros, the edges of every destination range, the edges of exact conversion to float, and for
+    // float inputs halfway cases, denormals, the edges of the int range, infinities and NaNs
+    static const cl_uint intSpecials[] = {
+        0x00000000, 0x00000001, 0xffffffff, 0x0000007f, 0x00000080, 0x000000ff, 0x00000100, 0xffffff80,
+        0xffffff7f, 0x00007fff, 0x00008000, 0x0000ffff, 0x00010000, 0xffff8000, 0xffff7fff, 0x00ffffff,
+        0x01000000, 0x01000001, 0x01000003, 0x7fffffff, 0x80000000, 0x80000001, 0x7fffff80, 0x7fffffc0,
+        0xffffff40, 0xfffffffe };
+    static const cl_uint floatSpecials[] = {
+        0x00000000, 0x80000000, 0x00000001, 0x80000001, 0x3effffff, 0xbeffffff, 0x3f000000, 0xbf000000,
+        0x3fc00000, 0xbfc00000, 0x40200000, 0xc0200000, 0x437f0000, 0x437f8000, 0x43800000, 0x42fe0000,
+        0x42ff0000, 0xc3000000, 0xc3008000, 0x477fff00, 0x477fff80, 0x47800000, 0x46fffe00, 0x46ffff00,
+        0xc7000000, 0xc7000080, 0x4afffffe, 0x4b000000, 0x4effffff, 0x4f000000, 0xcf000000, 0xcf000001,
+        0x7f7fffff, 0xff7fffff, 0x7f800000, 0xff800000, 0x7fc00000, 0xffc00000, 0x7f800001, 0x7fc12345 };
+    const size_t count = 1 << 16;
+    const VectorConversion *table, *a;
+    const char *isa;
+    cl_uint *in = NULL;
+    cl_uchar *out = NULL, *ref = NULL;
+    size_t i, offset;
+    int round, errors = 0;
+    MTdata d;
+
+    if( NULL == (table = VectorConversionsForHost( &isa )) )
+        return 0;
+
+    in = (cl_uint*) malloc( count * sizeof( *in ) );
+    out = (cl_uchar*) malloc( count * sizeof( cl_ulong ) );
+    ref = (cl_uchar*) malloc( count * sizeof( cl_ulong ) );
+    d = init_genrand( 0x5eed1e55 );
+    if( NULL == in || NULL == out || NULL == ref || NULL == d )
+    {
+        vlog_error( "Error: Unable to allocate memory for the vector conversion self test\n" );
+        errors = 1;
+        goto exit;
+    }
+
+    for( a = table; NULL != a->f && errors < 16; a++ )
+    {
+        const cl_uint *specials = a->inType == kfloat ? floatSpecials : intSpecials;
+        size_t specialCount = a->inType == kfloat ? sizeof( floatSpecials ) / sizeof( floatSpecials[0] )
+                                                  : sizeof( intSpecials ) / sizeof( intSpecials[0] );
+        size_t outSize = gTypeSizes[ a->outType ];
+        Convert scalar = a->sat ? gSaturatedConversions[ a->outType ][ a->inType ] : gConversions[ a->outType ][ a->inType ];
+
+        // Special values and their neighbours, then random bits. Random floats are mostly huge,
+        // so half of them are scaled into the range of the small types, fractions included.
+        for( i = 0; i < count; i++ )
+        {
+            if( i < specialCount * 4 )
+                in[i] = specials[ i / 4 ] + (cl_uint) (i % 4) - 1;
+            else if( a->inType == kfloat && (i & 1) )
+            {
+                cl_float f = (cl_float) (cl_int) genrand_int32( d ) * MAKE_HEX_FLOAT( 0x1.0p-14f, 0x1, -14 );
+                memcpy( in + i, &f, sizeof( f ) );
+            }
+            else
+                in[i] = genrand_int32( d );
+        }
+
+        for( round = kRoundToNearestEven; round <= kRoundTowardZero; round++ )
+        {
+            // Run from an odd offset too, to cover a short tail
+            for( offset = 0; offset < 2; offset++ )
+            {
+                size_t n = count - offset;
+                RoundingMode oldRound = set_round( (RoundingMode) round, a->outType );
+
+                memset( out, 0, count * outSize );
+                memset( ref, 0, count * outSize );
+                scalar( ref, in + offset, n );
+                a->f( out, in + offset, n );
+                set_round( oldRound, a->outType );
+
+                for( i = 0; i < n && errors < 16; i++ )
+                    if( memcmp( out + i * outSize, ref + i * outSize, outSize ) )
+                    {
+                        vlog_error( "Error: %s convert_%s%s%s( (%s) 0x%8.8x ) does not match the scalar reference\n", isa,
+                                    gTypeNames[ a->outType ], a->sat ? "_sat" : "", gRoundingModeNames[ round ],
+                                    gTypeNames[ a->inType ], in[i + offset] );
+                        errors++;
+                    }
+            }
+        }
+    }
+
+exit:
+    free( in );
+    free( out );
+    free( ref );
+    free_mtdata( d );
+
+    if( errors )
+    {
+        vlog_error( "Vector conversions do not match the scalar conversions. Using the scalar conversions only.\n" );
+        return errors;
+    }
+
+    for( a = table; NULL != a->f; a++ )
+    {
+        if( a->sat )
+            gSaturatedConversions[ a->outType ][ a->inType ] = a->f;
+        else
+            gConversions[ a->outType ][ a->inType ] = a->f;
+    }
+
+    return 0;
+}
@@ -49,6 +49,9 @@ typedef enum
 
 extern Convert gConversions[kTypeCount][kTypeCount];                // [dest format][source format]
 extern Convert gSaturatedConversions[kTypeCount][kTypeCount];       // [dest format][source format]
+// Swaps vectorized conversions into the tables above where the host supports them. Returns
+// non-zero, leaving the scalar conversions in place, if they do not match the scalar conversions.
+extern int InitVectorConversions( void );
 extern const char *gTypeNames[ kTypeCount ];
 extern const char *gRoundingModeNames[ kRoundingModeCount ];        // { "", "_rte", "_rtp", "_rtn", "_rtz" }
 extern const char *gSaturationNames[ kSaturationModeCount ];        // { "", "_sat" }
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Vectorized conversions from the 32 bit types, which are the ones swept over all 2**32 inputs.
+// Written once in terms of the CONV_* vector primitives. basic_test_conversions.c includes this
+// file once per instruction set, after defining:
+//
+//   CONV_NAME( _n )          decorates a function name with the instruction set
+//   CONV_ATTR                function attributes needed to use the instruction set
+//   CONV_WIDTH               32 bit lanes per vector
+//   CONV_V, CONV_VF          int and float vector types
+//   CONV_LOAD, CONV_LOADF    unaligned int and float loads
+//   CONV_SPLAT( i )          int vector with every lane set to i
+//   CONV_MIN, CONV_MAX       signed min and max
+//   CONV_MINU                unsigned min
+//   CONV_RINT( f )           f rounded to int in the current rounding mode. Lanes that are too
+//                            large, too small or NaN give what (long) gives on the host
+//   CONV_STORE8, 16, 32      store the low 8, 16 or 32 bits of each lane
+//   CONV_STORE64, U64        store each lane sign or zero extended to 64 bits
+//   CONV_STOREF, UF          store each lane as a signed or unsigned int converted to float in
+//                            the current rounding mode
+//   CONV_STORED, UD          store each lane as a signed or unsigned int converted to double
+//
+// The stores take a pointer to the destination type. Results must be bit identical to the
+// scalar conversions in every rounding mode. InitVectorConversions() checks this at start up.
+
+#define CONV_FROM_INT( _in, _out, _sat, _store, _expr )                                         \
+static CONV_ATTR void CONV_NAME( _in##2##_out##_sat )( void *out, void *in, size_t n )         \
+{                                                                                               \
+    cl_##_out *o = (cl_##_out*) out;                                                            \
+    cl_##_in *s = (cl_##_in*) in;                                                               \
+    size_t i;                                                                                   \
+    for( i = 0; i + CONV_WIDTH <= n; i += CONV_WIDTH )                                          \
+    {                                                                                           \
+        CONV_V x = CONV_LOAD( s + i );                                                          \
+        CONV_V r = _expr;                                                                       \
+        _store( o + i, r );                                                                     \
+    }                                                                                           \
+    for( ; i < n; i++ )                                                                         \
+        _in##2##_out##_sat( o + i, s + i );                                                     \
+}
+
+#define CONV_FROM_FLOAT( _out, _store, _lo, _hi )                                               \
+static CONV_ATTR void CONV_NAME( float2##_out##_sat )( void *out, void *in, size_t n )         \
+{                                                                                               \
+    cl_##_out *o = (cl_##_out*) out;                                                            \
+    cl_float *s = (cl_float*) in;                                                               \
+    size_t i;                                                                                   \
+    for( i = 0; i + CONV_WIDTH <= n; i += CONV_WIDTH )                                          \
+    {                                                                                           \
+        CONV_VF f = CONV_LOADF( s + i );                                                        \
+        CONV_V x = CONV_RINT( f );                                                              \
+        CONV_V r = CONV_CLAMP( x, _lo, _hi );                                                   \
+        _store( o + i, r );                                                                     \
+    }                                                                                           \
+    for( ; i < n; i++ )                                                                         \
+        float2##_out##_sat( o + i, s + i );                                                     \
+}
+
+#define CONV_CLAMP( _x, _lo, _hi )  CONV_MIN( CONV_MAX( _x, CONV_SPLAT( _lo ) ), CONV_SPLAT( _hi ) )
+
+CONV_FROM_INT( int, uchar,  ,       CONV_STORE8,    x )
+CONV_FROM_INT( int, char,   ,       CONV_STORE8,    x )
+CONV_FROM_INT( int, ushort, ,       CONV_STORE16,   x )
+CONV_FROM_INT( int, short,  ,       CONV_STORE16,   x )
+CONV_FROM_INT( int, uint,   ,       CONV_STORE32,   x )
+CONV_FROM_INT( int, float,  ,       CONV_STOREF,    x )
+CONV_FROM_INT( int, double, ,       CONV_STORED,    x )
+CONV_FROM_INT( int, ulong,  ,       CONV_STORE64,   x )
+CONV_FROM_INT( int, long,   ,       CONV_STORE64,   x )
+CONV_FROM_INT( int, uchar,  _sat,   CONV_STORE8,    CONV_CLAMP( x, 0, CL_UCHAR_MAX ) )
+CONV_FROM_INT( int, char,   _sat,   CONV_STORE8,    CONV_CLAMP( x, CL_CHAR_MIN, CL_CHAR_MAX ) )
+CONV_FROM_INT( int, ushort, _sat,   CONV_STORE16,   CONV_CLAMP( x, 0, CL_USHRT_MAX ) )
+CONV_FROM_INT( int, short,  _sat,   CONV_STORE16,   CONV_CLAMP( x, CL_SHRT_MIN, CL_SHRT_MAX ) )
+CONV_FROM_INT( int, uint,   _sat,   CONV_STORE32,   CONV_MAX( x, CONV_SPLAT( 0 ) ) )
+CONV_FROM_INT( int, float,  _sat,   CONV_STOREF,    x )
+CONV_FROM_INT( int, double, _sat,   CONV_STORED,    x )
+CONV_FROM_INT( int, ulong,  _sat,   CONV_STORE64,   CONV_MAX( x, CONV_SPLAT( 0 ) ) )
+CONV_FROM_INT( int, long,   _sat,   CONV_STORE64,   x )
+
+CONV_FROM_INT( uint, uchar,  ,      CONV_STORE8,    x )
+CONV_FROM_INT( uint, char,   ,      CONV_STORE8,    x )
+CONV_FROM_INT( uint, ushort, ,      CONV_STORE16,   x )
+CONV_FROM_INT( uint, short,  ,      CONV_STORE16,   x )
+CONV_FROM_INT( uint, int,    ,      CONV_STORE32,   x )
+CONV_FROM_INT( uint, float,  ,      CONV_STOREUF,   x )
+CONV_FROM_INT( uint, double, ,      CONV_STOREUD,   x )
+CONV_FROM_INT( uint, ulong,  ,      CONV_STOREU64,  x )
+CONV_FROM_INT( uint, long,   ,      CONV_STOREU64,  x )
+CONV_FROM_INT( uint, uchar,  _sat,  CONV_STORE8,    CONV_MINU( x, CONV_SPLAT( CL_UCHAR_MAX ) ) )
+CONV_FROM_INT( uint, char,   _sat,  CONV_STORE8,    CONV_MINU( x, CONV_SPLAT( CL_CHAR_MAX ) ) )
+CONV_FROM_INT( uint, ushort, _sat,  CONV_STORE16,   CONV_MINU( x, CONV_SPLAT( CL_USHRT_MAX ) ) )
+CONV_FROM_INT( uint, short,  _sat,  CONV_STORE16,   CONV_MINU( x, CONV_SPLAT( CL_SHRT_MAX ) ) )
+CONV_FROM_INT( uint, int,    _sat,  CONV_STORE32,   CONV_MINU( x, CONV_SPLAT( CL_INT_MAX ) ) )
+CONV_FROM_INT( uint, float,  _sat,  CONV_STOREUF,   x )
+CONV_FROM_INT( uint, double, _sat,  CONV_STOREUD,   x )
+CONV_FROM_INT( uint, ulong,  _sat,  CONV_STOREU64,  x )
+CONV_FROM_INT( uint, long,   _sat,  CONV_STOREU64,  x )
+
+// Only the saturated conversions from float. The others are undefined out of range.
+CONV_FROM_FLOAT( uchar,  CONV_STORE8,   0,              CL_UCHAR_MAX )
+CONV_FROM_FLOAT( char,   CONV_STORE8,   CL_CHAR_MIN,    CL_CHAR_MAX )
+CONV_FROM_FLOAT( ushort, CONV_STORE16,  0,              CL_USHRT_MAX )
+CONV_FROM_FLOAT( short,  CONV_STORE16,  CL_SHRT_MIN,    CL_SHRT_MAX )
+CONV_FROM_FLOAT( int,    CONV_STORE32,  CL_INT_MIN,     CL_INT_MAX )
+
+static const VectorConversion CONV_NAME( gVectorConversions )[] = {
+    { kuchar,   kint,   0,  CONV_NAME( int2uchar ) },
+    { kchar,    kint,   0,  CONV_NAME( int2char ) },
+    { kushort,  kint,   0,  CONV_NAME( int2ushort ) },
+    { kshort,   kint,   0,  CONV_NAME( int2short ) },
+    { kuint,    kint,   0,  CONV_NAME( int2uint ) },
+    { kfloat,   kint,   0,  CONV_NAME( int2float ) },
+    { kdouble,  kint,   0,  CONV_NAME( int2double ) },
+    { kulong,   kint,   0,  CONV_NAME( int2ulong ) },
+    { klong,    kint,   0,  CONV_NAME( int2long ) },
+    { kuchar,   kint,   1,  CONV_NAME( int2uchar_sat ) },
+    { kchar,    kint,   1,  CONV_NAME( int2char_sat ) },
+    { kushort,  kint,   1,  CONV_NAME( int2ushort_sat ) },
+    { kshort,   kint,   1,  CONV_NAME( int2short_sat ) },
+    { kuint,    kint,   1,  CONV_NAME( int2uint_sat ) },
+    { kfloat,   kint,   1,  CONV_NAME( int2float_sat ) },
+    { kdouble,  kint,   1,  CONV_NAME( int2double_sat ) },
+    { kulong,   kint,   1,  CONV_NAME( int2ulong_sat ) },
+    { klong,    kint,   1,  CONV_NAME( int2long_sat ) },
+    { kuchar,   kuint,  0,  CONV_NAME( uint2uchar ) },
+    { kchar,    kuint,  0,  CONV_NAME( uint2char ) },
+    { kushort,  kuint,  0,  CONV_NAME( uint2ushort ) },
+    { kshort,   kuint,  0,  CONV_NAME( uint2short ) },
+    { kint,     kuint,  0,  CONV_NAME( uint2int ) },
+    { kfloat,   kuint,  0,  CONV_NAME( uint2float ) },
+    { kdouble,  kuint,  0,  CONV_NAME( uint2double ) },
+    { kulong,   kuint,  0,  CONV_NAME( uint2ulong ) },
+    { klong,    kuint,  0,  CONV_NAME( uint2long ) },
+    { kuchar,   kuint,  1,  CONV_NAME( uint2uchar_sat ) },
+    { kchar,    kuint,  1,  CONV_NAME( uint2char_sat ) },
+    { kushort,  kuint,  1,  CONV_NAME( uint2ushort_sat ) },
+    { kshort,   kuint,  1,  CONV_NAME( uint2short_sat ) },
+    { kint,     kuint,  1,  CONV_NAME( uint2int_sat ) },
+    { kfloat,   kuint,  1,  CONV_NAME( uint2float_sat ) },
+    { kdouble,  kuint,  1,  CONV_NAME( uint2double_sat ) },
+    { kulong,   kuint,  1,  CONV_NAME( uint2ulong_sat ) },
+    { klong,    kuint,  1,  CONV_NAME( uint2long_sat ) },
+    { kuchar,   kfloat, 1,  CONV_NAME( float2uchar_sat ) },
+    { kchar,    kfloat, 1,  CONV_NAME( float2char_sat ) },
+    { kushort,  kfloat, 1,  CONV_NAME( float2ushort_sat ) },
+    { kshort,   kfloat, 1,  CONV_NAME( float2short_sat ) },
+    { kint,     kfloat, 1,  CONV_NAME( float2int_sat ) },
+    { kuchar,   kuchar, 0,  NULL }
+};
+
+#undef CONV_FROM_INT
+#undef CONV_FROM_FLOAT
+#undef CONV_CLAMP
@@ -41,6 +41,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #if !defined(_WIN32)
 #include <libgen.h>
 #include <sys/mman.h>
@@ -110,6 +111,7 @@ const int       vectorSizes[] = { 1, 1, 2, 3, 4, 8, 16 };
 int             gMinVectorSize = 0;
 int             gMaxVectorSize = sizeof(vectorSizes) / sizeof( vectorSizes[0] );
 static MTdata   gMTdata;
+static MTdata   *gThreadMTdata = NULL;
 
 #pragma mark -
 #pragma mark Declarations
@@ -120,6 +122,7 @@ static void PrintArch(void);
 test_status InitCL( cl_device_id device );
 static int GetTestCase( const char *name, Type *outType, Type *inType, SaturationMode *sat, RoundingMode *round );
 static int DoTest( cl_device_id device, Type outType, Type inType, SaturationMode sat, RoundingMode round, MTdata d );
+static void GetProgramSource( Type outType, Type inType, SaturationMode sat, RoundingMode round, int vectorSize, std::string &source, char testName[256], char description[256] );
 static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat, RoundingMode round, int vectorSize, cl_kernel *outKernel );
 static int RunKernel( cl_kernel kernel, void *inBuf, void *outBuf, size_t blockCount );
 
@@ -314,6 +317,9 @@ int main (int argc, const char **argv )
     _controlfp_s(&ignored, _PC_64, _MCW_PC);
 #endif
 
+    // Not fatal. The scalar conversions are used if the vector ones do not match them.
+    InitVectorConversions();
+
     vlog( "===========================================================\n" );
     vlog( "Random seed: %u\n", seed );
     gMTdata = init_genrand( seed );
@@ -322,6 +328,12 @@ int main (int argc, const char **argv )
     int ret = runTestHarnessWithCheck( 1, arg, test_num, test_list, false, true, 0, InitCL );
 
     free_mtdata( gMTdata );
+    if( gThreadMTdata )
+    {
+        for( cl_uint i = 0; i < GetThreadCount(); i++ )
+            free_mtdata( gThreadMTdata[i] );
+        free( gThreadMTdata );
+    }
 
     error = clFinish(gQueue);
     if (error)
@@ -339,6 +351,7 @@ int main (int argc, const char **argv )
         clReleaseMemObject(gOutBuffers[i]);
     }
     clReleaseCommandQueue(gQueue);
+    release_program_cache();
     clReleaseContext(gContext);
 
     return ret;
@@ -961,6 +974,27 @@ cl_int InitData( cl_uint job_id, cl_uint thread_id, void *p )
     return CL_SUCCESS;
 }
 
+typedef struct BuildKernelInfo
+{
+    Type                    outType;
+    Type                    inType;
+    SaturationMode          sat;
+    RoundingMode            round;
+    WriteInputBufferInfo    *info;
+}BuildKernelInfo;
+
+// Builds the program and kernel for one vector size. Run from ThreadPool_Do, so the vector sizes compile in parallel.
+cl_int BuildKernelFn( cl_uint job_id, cl_uint thread_id, void *p );
+cl_int BuildKernelFn( cl_uint job_id, cl_uint thread_id, void *p )
+{
+    BuildKernelInfo *build = (BuildKernelInfo*) p;
+    cl_uint vectorSize = gMinVectorSize + job_id;
+    CalcReferenceValuesInfo *calcInfo = &build->info->calcInfo[vectorSize];
+
+    calcInfo->program = MakeProgram( build->outType, build->inType, build->sat, build->round, vectorSize, &calcInfo->kernel );
+    return CL_SUCCESS;
+}
+
 static void setAllowZ(uint8_t *allow, uint32_t *x, cl_uint count)
 {
     cl_uint i;
@@ -1101,7 +1135,7 @@ static int DoTest( cl_device_id device, Type outType, Type inType, SaturationMod
     int vectorSize;
     int error = 0;
     cl_uint threads = GetThreadCount();
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
 
     gTestCount++;
     size_t blockCount = BUFFER_SIZE / MAX( gTypeSizes[ inType ], gTypeSizes[ outType ] );
@@ -1110,29 +1144,57 @@ static int DoTest( cl_device_id device, Type outType, Type inType, SaturationMod
     cl_event writeInputBuffer = NULL;
 
     memset( &writeInputBufferInfo, 0, sizeof( writeInputBufferInfo ) );
-    init_info.d = (MTdata*)malloc( threads * sizeof( MTdata ) );
-    if( NULL == init_info.d )
+    // One generator per thread, made once with jump ahead so their sequences never overlap
+    if( NULL == gThreadMTdata )
     {
-        vlog_error( "ERROR: Unable to allocate storage for random number generator!\n" );
-        return -1;
-    }
-    for( i = 0; i < threads; i++ )
-    {
-        init_info.d[i] = init_genrand( genrand_int32( d ) );
-        if( NULL == init_info.d[i] )
+        gThreadMTdata = (MTdata*)calloc( threads, sizeof( MTdata ) );
+        if( NULL == gThreadMTdata || init_genrand_streams( genrand_int32( d ), gThreadMTdata, threads ) )
         {
             vlog_error( "ERROR: Unable to allocate storage for random number generator!\n" );
+            free( gThreadMTdata );
+            gThreadMTdata = NULL;
             return -1;
         }
     }
+    init_info.d = gThreadMTdata;
 
     writeInputBufferInfo.outType = outType;
     writeInputBufferInfo.inType = inType;
 
+    // With an offline compiler, compile the programs for all vector sizes in one batch up front, so
+    // the builds below find the compiler output ready
+    if( gCompilationMode != kOnline )
+    {
+        std::string sources[ kCallStyleCount ];
+        const char *lines[ kCallStyleCount ];
+        const char **programs[ kCallStyleCount ];
+        const char *options[ kCallStyleCount ];
+        unsigned int lineCounts[ kCallStyleCount ];
+        char testName[256], description[256];
+        unsigned int programCount = 0;
+
+        for( vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++, programCount++ )
+        {
+            GetProgramSource( outType, inType, sat, round, vectorSize, sources[ programCount ], testName, description );
+            lines[ programCount ] = sources[ programCount ].c_str();
+            programs[ programCount ] = &lines[ programCount ];
+            options[ programCount ] = gForceFTZ ? "-cl-denorms-are-zero" : NULL;
+            lineCounts[ programCount ] = 1;
+        }
+
+        if( (error = compile_offline_programs( gContext, programCount, lineCounts, programs, options )) )
+        {
+            vlog_error( "ERROR: Offline compilation of the %s -> %s programs failed (%d)\n", gTypeNames[ inType ], gTypeNames[ outType ], error );
+            gFailCount++;
+            return error;
+        }
+    }
+
+    BuildKernelInfo buildInfo = { outType, inType, sat, round, &writeInputBufferInfo };
+    ThreadPool_Do( BuildKernelFn, gMaxVectorSize - gMinVectorSize, &buildInfo );
+
     for( vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
     {
-        writeInputBufferInfo.calcInfo[vectorSize].program = MakeProgram( outType, inType, sat, round, vectorSize,
-                                                                        &writeInputBufferInfo.calcInfo[vectorSize].kernel );
         if( NULL == writeInputBufferInfo.calcInfo[vectorSize].program )
         {
             gFailCount++;
@@ -1169,9 +1231,14 @@ static int DoTest( cl_device_id device, Type outType, Type inType, SaturationMod
 
     if ( gWimpyMode )
         step = (size_t)blockCount * (size_t)gWimpyReductionFactor;
+    // With --shard, only run this process' part of the blocks
+    get_shard_range( (lastCase + step - 1) / step, &shardBegin, &shardEnd );
+    shardBegin *= step;
+    shardEnd = MIN( shardEnd * step, lastCase );
+
     vlog( "Testing... " );
     fflush(stdout);
-    for( i = 0; i < (uint64_t)lastCase; i += step )
+    for( i = shardBegin; i < shardEnd; i += step )
     {
 
         if( 0 == ( i & ((lastCase >> 3) -1))) {
@@ -1427,13 +1494,9 @@ exit:
         clReleaseProgram( writeInputBufferInfo.calcInfo[vectorSize].program );
         clReleaseKernel( writeInputBufferInfo.calcInfo[vectorSize].kernel );
     }
-
-    if( init_info.d )
-    {
-        for( i = 0; i < threads; i++ )
-            free_mtdata(init_info.d[i]);
-        free(init_info.d);
-    }
+    // No other test uses these programs, so don't hold on to them. CL_PROGRAM_CACHE still keeps
+    // the binaries for the next run.
+    release_program_cache();
 
     return error;
 }
@@ -1652,13 +1715,14 @@ void CL_CALLBACK CalcReferenceValuesComplete( cl_event e, cl_int status, void *d
     // all the calls to CalcReferenceValuesComplete exit.
 }
 
-static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat, RoundingMode round, int vectorSize, cl_kernel *outKernel )
+// Writes the source of the program for one conversion to source, its kernel name to testName and
+// what it tests (for the log) to description
+static void GetProgramSource( Type outType, Type inType, SaturationMode sat, RoundingMode round, int vectorSize,
+                              std::string &source, char testName[256], char description[256] )
 {
-    cl_program program;
-    char testName[256];
-    int error = 0;
     const char **strings;
     size_t stringCount = 0;
+    size_t i;
 
     // Create the program. This is a bit complicated because we are trying to avoid byte and short stores.
     if (0 == vectorSize)
@@ -1684,8 +1748,10 @@ static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat,
         strncpy(inName, gTypeNames[inType], sizeof(inName));
         strncpy(outName, gTypeNames[outType], sizeof(outName));
         sprintf(testName, "test_implicit_%s_%s", outName, inName);
-        vlog("Building implicit %s -> %s conversion test\n", gTypeNames[inType], gTypeNames[outType]);
-        fflush(stdout);
+        snprintf(description, 256, "implicit %s -> %s conversion", gTypeNames[inType], gTypeNames[outType]);
+
+        for (i = 0; i < stringCount; i++)
+            source += strings[i];
     }
     else
     {
@@ -1742,26 +1808,43 @@ static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat,
             strncpy(outName, gTypeNames[outType], sizeof(outName));
             snprintf(convertString, sizeof(convertString), "convert_%s%s%s", outName, gSaturationNames[sat], gRoundingModeNames[round]);
             snprintf(testName, 256, "test_%s_%s", convertString, inName);
-            vlog("Building %s( %s ) test\n", convertString, inName);
+            snprintf(description, 256, "%s( %s )", convertString, inName);
             break;
         case 3:
             strncpy(inName, gTypeNames[inType], sizeof(inName));
             strncpy(outName, gTypeNames[outType], sizeof(outName));
             snprintf(convertString, sizeof(convertString), "convert_%s3%s%s", outName, gSaturationNames[sat], gRoundingModeNames[round]);
             snprintf(testName, 256, "test_%s_%s3", convertString, inName);
-            vlog("Building %s( %s3 ) test\n", convertString, inName);
+            snprintf(description, 256, "%s( %s3 )", convertString, inName);
             break;
         default:
             snprintf(inName, sizeof(inName), "%s%d", gTypeNames[inType], vectorSizetmp);
             snprintf(outName, sizeof(outName), "%s%d", gTypeNames[outType], vectorSizetmp);
             snprintf(convertString, sizeof(convertString), "convert_%s%s%s", outName, gSaturationNames[sat], gRoundingModeNames[round]);
             snprintf(testName, 256, "test_%s_%s", convertString, inName);
-            vlog("Building %s( %s ) test\n", convertString, inName);
+            snprintf(description, 256, "%s( %s )", convertString, inName);
             break;
         }
 
-        fflush(stdout);
+        for (i = 0; i < stringCount; i++)
+            source += strings[i];
     }
+}
+
+static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat, RoundingMode round, int vectorSize, cl_kernel *outKernel )
+{
+    cl_program program = NULL;
+    char testName[256];
+    char description[256];
+    std::string source;
+    int error = 0;
+
+    GetProgramSource( outType, inType, sat, round, vectorSize, source, testName, description );
+    vlog("Building %s test\n", description);
+    fflush(stdout);
+
+    const char *strings[] = { source.c_str() };
+
     *outKernel = NULL;
 
     const char *flags = NULL;
@@ -1769,13 +1852,12 @@ static cl_program   MakeProgram( Type outType, Type inType, SaturationMode sat,
         flags = "-cl-denorms-are-zero";
 
     // build it
-    error = create_single_kernel_helper(gContext, &program, outKernel, (cl_uint)stringCount, strings, testName, flags);
+    error = create_single_kernel_helper_cached(gContext, &program, outKernel, 1, strings, testName, flags);
     if (error)
     {
-        char    buffer[2048] = "";
-
-        vlog_error("Failed to build kernel/program.\n", error);
-        clReleaseProgram(program);
+        vlog_error("Failed to build kernel/program. (%d)\n", error);
+        if (program)
+            clReleaseProgram(program);
         return NULL;
     }
 
@@ -239,6 +239,7 @@ int test_copy_image_set_2D_2D_array( cl_device_id device, cl_context context, cl
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     if( gTestSmallImages )
     {
@@ -34,15 +34,14 @@ size_t random_in_ranges( size_t minimum, size_t rangeA, size_t rangeB, MTdata d
 
 static void CL_CALLBACK free_pitch_buffer( cl_mem image, void *buf )
 {
-    free( buf );
+    align_free( buf );
 }
 
 cl_mem create_image( cl_context context, cl_command_queue queue, BufferOwningPtr<char>& data, image_descriptor *imageInfo, int *error )
 {
     cl_mem img;
     cl_image_desc imageDesc;
-    cl_mem_flags mem_flags = CL_MEM_READ_ONLY;
-    void *host_ptr = NULL;
+    size_t hostBytes = 0;
 
     memset(&imageDesc, 0x0, sizeof(cl_image_desc));
     imageDesc.image_type = imageInfo->type;
@@ -59,32 +58,27 @@ cl_mem create_image( cl_context context, cl_command_queue queue, BufferOwningPtr
         case CL_MEM_OBJECT_IMAGE1D:
             if ( gDebugTrace )
                 log_info( " - Creating 1D image %d ...\n", (int)imageInfo->width );
-            if ( gEnablePitch )
-                host_ptr = malloc( imageInfo->rowPitch );
+            hostBytes = imageInfo->rowPitch;
             break;
         case CL_MEM_OBJECT_IMAGE2D:
             if ( gDebugTrace )
                 log_info( " - Creating 2D image %d by %d ...\n", (int)imageInfo->width, (int)imageInfo->height );
-            if ( gEnablePitch )
-                host_ptr = malloc( imageInfo->height * imageInfo->rowPitch );
+            hostBytes = imageInfo->height * imageInfo->rowPitch;
             break;
         case CL_MEM_OBJECT_IMAGE3D:
             if ( gDebugTrace )
                 log_info( " - Creating 3D image %d by %d by %d...\n", (int)imageInfo->width, (int)imageInfo->height, (int)imageInfo->depth );
-            if ( gEnablePitch )
-                host_ptr = malloc( imageInfo->depth * imageInfo->slicePitch );
+            hostBytes = imageInfo->depth * imageInfo->slicePitch;
             break;
         case CL_MEM_OBJECT_IMAGE1D_ARRAY:
             if ( gDebugTrace )
                 log_info( " - Creating 1D image array %d by %d...\n", (int)imageInfo->width, (int)imageInfo->arraySize );
-            if ( gEnablePitch )
-                host_ptr = malloc( imageInfo->arraySize * imageInfo->slicePitch );
+            hostBytes = imageInfo->arraySize * imageInfo->slicePitch;
             break;
         case CL_MEM_OBJECT_IMAGE2D_ARRAY:
             if ( gDebugTrace )
                 log_info( " - Creating 2D image array %d by %d by %d...\n", (int)imageInfo->width, (int)imageInfo->height, (int)imageInfo->arraySize );
-            if ( gEnablePitch )
-                host_ptr = malloc( imageInfo->arraySize * imageInfo->slicePitch );
+            hostBytes = imageInfo->arraySize * imageInfo->slicePitch;
             break;
     }
 
@@ -93,32 +87,34 @@ cl_mem create_image( cl_context context, cl_command_queue queue, BufferOwningPtr
 
     if (gEnablePitch)
     {
+        // CPU runtimes only use the host pointer in place if it starts on a page
+        size_t alignment = get_min_alignment( context );
+        if ( alignment < 4096 )
+            alignment = 4096;
+        void *host_ptr = align_malloc( hostBytes, alignment );
         if ( NULL == host_ptr )
         {
-            log_error( "ERROR: Unable to create backing store for pitched 3D image. %ld bytes\n",  imageInfo->depth * imageInfo->slicePitch );
+            log_error( "ERROR: Unable to create backing store for pitched image. %ld bytes\n", (long)hostBytes );
             return NULL;
         }
-        mem_flags = CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR;
-    }
-
-    img = clCreateImage(context, mem_flags, imageInfo->format, &imageDesc, host_ptr, error);
 
-    if (gEnablePitch)
-    {
+        img = clCreateImage(context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, imageInfo->format, &imageDesc, host_ptr, error);
         if ( *error == CL_SUCCESS )
         {
             int callbackError = clSetMemObjectDestructorCallback( img, free_pitch_buffer, host_ptr );
             if ( CL_SUCCESS != callbackError )
             {
-                free( host_ptr );
-                log_error( "ERROR: Unable to attach destructor callback to pitched 3D image. Err: %d\n", callbackError );
+                align_free( host_ptr );
+                log_error( "ERROR: Unable to attach destructor callback to pitched image. Err: %d\n", callbackError );
                 clReleaseMemObject( img );
                 return NULL;
             }
         }
         else
-            free(host_ptr);
+            align_free( host_ptr );
     }
+    else
+        img = clCreateImage(context, CL_MEM_READ_ONLY, imageInfo->format, &imageDesc, NULL, error);
 
     if ( *error != CL_SUCCESS )
     {
@@ -571,6 +567,12 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
         }
     }
 
+    // Compare all the scanlines in parallel first; the loop below only runs to report a mismatch
+    size_t mappedRowStep = ( dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY || dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D ) ? mappedSlice : mappedRow;
+    if( compare_image_rows( sourcePtr, rowPitch, slicePitch, destPtr, mappedRowStep, mappedSlice,
+                            scanlineSize, secondDim, thirdDim ) == secondDim * thirdDim )
+        thirdDim = 0;
+
     for( size_t z = 0; z < thirdDim; z++ )
     {
         for( size_t y = 0; y < secondDim; y++ )
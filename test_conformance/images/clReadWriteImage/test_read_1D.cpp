@@ -188,6 +188,7 @@ int test_read_image_set_1D( cl_device_id device, cl_context context, cl_command_
   if (memSize > (cl_ulong)SIZE_MAX) {
     memSize = (cl_ulong)SIZE_MAX;
   }
+  apply_image_memory_budget( &maxAllocSize, &memSize );
 
     if( gTestSmallImages )
     {
@@ -183,6 +183,7 @@ int test_get_image_info_2D_array( cl_device_id device, cl_context context, cl_co
   if (memSize > (cl_ulong)SIZE_MAX) {
     memSize = (cl_ulong)SIZE_MAX;
   }
+  apply_image_memory_budget( &maxAllocSize, &memSize );
 
     if( gTestSmallImages )
     {
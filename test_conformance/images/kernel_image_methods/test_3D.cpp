@@ -44,6 +44,7 @@ int test_get_image_info_3D( cl_device_id device, cl_context context, cl_command_
   if (memSize > (cl_ulong)SIZE_MAX) {
     memSize = (cl_ulong)SIZE_MAX;
   }
+  apply_image_memory_budget( &maxAllocSize, &memSize );
 
     if( gTestSmallImages )
     {
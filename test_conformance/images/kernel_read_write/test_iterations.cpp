@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "validate_rows.h"
 #include <float.h>
 
 #if defined( __APPLE__ )
@@ -411,7 +412,8 @@ static void InitFloatCoords( image_descriptor *imageInfo, image_sampler_data *im
 #endif
 
 int validate_image_2D_depth_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, SampleImagePixelFloatFn sampleFn, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        size_t rowBegin, size_t rowEnd, size_t resultRowBegin)
 {
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
@@ -422,10 +424,10 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
     if( outputType == kFloat )
     {
         // Validate float results
-        float *resultPtr = (float *)(char *)resultValues;
+        float *resultPtr = (float *)(char *)resultValues + ( rowBegin - resultRowBegin ) * width_lod * 4;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-        for( size_t y = 0, j = 0; y < height_lod; y++ )
+        for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
         {
             for( size_t x = 0; x < width_lod; x++, j++ )
             {
@@ -449,9 +451,9 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                    imageSampler, expected, 0, &containsDenormals );
+                        maxPixel = sampleFn( imageValues, imageInfo,
+                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                             expected, 0, &containsDenormals, 0 );
 
                         float err1 = fabsf( resultPtr[0] - expected[0] );
                         // Clamp to the minimum absolute error for the format
@@ -468,9 +470,9 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                                 // max error needs to be adjusted
                                 maxErr1 += 4 * FLT_MIN;
 
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                             imageSampler, expected, 0, NULL );
+                                maxPixel = sampleFn( imageValues, imageInfo,
+                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                      expected, 0, NULL, 0 );
 
                                 err1 = fabsf( resultPtr[0] - expected[0] );
                             }
@@ -501,9 +503,9 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
 
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, expected, 0, &containsDenormals );
+                            maxPixel = sampleFn( imageValues, imageInfo,
+                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                             expected, 0, &containsDenormals, 0 );
 
                             float err1 = fabsf( resultPtr[0] - expected[0] );
                             float maxErr1 = MAX( maxErr * maxPixel.p[0], FLT_MIN );
@@ -516,9 +518,9 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                                 {
                                     maxErr1 += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                                    maxPixel = sampleFn( imageValues, imageInfo,
+                                                          xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                          expected, 0, NULL, 0 );
 
                                     err1 = fabsf( resultPtr[0] - expected[0] );
                                 }
@@ -533,9 +535,9 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
 
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
-                                temp = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                               imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/ );
+                                temp = sampleFn( imageValues, imageInfo,
+                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                        tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, 0 );
                                 log_error( "\tulps: %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
                                                     Ulp_Error( MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) + maxErr, MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) ) );
@@ -563,7 +565,8 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
 }
 
 int validate_image_2D_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, SampleImagePixelFloatFn sampleFn, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        size_t rowBegin, size_t rowEnd, size_t resultRowBegin)
 {
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
@@ -574,10 +577,10 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
     if( outputType == kFloat )
     {
         // Validate float results
-        float *resultPtr = (float *)(char *)resultValues;
+        float *resultPtr = (float *)(char *)resultValues + ( rowBegin - resultRowBegin ) * width_lod * 4;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-        for( size_t y = 0, j = 0; y < height_lod; y++ )
+        for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
         {
             for( size_t x = 0; x < width_lod; x++, j++ )
             {
@@ -603,13 +606,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
                         if ( gTestMipmaps )
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                 expected, 0, &containsDenormals, lod );
                         else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals );
+                            maxPixel = sampleFn( imageValues, imageInfo,
+                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                 expected, 0, &containsDenormals, 0 );
 
                         float err1 = fabsf( resultPtr[0] - expected[0] );
                         float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -640,13 +643,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                                 maxErr4 += 4 * FLT_MIN;
 
                                 if(gTestMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                          xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                          expected, 0, NULL,lod );
                                 else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                                    maxPixel = sampleFn( imageValues, imageInfo,
+                                                          xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                          expected, 0, NULL, 0 );
 
                                 err1 = fabsf( resultPtr[0] - expected[0] );
                                 err2 = fabsf( resultPtr[1] - expected[1] );
@@ -681,13 +684,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
                             if(gTestMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                 expected, 0, &containsDenormals, lod );
                             else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals );
+                                maxPixel = sampleFn( imageValues, imageInfo,
+                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                 expected, 0, &containsDenormals, 0 );
 
                             float err1 = fabsf( resultPtr[0] - expected[0] );
                             float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -711,13 +714,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                                     maxErr4 += 4 * FLT_MIN;
 
                                     if(gTestMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                              expected, 0, NULL, lod );
                                     else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL );
+                                        maxPixel = sampleFn( imageValues, imageInfo,
+                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                              expected, 0, NULL, 0 );
 
                                     err1 = fabsf( resultPtr[0] - expected[0] );
                                     err2 = fabsf( resultPtr[1] - expected[1] );
@@ -737,13 +740,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
                                 if( gTestMipmaps )
-                                     temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                     temp = sampleFn( imagePtr, imageInfo,
+                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                             tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                  else
-                                     temp = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/ );
+                                     temp = sampleFn( imageValues, imageInfo,
+                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                             tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, 0 );
                                 log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
                                                     Ulp_Error( resultPtr[1], expected[1] ),
@@ -771,10 +774,10 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
     else if( outputType == kUInt )
     {
         // Validate unsigned integer results
-        unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
+        unsigned int *resultPtr = (unsigned int *)(char *)resultValues + ( rowBegin - resultRowBegin ) * width_lod * 4;
         unsigned int expected[4];
         float error;
-        for( size_t y = 0, j = 0; y < height_lod ; y++ )
+        for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
         {
             for( size_t x = 0; x < width_lod ; x++, j++ )
             {
@@ -867,10 +870,10 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
     else
     {
         // Validate integer results
-        int *resultPtr = (int *)(char *)resultValues;
+        int *resultPtr = (int *)(char *)resultValues + ( rowBegin - resultRowBegin ) * width_lod * 4;
         int expected[4];
         float error;
-        for( size_t y = 0, j = 0; y < height_lod ; y++ )
+        for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
         {
             for( size_t x = 0; x < width_lod; x++, j++ )
             {
@@ -961,7 +964,8 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
 }
 
 int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, SampleImagePixelFloatFn sampleFn, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        size_t rowBegin, size_t rowEnd, size_t resultRowBegin)
 {
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
@@ -972,10 +976,10 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
     if( outputType == kFloat )
     {
         // Validate float results
-        float *resultPtr = (float *)(char *)resultValues;
+        float *resultPtr = (float *)(char *)resultValues + ( rowBegin - resultRowBegin ) * width_lod * 4;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-        for( size_t y = 0, j = 0; y < height_lod; y++ )
+        for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
         {
             for( size_t x = 0; x < width_lod; x++, j++ )
             {
@@ -1001,13 +1005,13 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
                         if ( gTestMipmaps )
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                 expected, 0, &containsDenormals, lod );
                         else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals );
+                            maxPixel = sampleFn( imageValues, imageInfo,
+                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                 expected, 0, &containsDenormals, 0 );
                         float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                         float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
                         float err3 = fabsf( sRGBmap( resultPtr[2] ) - sRGBmap( expected[2] ) );
@@ -1026,13 +1030,13 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                                 maxErr += 4 * FLT_MIN;
 
                                 if(gTestMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                          xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                          expected, 0, NULL,lod );
                                 else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                                    maxPixel = sampleFn( imageValues, imageInfo,
+                                                          xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                          expected, 0, NULL, 0 );
 
                                 err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                 err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -1067,13 +1071,13 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
                             if(gTestMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                 expected, 0, &containsDenormals, lod );
                             else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals );
+                                maxPixel = sampleFn( imageValues, imageInfo,
+                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                 expected, 0, &containsDenormals, 0 );
 
                             float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                             float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -1091,13 +1095,13 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                                     // max error needs to be adjusted
                                     maxErr += 4 * FLT_MIN;
                                     if(gTestMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                              expected, 0, NULL, lod );
                                     else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL );
+                                        maxPixel = sampleFn( imageValues, imageInfo,
+                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                              expected, 0, NULL, 0 );
 
                                     err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                     err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -1117,13 +1121,13 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
                                 if( gTestMipmaps )
-                                     temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                     temp = sampleFn( imagePtr, imageInfo,
+                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                             tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                  else
-                                     temp = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/ );
+                                     temp = sampleFn( imageValues, imageInfo,
+                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                             tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, 0 );
                                 log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
                                                     Ulp_Error( resultPtr[1], expected[1] ),
@@ -1445,9 +1449,17 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
 
     size_t nextLevelOffset = 0;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
+
+    // The image type and sampler are the same for every pixel, so look up the host sampling code once
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+
     for( size_t lod = 0; (gTestMipmaps && (lod < imageInfo->num_mip_levels))|| (!gTestMipmaps && lod < 1); lod ++)
     {
-        size_t resultValuesSize = width_lod * height_lod * get_explicit_type_size( outputType ) * 4;
+        // Results are read back and validated a slab of rows at a time, so the host never
+        // holds all of them
+        size_t resultRowSize = width_lod * get_explicit_type_size( outputType ) * 4;
+        size_t slabRows = get_image_slab_rows( resultRowSize, height_lod );
+        size_t resultValuesSize = slabRows * resultRowSize;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         float lod_float = (float)lod;
         char *imagePtr = (char *)imageValues + nextLevelOffset;
@@ -1475,7 +1487,11 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
 
             // Get results
             memset( resultValues, 0xff, resultValuesSize );
-            clEnqueueWriteBuffer( queue, results, CL_TRUE, 0, resultValuesSize, resultValues, 0, NULL, NULL );
+            for( size_t slab = 0; slab < height_lod; slab += slabRows )
+            {
+                size_t rows = height_lod - slab < slabRows ? height_lod - slab : slabRows;
+                clEnqueueWriteBuffer( queue, results, CL_TRUE, slab * resultRowSize, rows * resultRowSize, resultValues, 0, NULL, NULL );
+            }
 
             // Run the kernel
             threads[0] = (size_t)width_lod;
@@ -1486,27 +1502,35 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
             if( gDebugTrace )
                 log_info( "    reading results, %ld kbytes\n", (unsigned long)( width_lod * height_lod * get_explicit_type_size( outputType ) * 4 / 1024 ) );
 
-            error = clEnqueueReadBuffer( queue, results, CL_TRUE, 0, width_lod * height_lod * get_explicit_type_size( outputType ) * 4, resultValues, 0, NULL, NULL ); //XXX check
-            test_error( error, "Unable to read results from kernel" );
-            if( gDebugTrace )
-                log_info( "    results read\n" );
-
-            int retCode;
-            switch (imageInfo->format->image_channel_order) {
-            case CL_DEPTH:
-                retCode = validate_image_2D_depth_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
-                break;
-            case CL_sRGB:
-            case CL_sRGBx:
-            case CL_sRGBA:
-            case CL_sBGRA:
-                retCode = validate_image_2D_sRGB_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
-                break;
-            default:
-                retCode = validate_image_2D_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
+            for( size_t slab = 0; slab < height_lod; slab += slabRows )
+            {
+                size_t rows = height_lod - slab < slabRows ? height_lod - slab : slabRows;
+                error = clEnqueueReadBuffer( queue, results, CL_TRUE, slab * resultRowSize, rows * resultRowSize, resultValues, 0, NULL, NULL );
+                test_error( error, "Unable to read results from kernel" );
+                if( gDebugTrace && slab + rows == height_lod )
+                    log_info( "    results read\n" );
+
+                // Rows are checked in parallel; see validate_rows_in_parallel. The validation
+                // functions index resultValues from the first row of the slab.
+                ValidateRowsFn validate = [&]( size_t rowBegin, size_t rowEnd, int &tries, int &clamped ) -> int {
+                    rowBegin += slab;
+                    rowEnd += slab;
+                    switch (imageInfo->format->image_channel_order) {
+                    case CL_DEPTH:
+                        return validate_image_2D_depth_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, tries, clamped, imageSampler, sampleFn, imageInfo, lod, imagePtr, rowBegin, rowEnd, slab);
+                    case CL_sRGB:
+                    case CL_sRGBx:
+                    case CL_sRGBA:
+                    case CL_sBGRA:
+                        return validate_image_2D_sRGB_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, tries, clamped, imageSampler, sampleFn, imageInfo, lod, imagePtr, rowBegin, rowEnd, slab);
+                    default:
+                        return validate_image_2D_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, tries, clamped, imageSampler, sampleFn, imageInfo, lod, imagePtr, rowBegin, rowEnd, slab);
+                    }
+                };
+                int retCode = validate_rows_in_parallel( rows, numTries, numClamped, validate );
+                if (retCode)
+                    return retCode;
             }
-            if (retCode)
-                return retCode;
         }
         end:
         if ( gTestMipmaps )
@@ -1583,6 +1607,7 @@ int test_read_image_set_2D( cl_device_id device, cl_context context, cl_command_
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( outputType == kInt )
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "validate_rows.h"
 #include <float.h>
 
 #if defined( __APPLE__ )
@@ -452,6 +453,10 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
 
     size_t width_lod = imageInfo->width;
     size_t nextLevelOffset = 0;
+
+    // The image type and sampler are the same for every pixel, so look up the host sampling code once
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+
     for(int lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
         float lod_float = (float)lod;
@@ -496,17 +501,19 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
 
         // Validate results element by element
             char *imagePtr = imageValues + nextLevelOffset;
+        // Pixels are checked in parallel; see validate_rows_in_parallel
+        ValidateRowsFn validate = [&]( size_t rowBegin, size_t rowEnd, int &numTries, int &numClamped ) -> int {
                 /*
                  * FLOAT output type
                  */
         if(is_sRGBA_order(imageInfo->format->image_channel_order) && ( outputType == kFloat ))
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
             {
-                for( size_t x = 0, j = 0; x < width_lod; x++, j++ )
+                for( size_t x = rowBegin, j = rowBegin; x < rowEnd; x++, j++ )
                 {
                     // Step 1: go through and see if the results verify for the pixel
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
@@ -526,9 +533,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
 
                             // Try sampling the pixel, without flushing denormals.
                             int containsDenormals = 0;
-                            FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                            xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                            imageSampler, expected, 0, &containsDenormals, lod );
+                            FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                     xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                     expected, 0, &containsDenormals, lod );
 
                             float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                             float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -548,9 +555,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                     // max error needs to be adjusted
                                     maxErr += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL, lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                          xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                          expected, 0, NULL, lod );
 
                                     err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                     err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -580,9 +587,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                 }
 
                                 int containsDenormals = 0;
-                                FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                                 expected, 0, &containsDenormals, lod );
 
                                 float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                 float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -601,9 +608,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                         // max error needs to be adjusted
                                         maxErr += 4 * FLT_MIN;
 
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                              xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                              expected, 0, NULL, lod );
 
                                         err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                         err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -621,9 +628,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                                                         expected, error, xOffsetValues[ j ], norm_offset_x, j, numTries, numClamped, true, lod );
 
                                     log_error( "Step by step:\n" );
-                                    FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                        imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                    FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                                 tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                     log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                         Ulp_Error( resultPtr[0], expected[0] ),
                                                         Ulp_Error( resultPtr[1], expected[1] ),
@@ -647,11 +654,11 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
         else if( outputType == kFloat )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
             {
-                for( size_t x = 0, j = 0; x < width_lod; x++, j++ )
+                for( size_t x = rowBegin, j = rowBegin; x < rowEnd; x++, j++ )
                 {
                     // Step 1: go through and see if the results verify for the pixel
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
@@ -671,9 +678,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
 
                             // Try sampling the pixel, without flushing denormals.
                             int containsDenormals = 0;
-                            FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                            xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                            imageSampler, expected, 0, &containsDenormals, lod );
+                            FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                     xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                     expected, 0, &containsDenormals, lod );
 
                             float err1 = fabsf( resultPtr[0] - expected[0] );
                             float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -703,9 +710,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                     maxErr3 += 4 * FLT_MIN;
                                     maxErr4 += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL, lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                          xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                          expected, 0, NULL, lod );
 
                                     err1 = fabsf( resultPtr[0] - expected[0] );
                                     err2 = fabsf( resultPtr[1] - expected[1] );
@@ -735,9 +742,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                 }
 
                                 int containsDenormals = 0;
-                                FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                                 expected, 0, &containsDenormals, lod );
 
                                 float err1 = fabsf( resultPtr[0] - expected[0] );
                                 float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -760,9 +767,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                         maxErr3 += 4 * FLT_MIN;
                                         maxErr4 += 4 * FLT_MIN;
 
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                              xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                              expected, 0, NULL, lod );
 
                                         err1 = fabsf( resultPtr[0] - expected[0] );
                                         err2 = fabsf( resultPtr[1] - expected[1] );
@@ -780,9 +787,9 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                                                         expected, error, xOffsetValues[ j ], norm_offset_x, j, numTries, numClamped, true, lod );
 
                                     log_error( "Step by step:\n" );
-                                    FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
-                                                                                        imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                    FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                 xOffsetValues[ j ], 0.0f, 0.0f, norm_offset_x, 0.0f, 0.0f,
+                                                                 tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                     log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                         Ulp_Error( resultPtr[0], expected[0] ),
                                                         Ulp_Error( resultPtr[1], expected[1] ),
@@ -809,10 +816,10 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
         else if( outputType == kUInt )
         {
             // Validate unsigned integer results
-            unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
+            unsigned int *resultPtr = (unsigned int *)(char *)resultValues + rowBegin * 4;
             unsigned int expected[4];
             float error;
-            for( size_t x = 0, j = 0; x < width_lod; x++, j++ )
+            for( size_t x = rowBegin, j = rowBegin; x < rowEnd; x++, j++ )
             {
                     // Step 1: go through and see if the results verify for the pixel
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
@@ -896,10 +903,10 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
         else
         {
             // Validate integer results
-            int *resultPtr = (int *)(char *)resultValues;
+            int *resultPtr = (int *)(char *)resultValues + rowBegin * 4;
             int expected[4];
             float error;
-            for( size_t x = 0, j = 0; x < width_lod; x++, j++ )
+            for( size_t x = rowBegin, j = rowBegin; x < rowEnd; x++, j++ )
             {
                     // Step 1: go through and see if the results verify for the pixel
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
@@ -976,6 +983,11 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                     resultPtr += 4;
             }
         }
+        return 0;
+        };
+        int retCode = validate_rows_in_parallel( width_lod, numTries, numClamped, validate );
+        if( retCode )
+            return retCode;
         }
         {
             nextLevelOffset += width_lod * get_pixel_size(imageInfo->format);
@@ -1019,6 +1031,7 @@ int test_read_image_set_1D( cl_device_id device, cl_context context, cl_command_
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( outputType == kInt )
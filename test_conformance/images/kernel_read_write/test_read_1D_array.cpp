@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "validate_rows.h"
 #include <float.h>
 
 #if defined( __APPLE__ )
@@ -543,6 +544,10 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
     size_t width_lod = imageInfo->width;
     size_t nextLevelOffset = 0;
     char * imagePtr;
+
+    // The image type and sampler are the same for every pixel, so look up the host sampling code once
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+
     for(int lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
         size_t resultValuesSize = width_lod * imageInfo->arraySize * get_explicit_type_size( outputType ) * 4;
@@ -590,16 +595,18 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
 
         // Validate results element by element
         imagePtr = (char*)imageValues + nextLevelOffset;
+        // Array elements are checked in parallel; see validate_rows_in_parallel
+        ValidateRowsFn validate = [&]( size_t rowBegin, size_t rowEnd, int &numTries, int &numClamped ) -> int {
         /*
          * FLOAT output type, order= sRGB
          */
         if(is_sRGBA_order(imageInfo->format->image_channel_order) && ( outputType == kFloat ))
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-            for( size_t y = 0, j = 0; y < imageInfo->arraySize; y++ )
+            for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
             {
                 for( size_t x = 0; x < width_lod; x++, j++ )
                 {
@@ -623,9 +630,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
 
                             // Try sampling the pixel, without flushing denormals.
                             int containsDenormals = 0;
-                            FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                imageSampler, expected, 0, &containsDenormals, lod );
+                            FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+         expected, 0, &containsDenormals, lod );
 
                             float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                             float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -644,9 +651,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                     // max error needs to be adjusted
                                     maxErr += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                               imageSampler, expected, 0, NULL, lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                        expected, 0, NULL, lod );
 
                                     err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                     err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -679,9 +686,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                 }
 
                                 int containsDenormals = 0;
-                                FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                      imageSampler, expected, 0, &containsDenormals, lod );
+                                FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                               expected, 0, &containsDenormals, lod );
 
                                 float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                 float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -700,9 +707,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                         // max error needs to be adjusted
                                         maxErr += 4 * FLT_MIN;
 
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                   xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                   imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                            xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                            expected, 0, NULL, lod );
 
                                         err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                         err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -720,9 +727,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                                                                       expected, error, xOffsetValues[ j ], yOffsetValues[ j ], norm_offset_x, norm_offset_y, j, numTries, numClamped, true, lod );
 
                                     log_error( "Step by step:\n" );
-                                    FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                      imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                    FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                               tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                     log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                               Ulp_Error( resultPtr[0], expected[0] ),
                                               Ulp_Error( resultPtr[1], expected[1] ),
@@ -750,10 +757,10 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
         else if( outputType == kFloat )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-            for( size_t y = 0, j = 0; y < imageInfo->arraySize; y++ )
+            for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
             {
                 for( size_t x = 0; x < width_lod; x++, j++ )
                 {
@@ -777,9 +784,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
 
                             // Try sampling the pixel, without flushing denormals.
                             int containsDenormals = 0;
-                            FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                imageSampler, expected, 0, &containsDenormals, lod );
+                            FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+         expected, 0, &containsDenormals, lod );
 
                             float err1 = fabsf( resultPtr[0] - expected[0] );
                             float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -809,9 +816,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                     maxErr3 += 4 * FLT_MIN;
                                     maxErr4 += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                               imageSampler, expected, 0, NULL, lod );
+                                    maxPixel = sampleFn( imagePtr, imageInfo,
+                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                        expected, 0, NULL, lod );
 
                                     err1 = fabsf( resultPtr[0] - expected[0] );
                                     err2 = fabsf( resultPtr[1] - expected[1] );
@@ -844,9 +851,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                 }
 
                                 int containsDenormals = 0;
-                                FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                      imageSampler, expected, 0, &containsDenormals, lod );
+                                FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                               expected, 0, &containsDenormals, lod );
 
                                 float err1 = fabsf( resultPtr[0] - expected[0] );
                                 float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -869,9 +876,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                         maxErr3 += 4 * FLT_MIN;
                                         maxErr4 += 4 * FLT_MIN;
 
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                   xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                   imageSampler, expected, 0, NULL, lod );
+                                        maxPixel = sampleFn( imagePtr, imageInfo,
+                                                            xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                            expected, 0, NULL, lod );
 
                                         err1 = fabsf( resultPtr[0] - expected[0] );
                                         err2 = fabsf( resultPtr[1] - expected[1] );
@@ -889,9 +896,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                                                                                       expected, error, xOffsetValues[ j ], yOffsetValues[ j ], norm_offset_x, norm_offset_y, j, numTries, numClamped, true, lod );
 
                                     log_error( "Step by step:\n" );
-                                    FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                      imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
+                                    FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                               xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                               tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/, lod );
                                     log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                               Ulp_Error( resultPtr[0], expected[0] ),
                                               Ulp_Error( resultPtr[1], expected[1] ),
@@ -919,10 +926,10 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
         else if( outputType == kUInt )
         {
             // Validate unsigned integer results
-            unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
+            unsigned int *resultPtr = (unsigned int *)(char *)resultValues + rowBegin * width_lod * 4;
             unsigned int expected[4];
             float error;
-            for( size_t y = 0, j = 0; y < imageInfo->arraySize; y++ )
+            for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
             {
                 for( size_t x = 0; x < width_lod; x++, j++ )
                 {
@@ -1005,10 +1012,10 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
         else
         {
             // Validate integer results
-            int *resultPtr = (int *)(char *)resultValues;
+            int *resultPtr = (int *)(char *)resultValues + rowBegin * width_lod * 4;
             int expected[4];
             float error;
-            for( size_t y = 0, j = 0; y < imageInfo->arraySize; y++ )
+            for( size_t y = rowBegin, j = rowBegin * width_lod; y < rowEnd; y++ )
             {
                 for( size_t x = 0; x < width_lod; x++, j++ )
                 {
@@ -1085,6 +1092,11 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                 }
                 }
             }
+        return 0;
+        };
+        int retCode = validate_rows_in_parallel( imageInfo->arraySize, numTries, numClamped, validate );
+        if( retCode )
+            return retCode;
         }
         {
             nextLevelOffset += width_lod * imageInfo->arraySize * get_pixel_size(imageInfo->format);
@@ -1127,6 +1139,7 @@ int test_read_image_set_1D_array( cl_device_id device, cl_context context, cl_co
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( outputType == kInt )
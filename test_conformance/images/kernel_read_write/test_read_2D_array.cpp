@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "validate_rows.h"
 #include <float.h>
 
 #define MAX_ERR 0.005f
@@ -543,6 +544,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
     }
     size_t nextLevelOffset = 0;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
+
+    // The image type and sampler are the same for every pixel, so look up the host sampling code once
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+
     for( size_t lod = 0; (gTestMipmaps && (lod < imageInfo->num_mip_levels))|| (!gTestMipmaps && lod < 1); lod ++)
     {
         size_t resultValuesSize = width_lod * height_lod * imageInfo->arraySize * get_explicit_type_size( outputType ) * 4;
@@ -593,15 +598,17 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
 
         // Validate results element by element
         char *imagePtr = (char *)imageValues + nextLevelOffset;
+        // Array elements are checked in parallel; see validate_rows_in_parallel
+        ValidateRowsFn validate = [&]( size_t rowBegin, size_t rowEnd, int &numTries, int &numClamped ) -> int {
 
         if((imageInfo->format->image_channel_order == CL_DEPTH) && (outputType == kFloat) )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 1 /*3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
 
-            for( size_t z = 0, j = 0; z < imageInfo->arraySize; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -626,10 +633,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                 for (float norm_offset_z = -offset; norm_offset_z <= NORM_OFFSET && !found_pixel; norm_offset_z += NORM_OFFSET) {
 
                                     int hasDenormals = 0;
-                                    FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                          xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                          norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                          imageSampler, expected, 0, &hasDenormals, lod );
+                                    FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                   xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                   norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                   expected, 0, &hasDenormals, lod );
 
                                     float err1 = fabsf( resultPtr[0] - expected[0] );
                                     // Clamp to the minimum absolute error for the format
@@ -645,10 +652,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                             // max error needs to be adjusted
                                             maxErr1 += 4 * FLT_MIN;
 
-                                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                       imageSampler, expected, 0, NULL, lod );
+                                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                expected, 0, NULL, lod );
 
                                             err1 = fabsf( resultPtr[0] - expected[0] );
                                         }
@@ -670,10 +677,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                     for (float norm_offset_z = -offset; norm_offset_z <= offset && !checkOnlyOnePixel; norm_offset_z += NORM_OFFSET) {
 
                                         int hasDenormals = 0;
-                                        FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, expected, 0, &hasDenormals, lod );
+                                        FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       expected, 0, &hasDenormals, lod );
 
                                         float err1 = fabsf( resultPtr[0] - expected[0] );
                                         float maxErr1 = MAX( maxErr * maxPixel.p[0], FLT_MIN );
@@ -686,9 +693,9 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                             {
                                                 maxErr1 += 4 * FLT_MIN;
 
-                                                maxPixel = sample_image_pixel_float( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                    imageSampler, expected, 0, NULL, lod );
+                                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ], 0.0f, 0.0f, 0.0f,
+                                                                    expected, 0, NULL, lod );
 
                                                 err1 = fabsf( resultPtr[0] - expected[0] );
                                             }
@@ -704,10 +711,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                                                                                      norm_offset_x, norm_offset_y, norm_offset_z, j,
                                                                                                      numTries, numClamped, true, lod );
                                             log_error( "Step by step:\n" );
-                                            FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, tempOut, 1 /*verbose*/, &hasDenormals, lod);
+                                            FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       tempOut, 1 /*verbose*/, &hasDenormals, lod);
                                             log_error( "\tulps: %2.2f  (max allowed: %2.2f)\n\n",
                                                       Ulp_Error( resultPtr[0], expected[0] ),
                                                       Ulp_Error( MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) + maxErr, MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) ) );
@@ -732,11 +739,11 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
         else if(is_sRGBA_order(imageInfo->format->image_channel_order) && (outputType == kFloat) )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 1 /*3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
 
-            for( size_t z = 0, j = 0; z < imageInfo->arraySize; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -761,10 +768,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                 for (float norm_offset_z = -offset; norm_offset_z <= NORM_OFFSET && !found_pixel; norm_offset_z += NORM_OFFSET) {
 
                                     int hasDenormals = 0;
-                                    FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                          xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                          norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                          imageSampler, expected, 0, &hasDenormals, lod );
+                                    FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                   xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                   norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                   expected, 0, &hasDenormals, lod );
 
                                     float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                     float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -781,10 +788,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                             // max error needs to be adjusted
                                               maxErr += 4 * FLT_MIN;
 
-                                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                       imageSampler, expected, 0, NULL, lod );
+                                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                expected, 0, NULL, lod );
 
                                             err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                             err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -809,10 +816,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                     for (float norm_offset_z = -offset; norm_offset_z <= offset && !checkOnlyOnePixel; norm_offset_z += NORM_OFFSET) {
 
                                         int hasDenormals = 0;
-                                        FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, expected, 0, &hasDenormals, lod );
+                                        FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       expected, 0, &hasDenormals, lod );
 
                                         float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                         float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -829,9 +836,9 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                                 // max error needs to be adjusted
                                                 maxErr += 4 * FLT_MIN;
 
-                                                maxPixel = sample_image_pixel_float( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                    imageSampler, expected, 0, NULL, lod );
+                                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ], 0.0f, 0.0f, 0.0f,
+                                                                    expected, 0, NULL, lod );
 
                                                 err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                                 err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -850,10 +857,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                                                                                      norm_offset_x, norm_offset_y, norm_offset_z, j,
                                                                                                      numTries, numClamped, true, lod );
                                             log_error( "Step by step:\n" );
-                                            FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, tempOut, 1 /*verbose*/, &hasDenormals, lod);
+                                            FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       tempOut, 1 /*verbose*/, &hasDenormals, lod);
                                             log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                       Ulp_Error( resultPtr[0], expected[0] ),
                                                       Ulp_Error( resultPtr[1], expected[1] ),
@@ -881,11 +888,11 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
         else if( outputType == kFloat )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 1 /*3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
 
-            for( size_t z = 0, j = 0; z < imageInfo->arraySize; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -910,10 +917,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                 for (float norm_offset_z = -offset; norm_offset_z <= NORM_OFFSET && !found_pixel; norm_offset_z += NORM_OFFSET) {
 
                                     int hasDenormals = 0;
-                                    FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                          xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                          norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                          imageSampler, expected, 0, &hasDenormals, lod );
+                                    FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                   xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                   norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                   expected, 0, &hasDenormals, lod );
 
                                     float err1 = fabsf( resultPtr[0] - expected[0] );
                                     float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -941,10 +948,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                             maxErr3 += 4 * FLT_MIN;
                                             maxErr4 += 4 * FLT_MIN;
 
-                                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                       imageSampler, expected, 0, NULL, lod );
+                                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                expected, 0, NULL, lod );
 
                                             err1 = fabsf( resultPtr[0] - expected[0] );
                                             err2 = fabsf( resultPtr[1] - expected[1] );
@@ -969,10 +976,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                     for (float norm_offset_z = -offset; norm_offset_z <= offset && !checkOnlyOnePixel; norm_offset_z += NORM_OFFSET) {
 
                                         int hasDenormals = 0;
-                                        FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, expected, 0, &hasDenormals, lod );
+                                        FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       expected, 0, &hasDenormals, lod );
 
                                         float err1 = fabsf( resultPtr[0] - expected[0] );
                                         float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -994,9 +1001,9 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                                 maxErr3 += 4 * FLT_MIN;
                                                 maxErr4 += 4 * FLT_MIN;
 
-                                                maxPixel = sample_image_pixel_float( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                    imageSampler, expected, 0, NULL, lod );
+                                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ], 0.0f, 0.0f, 0.0f,
+                                                                    expected, 0, NULL, lod );
 
                                                 err1 = fabsf( resultPtr[0] - expected[0] );
                                                 err2 = fabsf( resultPtr[1] - expected[1] );
@@ -1015,10 +1022,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                                                                                                      norm_offset_x, norm_offset_y, norm_offset_z, j,
                                                                                                      numTries, numClamped, true, lod );
                                             log_error( "Step by step:\n" );
-                                            FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, tempOut, 1 /*verbose*/, &hasDenormals, lod);
+                                            FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       tempOut, 1 /*verbose*/, &hasDenormals, lod);
                                             log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                       Ulp_Error( resultPtr[0], expected[0] ),
                                                       Ulp_Error( resultPtr[1], expected[1] ),
@@ -1046,10 +1053,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
         else if( outputType == kUInt )
         {
             // Validate unsigned integer results
-            unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
+            unsigned int *resultPtr = (unsigned int *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             unsigned int expected[4];
             float error;
-            for( size_t z = 0, j = 0; z < imageInfo->arraySize; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -1154,10 +1161,10 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
          */
         {
             // Validate integer results
-            int *resultPtr = (int *)(char *)resultValues;
+            int *resultPtr = (int *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             int expected[4];
             float error;
-            for( size_t z = 0, j = 0; z < imageInfo->arraySize; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -1256,6 +1263,11 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
                 }
             }
         }
+        return 0;
+        };
+        int retCode = validate_rows_in_parallel( imageInfo->arraySize, numTries, numClamped, validate );
+        if( retCode )
+            return retCode;
         }
         {
             nextLevelOffset += width_lod * height_lod * imageInfo->arraySize * get_pixel_size(imageInfo->format);
@@ -1302,6 +1314,7 @@ int test_read_image_set_2D_array( cl_device_id device, cl_context context, cl_co
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( outputType == kInt )
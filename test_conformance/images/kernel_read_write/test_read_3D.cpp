@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "validate_rows.h"
 #include <float.h>
 
 #define MAX_ERR 0.005f
@@ -554,6 +555,9 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
     int nextLevelOffset = 0;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height, depth_lod = imageInfo->depth;
 
+    // The image type and sampler are the same for every pixel, so look up the host sampling code once
+    SampleImagePixelFloatFn sampleFn = get_sample_image_pixel_float_fn( imageInfo, imageSampler );
+
     //Loop over all mipmap levels, if we are testing mipmapped images.
     for(int lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
@@ -607,17 +611,19 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
 
         // Validate results element by element
         char *imagePtr = (char*)imageValues + nextLevelOffset;
+        // Slices are checked in parallel; see validate_rows_in_parallel
+        ValidateRowsFn validate = [&]( size_t rowBegin, size_t rowEnd, int &numTries, int &numClamped ) -> int {
         /*
          * FLOAT output type
          */
         if(is_sRGBA_order(imageInfo->format->image_channel_order) && (outputType == kFloat) )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 1 /*3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
 
-            for( size_t z = 0, j = 0; z < depth_lod; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -642,10 +648,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                 for (float norm_offset_z = -offset; norm_offset_z <= NORM_OFFSET && !found_pixel; norm_offset_z += NORM_OFFSET) {
 
                                     int hasDenormals = 0;
-                                    FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                          xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                          norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                          imageSampler, expected, 0, &hasDenormals, lod );
+                                    FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                   xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                   norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                   expected, 0, &hasDenormals, lod );
 
                                     float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                     float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -667,10 +673,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                             // max error needs to be adjusted
                                               maxErr += 4 * FLT_MIN;
 
-                                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                       imageSampler, expected, 0, NULL, lod );
+                                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                expected, 0, NULL, lod );
 
                                             err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                             err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -695,10 +701,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                     for (float norm_offset_z = -offset; norm_offset_z <= offset && !checkOnlyOnePixel; norm_offset_z += NORM_OFFSET) {
 
                                         int hasDenormals = 0;
-                                        FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, expected, 0, &hasDenormals, lod );
+                                        FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       expected, 0, &hasDenormals, lod );
 
                                         float err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                         float err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -715,9 +721,9 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                 // max error needs to be adjusted
                                                   maxErr += 4 * FLT_MIN;
 
-                                                maxPixel = sample_image_pixel_float( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                    imageSampler, expected, 0, NULL, lod );
+                                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ], 0.0f, 0.0f, 0.0f,
+                                                                    expected, 0, NULL, lod );
 
                                                 err1 = fabsf( sRGBmap( resultPtr[0] ) - sRGBmap( expected[0] ) );
                                                 err2 = fabsf( sRGBmap( resultPtr[1] ) - sRGBmap( expected[1] ) );
@@ -736,10 +742,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                                                                      norm_offset_x, norm_offset_y, norm_offset_z, j,
                                                                                                      numTries, numClamped, true, lod );
                                             log_error( "Step by step:\n" );
-                                            FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, tempOut, 1 /*verbose*/, &hasDenormals, lod);
+                                            FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       tempOut, 1 /*verbose*/, &hasDenormals, lod);
                                             log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                       Ulp_Error( resultPtr[0], expected[0] ),
                                                       Ulp_Error( resultPtr[1], expected[1] ),
@@ -767,11 +773,11 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
         else if( outputType == kFloat )
         {
             // Validate float results
-            float *resultPtr = (float *)(char *)resultValues;
+            float *resultPtr = (float *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             float expected[4], error=0.0f;
             float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 1 /*3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
 
-            for( size_t z = 0, j = 0; z < depth_lod; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -796,10 +802,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                 for (float norm_offset_z = -offset; norm_offset_z <= NORM_OFFSET && !found_pixel; norm_offset_z += NORM_OFFSET) {
 
                                     int hasDenormals = 0;
-                                    FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                          xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                          norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                          imageSampler, expected, 0, &hasDenormals, lod );
+                                    FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                   xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                   norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                   expected, 0, &hasDenormals, lod );
 
                                     float err1 = fabsf( resultPtr[0] - expected[0] );
                                     float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -827,10 +833,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                             maxErr3 += 4 * FLT_MIN;
                                             maxErr4 += 4 * FLT_MIN;
 
-                                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                       imageSampler, expected, 0, NULL, lod );
+                                            maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                expected, 0, NULL, lod );
 
                                             err1 = fabsf( resultPtr[0] - expected[0] );
                                             err2 = fabsf( resultPtr[1] - expected[1] );
@@ -855,10 +861,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                     for (float norm_offset_z = -offset; norm_offset_z <= offset && !checkOnlyOnePixel; norm_offset_z += NORM_OFFSET) {
 
                                         int hasDenormals = 0;
-                                        FloatPixel maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, expected, 0, &hasDenormals, lod );
+                                        FloatPixel maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       expected, 0, &hasDenormals, lod );
 
                                         float err1 = fabsf( resultPtr[0] - expected[0] );
                                         float err2 = fabsf( resultPtr[1] - expected[1] );
@@ -880,9 +886,9 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                 maxErr3 += 4 * FLT_MIN;
                                                 maxErr4 += 4 * FLT_MIN;
 
-                                                maxPixel = sample_image_pixel_float( imagePtr, imageInfo,
-                                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                    imageSampler, expected, 0, NULL, lod );
+                                                maxPixel = sampleFn( imagePtr, imageInfo,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ], 0.0f, 0.0f, 0.0f,
+                                                                    expected, 0, NULL, lod );
 
                                                 err1 = fabsf( resultPtr[0] - expected[0] );
                                                 err2 = fabsf( resultPtr[1] - expected[1] );
@@ -901,10 +907,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                                                                                                      norm_offset_x, norm_offset_y, norm_offset_z, j,
                                                                                                      numTries, numClamped, true, lod );
                                             log_error( "Step by step:\n" );
-                                            FloatPixel temp = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                              xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
-                                                                                              norm_offset_x, norm_offset_y, norm_offset_z,
-                                                                                              imageSampler, tempOut, 1 /*verbose*/, &hasDenormals, lod);
+                                            FloatPixel temp = sampleFn( imagePtr, imageInfo,
+                                                                       xOffsetValues[ j ], yOffsetValues[ j ], zOffsetValues[ j ],
+                                                                       norm_offset_x, norm_offset_y, norm_offset_z,
+                                                                       tempOut, 1 /*verbose*/, &hasDenormals, lod);
                                             log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                       Ulp_Error( resultPtr[0], expected[0] ),
                                                       Ulp_Error( resultPtr[1], expected[1] ),
@@ -932,10 +938,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
         else if( outputType == kUInt )
         {
             // Validate unsigned integer results
-            unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
+            unsigned int *resultPtr = (unsigned int *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             unsigned int expected[4];
             float error;
-            for( size_t z = 0, j = 0; z < depth_lod; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -1028,10 +1034,10 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
          */
         {
             // Validate integer results
-            int *resultPtr = (int *)(char *)resultValues;
+            int *resultPtr = (int *)(char *)resultValues + rowBegin * width_lod * height_lod * 4;
             int expected[4];
             float error;
-            for( size_t z = 0, j = 0; z < depth_lod; z++ )
+            for( size_t z = rowBegin, j = rowBegin * width_lod * height_lod; z < rowEnd; z++ )
             {
                 for( size_t y = 0; y < height_lod; y++ )
                 {
@@ -1118,6 +1124,11 @@ int test_read_image_3D( cl_context context, cl_command_queue queue, cl_kernel ke
                     }
                 }
             }
+        return 0;
+        };
+        int retCode = validate_rows_in_parallel( depth_lod, numTries, numClamped, validate );
+        if( retCode )
+            return retCode;
         }
         {
             nextLevelOffset += width_lod * height_lod * depth_lod * get_pixel_size(imageInfo->format);
@@ -1162,6 +1173,7 @@ int test_read_image_set_3D( cl_device_id device, cl_context context, cl_command_
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( outputType == kInt )
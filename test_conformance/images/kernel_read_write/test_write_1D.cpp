@@ -145,8 +145,7 @@ int test_write_image_1D( cl_device_id device, cl_context context, cl_command_que
                     // First, fill with arbitrary floats
                     {
                         float *inputValues = (float *)(char*)imageValues;
-                        for( size_t i = 0; i < imageInfo->width * 4; i++ )
-                            inputValues[ i ] = get_random_float( -0.1f, 1.1f, d );
+                        get_random_float_array( -0.1f, 1.1f, d, inputValues, imageInfo->width * 4 );
                     }
 
                     // Throw a few extra test values in there
@@ -565,6 +564,7 @@ int test_write_image_1D_set( cl_device_id device, cl_context context, cl_command
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( inputType == kInt )
@@ -155,8 +155,7 @@ int test_write_image_1D_array( cl_device_id device, cl_context context, cl_comma
                     for( size_t y = 0; y < imageInfo->arraySize; y++ )
                     {
                         float *inputValues = (float *)(char*)imageValues + y * imageInfo->width * 4;
-                        for( size_t i = 0; i < imageInfo->width * 4; i++ )
-                            inputValues[ i ] = get_random_float( -0.1f, 1.1f, d );
+                        get_random_float_array( -0.1f, 1.1f, d, inputValues, imageInfo->width * 4 );
                     }
 
                     // Throw a few extra test values in there
@@ -586,6 +585,7 @@ int test_write_image_1D_array_set( cl_device_id device, cl_context context, cl_c
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( inputType == kInt )
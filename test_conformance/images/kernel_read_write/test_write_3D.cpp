@@ -190,8 +190,7 @@ int test_write_image_3D( cl_device_id device, cl_context context, cl_command_que
                         for( size_t y = 0; y < imageInfo->height; y++ )
                         {
                             float *inputValues = (float *)(char*)imageValues + imageInfo->width * y * 4 + imageInfo->height * imageInfo->width * z * 4;
-                            for( size_t i = 0; i < imageInfo->width * 4; i++ )
-                                inputValues[ i ] = get_random_float( -0.1f, 1.1f, d );
+                            get_random_float_array( -0.1f, 1.1f, d, inputValues, imageInfo->width * 4 );
                         }
                     }
 
@@ -618,6 +617,7 @@ int test_write_image_3D_set( cl_device_id device, cl_context context, cl_command
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( inputType == kInt )
@@ -162,8 +162,7 @@ int test_write_image( cl_device_id device, cl_context context, cl_command_queue
                     for( size_t y = 0; y < imageInfo->height; y++ )
                     {
                         float *inputValues = (float *)(char*)imageValues + imageInfo->width * y * channel_scale;
-                        for( size_t i = 0; i < imageInfo->width * channel_scale; i++ )
-                            inputValues[ i ] = get_random_float( -0.1f, 1.1f, d );
+                        get_random_float_array( -0.1f, 1.1f, d, inputValues, imageInfo->width * channel_scale );
                     }
 
                     // Throw a few extra test values in there
@@ -662,6 +661,7 @@ int test_write_image_set( cl_device_id device, cl_context context, cl_command_qu
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // Determine types
     if( inputType == kInt )
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "../testBase.h"
+#include "../../../test_common/harness/ThreadPool.h"
+#include "../../../test_common/harness/fpcontrol.h"
+#include "validate_rows.h"
+
+#include <string>
+#include <vector>
+
+typedef struct ValidateRowsInfo
+{
+    const ValidateRowsFn    *validate;
+    size_t                  rows;
+    size_t                  rowsPerTile;
+    int                     numTries;       // counters at the start of the validation
+    int                     numClamped;
+    std::vector<char>       clean;          // tile passed without logging or counting anything
+} ValidateRowsInfo;
+
+static cl_int ValidateRowsTile( cl_uint job_id, cl_uint thread_id, void *userInfo )
+{
+    ValidateRowsInfo *info = (ValidateRowsInfo *) userInfo;
+    size_t begin = job_id * info->rowsPerTile;
+    size_t end = begin + info->rowsPerTile < info->rows ? begin + info->rowsPerTile : info->rows;
+    int numTries = info->numTries;
+    int numClamped = info->numClamped;
+    std::string log;
+
+    // The reference sampling depends on denormal handling, which main sets for its own thread only
+    FPU_mode_type oldMode;
+    DisableFTZ( &oldMode );
+    // The calling thread may run tiles too, and may itself be capturing for --jobs
+    std::string *previous = log_set_capture( &log );
+
+    int ret = (*info->validate)( begin, end, numTries, numClamped );
+
+    log_set_capture( previous );
+    RestoreFPState( &oldMode );
+
+    info->clean[ job_id ] = ret == 0 && log.empty() && numTries == info->numTries && numClamped == info->numClamped;
+    return CL_SUCCESS;
+}
+
+int validate_rows_in_parallel( size_t rows, int &numTries, int &numClamped, const ValidateRowsFn &validate )
+{
+    cl_uint threadCount = GetThreadCount();
+    if( threadCount < 2 || rows < 2 )
+        return validate( 0, rows, numTries, numClamped );
+
+    // A few tiles per thread keeps the threads busy when some rows are slower to sample than others
+    ValidateRowsInfo info;
+    info.validate = &validate;
+    info.rows = rows;
+    info.rowsPerTile = ( rows + 4 * threadCount - 1 ) / ( 4 * threadCount );
+    info.numTries = numTries;
+    info.numClamped = numClamped;
+    cl_uint tileCount = (cl_uint)( ( rows + info.rowsPerTile - 1 ) / info.rowsPerTile );
+    info.clean.assign( tileCount, 0 );
+
+    if( ThreadPool_Do( ValidateRowsTile, tileCount, &info ) != CL_SUCCESS )
+        return validate( 0, rows, numTries, numClamped );
+
+    cl_uint firstDirty = 0;
+    while( firstDirty < tileCount && info.clean[ firstDirty ] )
+        firstDirty++;
+    if( firstDirty == tileCount )
+        return 0;
+
+    return validate( firstDirty * info.rowsPerTile, rows, numTries, numClamped );
+}
@@ -0,0 +1,33 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _validate_rows_h
+#define _validate_rows_h
+
+#include <functional>
+#include <stddef.h>
+
+// Checks the rows [begin, end) of a result against the host reference, updating numTries and
+// numClamped like the serial loops do. Returns non-zero to stop the test.
+typedef std::function<int( size_t begin, size_t end, int &numTries, int &numClamped )> ValidateRowsFn;
+
+// Runs validate over rows (the outermost loop of a validation: pixels for 1D, rows for 1D
+// arrays and 2D, slices for 2D arrays and 3D) in tiles on the thread pool. Each tile works on
+// its own copy of the counters and its log output is thrown away. Everything from the first
+// tile that failed or logged anything is then checked again on this thread, so the output and
+// the counters are exactly what the serial loop would have produced.
+extern int validate_rows_in_parallel( size_t rows, int &numTries, int &numClamped, const ValidateRowsFn &validate );
+
+#endif // _validate_rows_h
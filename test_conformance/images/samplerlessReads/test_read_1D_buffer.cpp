@@ -230,6 +230,7 @@ int test_read_image_set_1D_buffer( cl_device_id device, cl_context context, cl_c
     if (memSize > (cl_ulong)SIZE_MAX) {
       memSize = (cl_ulong)SIZE_MAX;
     }
+    apply_image_memory_budget( &maxAllocSize, &memSize );
 
     // note: image_buffer test uses image1D for results validation.
     // So the test can't use the biggest possible size for image_buffer if it's bigger than the max image1D size
@@ -67,6 +67,14 @@ typedef union dptr
     long double     (*f_fff)(long double, long double, long double);
 }dptr;
 
+// Batched single precision reference. Computes out[i] = (float) ref( in[i], in2[i] ) for count values
+typedef union aptr
+{
+    void    *p;
+    void    (*f_f)( float *out, const float *in, size_t count );
+    void    (*f_ff)( float *out, const float *in, const float *in2, size_t count );
+}aptr;
+
 struct Func;
 
 typedef struct vtbl
@@ -97,6 +105,11 @@ extern const Func  functionList[];
 
 extern const size_t functionListCount;
 
+// Returns the batched version of the scalar reference f, if there is one. The result is bit identical
+// to calling f on each element. Returns NULL in .p if there is no batched version, or if
+// ArrayReferenceSelfTest() has not passed.
+aptr GetArrayReference( fptr f );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "RefCache.h"
+#include "Utility.h"
+#include "reference_math.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+const char *gReferenceCacheDir = NULL;
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define REFCACHE_MAGIC      "CLREFC01"
+#define REFCACHE_PAGE       4096
+
+// File layout: header, one valid flag per chunk, then the results. The flags and the results
+// each start on a page boundary.
+typedef struct RefCacheHeader
+{
+    char        magic[8];
+    char        version[120];       // reference_math.c version and host compiler
+    char        mode[64];           // modes the references depend on
+    uint64_t    elementSize;
+    uint64_t    elementCount;
+    uint64_t    chunkElements;
+    uint64_t    dataOffset;
+}RefCacheHeader;
+
+struct RefCache
+{
+    int             fd;
+    unsigned char   *map;
+    size_t          mapSize;
+    size_t          elementSize;
+    uint64_t        elementCount;
+    volatile unsigned char *valid;
+    unsigned char   *data;
+};
+
+static size_t RoundUpToPage( uint64_t x )
+{
+    return (size_t) ((x + REFCACHE_PAGE - 1) & ~(uint64_t) (REFCACHE_PAGE - 1));
+}
+
+RefCache *RefCacheOpen( const char *name, size_t elementSize, uint64_t elementCount, uint32_t scale )
+{
+    extern int gCheckTininessBeforeRounding;
+    char path[1024];
+    RefCacheHeader header, old;
+    RefCache *cache;
+    uint64_t chunkCount = (elementCount + REFCACHE_CHUNK - 1) / REFCACHE_CHUNK;
+    uint64_t dataOffset = RoundUpToPage( sizeof( header ) ) + RoundUpToPage( chunkCount );
+    uint64_t fileSize = dataOffset + RoundUpToPage( elementCount * elementSize );
+    struct stat st, pathStat;
+    int fd;
+
+    if( NULL == gReferenceCacheDir )
+        return NULL;
+
+    if( fileSize != (size_t) fileSize )
+    {
+        vlog( "\n\t*** Reference cache for %s is too big to map. Not using it. ***\n", name );
+        return NULL;
+    }
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, REFCACHE_MAGIC, sizeof( header.magic ) );
+    snprintf( header.version, sizeof( header.version ), "%s %s", GetReferenceVersion(),
+#if defined( __VERSION__ )
+              __VERSION__
+#else
+              ""
+#endif
+            );
+    snprintf( header.mode, sizeof( header.mode ), "rlx:%d rtz:%d tininess:%d",
+              0 != gTestFastRelaxed, 0 != gIsInRTZMode, gCheckTininessBeforeRounding );
+    header.elementSize = elementSize;
+    header.elementCount = elementCount;
+    header.chunkElements = REFCACHE_CHUNK;
+    header.dataOffset = dataOffset;
+
+    // Everything that changes the results is in the file name or the header
+    snprintf( path, sizeof( path ), "%s/%s_fp%zu%s%s%s_s%u.ref", gReferenceCacheDir, name, elementSize * 8,
+              gTestFastRelaxed ? "_rlx" : "",  gIsInRTZMode ? "_rtz" : "", gCheckTininessBeforeRounding ? "" : "_tnab", scale );
+
+retry:
+    if( -1 == (fd = open( path, O_RDWR | O_CREAT, 0644 )) )
+    {
+        vlog( "\n\t*** Unable to open reference cache %s (%s). Not using it. ***\n", path, strerror( errno ) );
+        return NULL;
+    }
+
+    // Another test process may be setting up the same file. It may also have replaced the file
+    // while we waited for the lock.
+    flock( fd, LOCK_EX );
+    if( stat( path, &pathStat ) || fstat( fd, &st ) || pathStat.st_ino != st.st_ino || pathStat.st_dev != st.st_dev )
+    {
+        close( fd );
+        goto retry;
+    }
+
+    if( 0 != st.st_size && ( (uint64_t) st.st_size != fileSize ||
+        sizeof( old ) != pread( fd, &old, sizeof( old ), 0 ) || memcmp( &old, &header, sizeof( header ) ) ) )
+    {
+        // A process running another build may still have the old file mapped, so replace it
+        // rather than truncate it under them
+        if( gVerboseBruteForce )
+            vlog( "\n\tReference cache %s is stale. Rebuilding it.\n", path );
+        unlink( path );
+        close( fd );
+        goto retry;
+    }
+
+    // Grow a new file as a hole. Chunks only take up space once they are written.
+    if( 0 == st.st_size &&
+        ( ftruncate( fd, (off_t) fileSize ) || sizeof( header ) != pwrite( fd, &header, sizeof( header ), 0 ) ) )
+    {
+        vlog( "\n\t*** Unable to create reference cache %s (%s). Not using it. ***\n", path, strerror( errno ) );
+        unlink( path );
+        close( fd );
+        return NULL;
+    }
+    flock( fd, LOCK_UN );
+
+    cache = (RefCache*) calloc( 1, sizeof( *cache ) );
+    if( NULL == cache )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    cache->fd = fd;
+    cache->mapSize = (size_t) fileSize;
+    cache->elementSize = elementSize;
+    cache->elementCount = elementCount;
+    cache->map = (unsigned char*) mmap( NULL, cache->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( MAP_FAILED == (void*) cache->map )
+    {
+        vlog( "\n\t*** Unable to map reference cache %s (%s). Not using it. ***\n", path, strerror( errno ) );
+        close( fd );
+        free( cache );
+        return NULL;
+    }
+    cache->valid = cache->map + RoundUpToPage( sizeof( header ) );
+    cache->data = cache->map + dataOffset;
+
+    return cache;
+}
+
+void RefCacheClose( RefCache *cache )
+{
+    if( NULL == cache )
+        return;
+
+    munmap( cache->map, cache->mapSize );
+    close( cache->fd );
+    free( cache );
+}
+
+int RefCacheRead( RefCache *cache, uint64_t first, size_t count, void *dest )
+{
+    uint64_t i;
+
+    if( NULL == cache || first % REFCACHE_CHUNK || count % REFCACHE_CHUNK || first + count > cache->elementCount )
+        return 0;
+
+    for( i = first / REFCACHE_CHUNK; i < (first + count) / REFCACHE_CHUNK; i++ )
+        if( 0 == cache->valid[i] )
+            return 0;
+
+    // Don't read results ahead of the flags that say they are there
+    __sync_synchronize();
+    memcpy( dest, cache->data + first * cache->elementSize, count * cache->elementSize );
+    return 1;
+}
+
+void RefCacheWrite( RefCache *cache, uint64_t first, size_t count, const void *src )
+{
+    uint64_t i;
+
+    if( NULL == cache || first % REFCACHE_CHUNK || count % REFCACHE_CHUNK || first + count > cache->elementCount )
+        return;
+
+    memcpy( cache->data + first * cache->elementSize, src, count * cache->elementSize );
+
+    // Results must land before the flags
+    __sync_synchronize();
+    for( i = first / REFCACHE_CHUNK; i < (first + count) / REFCACHE_CHUNK; i++ )
+        cache->valid[i] = 1;
+}
+
+#else
+
+// Not yet implemented for this platform. Results are computed as usual.
+RefCache *RefCacheOpen( const char *name, size_t elementSize, uint64_t elementCount, uint32_t scale )
+{
+    static int warned = 0;
+
+    if( gReferenceCacheDir && ! warned )
+    {
+        vlog( "\n\t*** The reference cache is not supported on this platform. Ignoring CL_REFERENCE_CACHE. ***\n" );
+        warned = 1;
+    }
+    return NULL;
+}
+
+void RefCacheClose( RefCache *cache ) {}
+int RefCacheRead( RefCache *cache, uint64_t first, size_t count, void *dest ) { return 0; }
+void RefCacheWrite( RefCache *cache, uint64_t first, size_t count, const void *src ) {}
+
+#endif
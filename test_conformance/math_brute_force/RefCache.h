@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef REFCACHE_H
+#define REFCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Opt-in cache of reference results on disk. Set CL_REFERENCE_CACHE to a directory to turn it on.
+//
+// Each function gets one memory mapped file per precision, relaxed mode, device rounding and
+// tininess mode and input stride. Element i of the file holds the reference result for the i-th
+// input of the exhaustive sweep. Results are tracked in chunks of REFCACHE_CHUNK elements, so a
+// wimpy run or a partial run only fills (and, on file systems with sparse files, only uses disk
+// for) the chunks it actually tested. Every file records the version of reference_math.c it was
+// made with and is rebuilt automatically when that changes.
+//
+// Results are stored as is. Reference results are close to random bit patterns, so general
+// purpose compression buys little and would stop us from reading chunks in place.
+
+#define REFCACHE_CHUNK      256         // elements per valid flag
+
+typedef struct RefCache RefCache;
+
+extern const char *gReferenceCacheDir;  // NULL if the cache is off
+
+// Returns NULL if the cache is off or the file can not be used. That just means results are
+// computed as usual.
+//   name           function name
+//   elementSize    bytes per reference result
+//   elementCount   number of inputs in the sweep
+//   scale          stride between inputs, to keep wimpy and full runs in separate files
+RefCache *RefCacheOpen( const char *name, size_t elementSize, uint64_t elementCount, uint32_t scale );
+void RefCacheClose( RefCache *cache );
+
+// Copies the results for inputs [first, first + count) to dest. Returns non-zero on a hit.
+// Only whole chunks are cached, so first and count should be multiples of REFCACHE_CHUNK.
+// Safe to call from several threads at once, as long as they touch different inputs.
+int RefCacheRead( RefCache *cache, uint64_t first, size_t count, void *dest );
+void RefCacheWrite( RefCache *cache, uint64_t first, size_t count, const void *src );
+
+#endif /* REFCACHE_H */
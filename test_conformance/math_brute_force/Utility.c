@@ -14,6 +14,16 @@
 // limitations under the License.
 //
 #include "Utility.h"
+#include "harness/parseParameters.h"
+#include <string.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #include <emmintrin.h>
+    #define MISMATCH_SSE2   1
+#elif defined( __aarch64__ )
+    #include <arm_neon.h>
+    #define MISMATCH_NEON   1
+#endif
 
 #if defined(__PPC__)
 // Global varaiable used to hold the FPU control register state. The FPSCR register can not
@@ -167,3 +177,121 @@ void logFunctionInfo(const char *fname, unsigned int float_size, unsigned int is
     vlog("%15s %4s %4s",fname, fpSizeStr, fpFastRelaxedStr);
 }
 
+
+#pragma mark -
+#pragma mark Bulk compare
+
+#define MISMATCH_BLOCK  64      // bytes compared per step
+
+// Returns non-zero if the MISMATCH_BLOCK bytes at a and b are not identical. Neither needs to be aligned.
+static inline int BlockDiffers( const char *a, const char *b )
+{
+#if defined( MISMATCH_SSE2 )
+    __m128i d0 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) a ),        _mm_loadu_si128( (const __m128i*) b ) );
+    __m128i d1 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) (a + 16) ), _mm_loadu_si128( (const __m128i*) (b + 16) ) );
+    __m128i d2 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) (a + 32) ), _mm_loadu_si128( (const __m128i*) (b + 32) ) );
+    __m128i d3 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) (a + 48) ), _mm_loadu_si128( (const __m128i*) (b + 48) ) );
+    __m128i d = _mm_or_si128( _mm_or_si128( d0, d1 ), _mm_or_si128( d2, d3 ) );
+    return 0xffff != _mm_movemask_epi8( _mm_cmpeq_epi8( d, _mm_setzero_si128() ) );
+#elif defined( MISMATCH_NEON )
+    uint8x16_t d0 = veorq_u8( vld1q_u8( (const uint8_t*) a ),        vld1q_u8( (const uint8_t*) b ) );
+    uint8x16_t d1 = veorq_u8( vld1q_u8( (const uint8_t*) (a + 16) ), vld1q_u8( (const uint8_t*) (b + 16) ) );
+    uint8x16_t d2 = veorq_u8( vld1q_u8( (const uint8_t*) (a + 32) ), vld1q_u8( (const uint8_t*) (b + 32) ) );
+    uint8x16_t d3 = veorq_u8( vld1q_u8( (const uint8_t*) (a + 48) ), vld1q_u8( (const uint8_t*) (b + 48) ) );
+    return 0 != vmaxvq_u8( vorrq_u8( vorrq_u8( d0, d1 ), vorrq_u8( d2, d3 ) ) );
+#else
+    uint64_t x[ MISMATCH_BLOCK / sizeof( uint64_t ) ], y[ MISMATCH_BLOCK / sizeof( uint64_t ) ];
+    uint64_t d = 0;
+    size_t i;
+
+    memcpy( x, a, sizeof( x ) );
+    memcpy( y, b, sizeof( y ) );
+    for( i = 0; i < sizeof( x ) / sizeof( x[0] ); i++ )
+        d |= x[i] ^ y[i];
+    return 0 != d;
+#endif
+}
+
+static size_t FirstMismatch( const char *ref, void * const *test, size_t elementSize, size_t start, size_t count )
+{
+    size_t step = MISMATCH_BLOCK / elementSize;
+    size_t i = start;
+    uint32_t k;
+
+    // Skip whole blocks that match for every vector size
+    for( ; i + step <= count; i += step )
+    {
+        for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
+            if( BlockDiffers( ref + i * elementSize, (const char*) test[k] + i * elementSize ) )
+                break;
+
+        if( k < gMaxVectorSizeIndex )
+            break;
+    }
+
+    // Find the element that differs within the block, or check the last partial block
+    for( ; i < count; i++ )
+        for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
+            if( memcmp( ref + i * elementSize, (const char*) test[k] + i * elementSize, elementSize ) )
+                return i;
+
+    return count;
+}
+
+size_t FirstMismatch32( const void *ref, void * const *test, size_t start, size_t count )
+{
+    return FirstMismatch( (const char*) ref, test, sizeof( uint32_t ), start, count );
+}
+
+size_t FirstMismatch64( const void *ref, void * const *test, size_t start, size_t count )
+{
+    return FirstMismatch( (const char*) ref, test, sizeof( uint64_t ), start, count );
+}
+
+
+#pragma mark -
+#pragma mark Sharding
+
+typedef struct ShardInfo
+{
+    TPFuncPtr   func;
+    cl_uint     firstJob;
+    void        *userInfo;
+}ShardInfo;
+
+static cl_int ShardJob( cl_uint job_id, cl_uint thread_id, void *p )
+{
+    const ShardInfo *info = (const ShardInfo*) p;
+
+    return info->func( info->firstJob + job_id, thread_id, info->userInfo );
+}
+
+cl_int ShardedThreadPool_Do( TPFuncPtr func, cl_uint jobCount, void *userInfo )
+{
+    uint64_t begin, end;
+    ShardInfo info;
+
+    if( gShardCount <= 1 )
+        return ThreadPool_Do( func, jobCount, userInfo );
+
+    get_shard_range( jobCount, &begin, &end );
+    if( begin == end )
+        return CL_SUCCESS;
+
+    info.func = func;
+    info.firstJob = (cl_uint) begin;
+    info.userInfo = userInfo;
+    return ThreadPool_Do( ShardJob, (cl_uint) (end - begin), &info );
+}
+
+void GetShardSweep( uint64_t step, uint64_t *begin, uint64_t *end )
+{
+    get_shard_range( ((1ULL << 32) + step - 1) / step, begin, end );
+    *begin *= step;
+    *end *= step;
+}
+
+MTdata GetSweepBlockData( cl_uint seed, uint64_t block )
+{
+    return init_genrand( seed + (cl_uint) block );
+}
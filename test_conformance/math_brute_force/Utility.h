@@ -28,6 +28,7 @@
 #include "harness/fpcontrol.h"
 #include "harness/testHarness.h"
 #include "harness/ThreadPool.h"
+#include "harness/mt19937.h"
 #define BUFFER_SIZE         (1024*1024*2)
 
 #if defined( __GNUC__ )
@@ -270,6 +271,31 @@ int compareDoubles(double x, double y);
 
 void logFunctionInfo(const char *fname, unsigned int float_size, unsigned int isFastRelaxed);
 
+// Bulk compare for the result verification loops. Returns the index of the first element at or
+// after start where any of test[gMinVectorSizeIndex] ... test[gMaxVectorSizeIndex-1] is not bit
+// identical to ref, or count if they all match. Matching elements are skipped 64 bytes at a time,
+// so the loops only fall back to element by element checks for the few results that differ.
+size_t FirstMismatch32( const void *ref, void * const *test, size_t start, size_t count );
+size_t FirstMismatch64( const void *ref, void * const *test, size_t start, size_t count );
+
+// Sharding (--shard i/n). Each process runs one contiguous part of every test's inputs, so n
+// processes together cover what one unsharded run does. Serial loops that draw random inputs take
+// a generator per block from GetSweepBlockData, so their shards draw the same inputs too. Thread
+// pool jobs draw from their thread's generator, so their random inputs differ from run to run
+// whether sharded or not; only the swept and special inputs are the same.
+//
+// ShardedThreadPool_Do runs this shard's part of jobCount jobs, passing func the same job_ids it
+// would see unsharded. GetShardSweep gives the part of a serial loop over [0, 2**32) in steps of
+// step, as [*begin, *end), with both a multiple of step.
+//
+// GetSweepBlockData returns a generator for block number block of such a loop, seeded from seed and
+// the block's index rather than continuing one sequence over the blocks, so a shard can start at
+// any block. The caller frees it with free_mtdata. Unsharded runs draw different inputs for a given
+// seed than they did when the loops drew from one sequence.
+cl_int ShardedThreadPool_Do( TPFuncPtr func, cl_uint jobCount, void *userInfo );
+void GetShardSweep( uint64_t step, uint64_t *begin, uint64_t *end );
+MTdata GetSweepBlockData( cl_uint seed, uint64_t block );
+
 #endif /* UTILITY_H */
 
 
@@ -0,0 +1,49 @@
+#! /usr/bin/python
+
+#  //  OpenCL Conformance Tests
+#  //
+#  //  Copyright (c) 2017 The Khronos Group Inc.
+#  //
+
+import subprocess, sys, time
+
+# A script to compare the throughput of math_brute_force with the worker threads unpinned
+# and pinned to cores grouped by NUMA node (the -n flag). The functions timed by default are
+# single precision unary functions, so the time is dominated by TestFloat in unary.c.
+#
+#   benchmark_thread_affinity.py [test binary] [runs] [-- extra args and function names]
+#
+# Each configuration is run the given number of times and the best wall clock time is kept.
+
+test = "./test_bruteforce"
+runs = 3
+extra_args = [ "-w", "sin", "cos", "exp", "log", "sqrt" ]
+
+args = sys.argv[1:]
+if "--" in args:
+  extra_args = args[ args.index("--") + 1 : ]
+  args = args[ : args.index("--") ]
+if len(args) > 0:
+  test = args[0]
+if len(args) > 1:
+  runs = int(args[1])
+
+def run(pin):
+  command = [ test ] + ([ "-n" ] if pin else []) + extra_args
+  best = None
+  for i in range(runs):
+    start = time.time()
+    p = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    p.communicate()
+    elapsed = time.time() - start
+    if p.returncode != 0:
+      print("ERROR: " + " ".join(command) + " returned " + str(p.returncode))
+      sys.exit(1)
+    if best is None or elapsed < best:
+      best = elapsed
+  print("%-10s %8.2f s   (%s)" % ("pinned" if pin else "unpinned", best, " ".join(command)))
+  return best
+
+unpinned = run(False)
+pinned = run(True)
+print("speedup from pinning: %.2fx" % (unpinned / pinned))
@@ -352,7 +352,7 @@ int TestFunc_Float_Float_Float_common(const Func *f, MTdata d, int isNextafter)
     // Run the kernels
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -667,8 +667,12 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data  )
     }
     else
     {
-        for( j = 0; j < buffer_elements; j++ )
-            r[j] = (float) ref_func( s[j], s2[j] );
+        aptr afunc = GetArrayReference( func );
+        if( afunc.f_ff )
+            afunc.f_ff( r, s, s2, buffer_elements );
+        else
+            for( j = 0; j < buffer_elements; j++ )
+                r[j] = (float) ref_func( s[j], s2[j] );
     }
 
     if( isFDim && ftz )
@@ -696,7 +700,7 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data  )
     if (!skipVerification) {
         //Verify data
         t = (cl_uint *)r;
-        for( j = 0; j < buffer_elements; j++ )
+        for( j = FirstMismatch32( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch32( t, (void**) out, j + 1, buffer_elements ) )
         {
             for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
             {
@@ -1084,7 +1088,7 @@ int TestFunc_Double_Double_Double_common(const Func *f, MTdata d, int isNextafte
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -1369,7 +1373,7 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
 
     //Verify data
     t = (cl_ulong *)r;
-    for( j = 0; j < buffer_elements; j++ )
+    for( j = FirstMismatch64( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch64( t, (void**) out, j + 1, buffer_elements ) )
     {
         for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
         {
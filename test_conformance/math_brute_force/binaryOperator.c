@@ -340,7 +340,7 @@ int TestFunc_Float_Float_Float_Operator(const Func *f, MTdata d)
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -677,7 +677,7 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
 
     //Verify data
     t = (cl_uint *)r;
-    for( j = 0; j < buffer_elements; j++ )
+    for( j = FirstMismatch32( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch32( t, (void**) out, j + 1, buffer_elements ) )
     {
         for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
         {
@@ -1029,7 +1029,7 @@ int TestFunc_Double_Double_Double_Operator(const Func *f, MTdata d)
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -1313,7 +1313,7 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
 
     //Verify data
     t = (cl_ulong *)r;
-    for( j = 0; j < buffer_elements; j++ )
+    for( j = FirstMismatch64( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch64( t, (void**) out, j + 1, buffer_elements ) )
     {
         for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
         {
@@ -341,7 +341,7 @@ int TestFunc_Float_Float_Int(const Func *f, MTdata d)
     }
 
     // Run the kernels
-    error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+    error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
 
 
     // Accumulate the arithmetic errors
@@ -852,7 +852,7 @@ int TestFunc_Double_Double_Int(const Func *f, MTdata d)
 
     // Run the kernels
     if( !gSkipCorrectnessTesting )
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
 
 
     // Accumulate the arithmetic errors
@@ -269,7 +269,7 @@ ReferenceD(cl_uint jid, cl_uint tid, void *userInfo)
 
 int TestFunc_FloatI_Float_Float(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -311,16 +311,20 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         cl_uint *p = (cl_uint *)gIn;
         cl_uint *p2 = (cl_uint *)gIn2;
         for( j = 0; j < bufferSize / sizeof( float ); j++ )
         {
-            p[j] = genrand_int32(d);
-            p2[j] = genrand_int32(d);
+            p[j] = genrand_int32(blockData);
+            p2[j] = genrand_int32(blockData);
         }
+        free_mtdata( blockData );
 
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
@@ -698,7 +702,7 @@ exit:
 
 int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -740,16 +744,20 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         double *p = (double *)gIn;
         double *p2 = (double *)gIn2;
         for( j = 0; j < bufferSize / sizeof( double ); j++ )
         {
-            p[j] = DoubleFromUInt32(genrand_int32(d));
-            p2[j] = DoubleFromUInt32(genrand_int32(d));
+            p[j] = DoubleFromUInt32(genrand_int32(blockData));
+            p2[j] = DoubleFromUInt32(genrand_int32(blockData));
         }
+        free_mtdata( blockData );
 
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
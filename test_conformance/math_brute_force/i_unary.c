@@ -179,7 +179,7 @@ static cl_int BuildKernel_DoubleFn( cl_uint job_id, cl_uint thread_id UNUSED, vo
 
 int TestFunc_Int_Float(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -212,7 +212,8 @@ int TestFunc_Int_Float(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
@@ -399,7 +400,7 @@ exit:
 
 int TestFunc_Int_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -435,7 +436,8 @@ int TestFunc_Int_Double(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         double *p = (double *)gIn;
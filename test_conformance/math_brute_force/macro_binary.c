@@ -330,7 +330,7 @@ int TestMacro_Int_Float_Float(const Func *f, MTdata d)
     // Run the kernels
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
 
         if( error )
             goto exit;
@@ -841,7 +841,7 @@ int TestMacro_Int_Double_Double(const Func *f, MTdata d)
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
 
         if( error )
             goto exit;
@@ -290,7 +290,7 @@ int TestMacro_Int_Float(const Func *f, MTdata d)
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
 
         if( error )
             goto exit;
@@ -685,7 +685,7 @@ int TestMacro_Int_Double(const Func *f, MTdata d)
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
 
         if( error )
             goto exit;
@@ -189,7 +189,7 @@ static cl_int BuildKernel_DoubleFn( cl_uint job_id, cl_uint thread_id UNUSED, vo
 
 int TestFunc_mad(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
 
@@ -219,18 +219,23 @@ int TestFunc_mad(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
         uint32_t *p2 = (uint32_t *)gIn2;
         uint32_t *p3 = (uint32_t *)gIn3;
         for( j = 0; j < bufferSize / sizeof( float ); j++ )
         {
-            p[j] = genrand_int32(d);
-            p2[j] = genrand_int32(d);
-            p3[j] = genrand_int32(d);
+            p[j] = genrand_int32(blockData);
+            p2[j] = genrand_int32(blockData);
+            p3[j] = genrand_int32(blockData);
         }
+        free_mtdata( blockData );
+
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
             vlog_error( "\n*** Error %d in clEnqueueWriteBuffer ***\n", error );
@@ -657,7 +662,7 @@ exit:
 
 int TestFunc_mad_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -689,18 +694,23 @@ int TestFunc_mad_Double(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         double *p = (double *)gIn;
         double *p2 = (double *)gIn2;
         double *p3 = (double *)gIn3;
         for( j = 0; j < bufferSize / sizeof( double ); j++ )
         {
-            p[j] = DoubleFromUInt32(genrand_int32(d));
-            p2[j] = DoubleFromUInt32(genrand_int32(d));
-            p3[j] = DoubleFromUInt32(genrand_int32(d));
+            p[j] = DoubleFromUInt32(genrand_int32(blockData));
+            p2[j] = DoubleFromUInt32(genrand_int32(blockData));
+            p3[j] = DoubleFromUInt32(genrand_int32(blockData));
         }
+        free_mtdata( blockData );
+
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
             vlog_error( "\n*** Error %d in clEnqueueWriteBuffer ***\n", error );
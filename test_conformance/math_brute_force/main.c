@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <time.h>
 #include "FunctionList.h"
+#include "reference_math.h"
+#include "RefCache.h"
 #include "Sleep.h"
 
 #include "harness/errorHelpers.h"
@@ -137,6 +139,7 @@ static int InitILogbConstants( void );
 static int IsTininessDetectedBeforeRounding( void );
 static int IsInRTZMode( void );         //expensive. Please check gIsInRTZMode global instead.
 static void TestFinishAtExit(void);
+static cl_int FirstTouchBuffers( cl_uint job_id, cl_uint thread_id, void *p );
 
 
 int doTest( const char* name )
@@ -923,6 +926,7 @@ static int ParseArgs( int argc, const char **argv )
     gTestNames[0] = argv[0];
     gTestNameCount = 1;
     int singleThreaded = 0;
+    int pinThreads = 0;
 
     { // Extract the app name
         strncpy( appName, argv[0], MAXPATHLEN );
@@ -993,6 +997,10 @@ static int ParseArgs( int argc, const char **argv )
                         singleThreaded ^= 1;
                         break;
 
+                    case 'n':
+                        pinThreads ^= 1;
+                        break;
+
                     case 'r':
                         gTestFastRelaxed ^= 1;
                         break;
@@ -1102,6 +1110,13 @@ static int ParseArgs( int argc, const char **argv )
       gWimpyMode = 1;
     }
 
+    // Check for a directory to cache reference results in
+    if (getenv("CL_REFERENCE_CACHE")) {
+      gReferenceCacheDir = getenv("CL_REFERENCE_CACHE");
+      vlog( "\n" );
+      vlog( "*** Caching reference results in %s ***\n", gReferenceCacheDir );
+    }
+
 #if defined( __APPLE__ )
     #if defined( __i386__ ) || defined( __x86_64__ )
         #define    kHasSSE3                0x00000008
@@ -1151,6 +1166,9 @@ static int ParseArgs( int argc, const char **argv )
     if( singleThreaded )
         SetThreadCount(1);
 
+    if( pinThreads )
+        SetThreadAffinity(1);
+
     return 0;
 }
 
@@ -1235,6 +1253,7 @@ static void PrintUsage( void )
     vlog( "\t\t-p\tPrint all math function names and quit\n" );
     vlog( "\t\t-l\tlink check only (make sure functions are present, skip accuracy checks.)\n" );
     vlog( "\t\t-m\tToggle run multi-threaded. (Default: on) )\n" );
+    vlog( "\t\t-n\tToggle pinning worker threads to cores, grouped by NUMA node. (Default: off)\n" );
     vlog( "\t\t-s\tStop on error\n" );
     vlog( "\t\t-t\tToggle timing  (on by default)\n" );
     vlog( "\t\t-w\tToggle Wimpy Mode, * Not a valid test * \n");
@@ -1249,6 +1268,7 @@ static void PrintUsage( void )
     vlog( "\tonly the named cases in the number range will run.\n" );
     vlog( "\tYou may also choose to pass no arguments, in which case all tests will be run.\n" );
     vlog( "\tYou may pass CL_DEVICE_TYPE_CPU/GPU/ACCELERATOR to select the device.\n" );
+    vlog( "\tSet CL_REFERENCE_CACHE to a directory to reuse reference results across runs.\n" );
     vlog( "\n" );
 }
 
@@ -1434,6 +1454,14 @@ test_status InitCL( cl_device_id device )
             return TEST_FAIL;
     }
 
+    // Each worker thread works on its own slice of the host buffers. Have the workers touch their
+    // slices first, so that the pages land on their own NUMA node when the threads are pinned.
+    if( (error = ThreadPool_DoOnEachWorker( FirstTouchBuffers, NULL )) )
+    {
+        vlog_error( "FirstTouchBuffers failed. (%d)\n", error );
+        return TEST_FAIL;
+    }
+
     cl_mem_flags device_flags = CL_MEM_READ_ONLY;
     // save a copy on the host device to make this go faster
     if( CL_DEVICE_TYPE_CPU == device_type )
@@ -1496,6 +1524,9 @@ test_status InitCL( cl_device_id device )
     //Check tininess detection
     IsTininessDetectedBeforeRounding();
 
+    // Make sure the batched references agree with the scalar ones before we rely on them
+    ArrayReferenceSelfTest();
+
     cl_platform_id platform;
     int err = clGetPlatformIDs(1, &platform, NULL);
     if( err )
@@ -1574,6 +1605,31 @@ test_status InitCL( cl_device_id device )
     return TEST_PASS;
 }
 
+// Zero the slice of each host buffer that is used by worker thread thread_id. The slices match
+// the sub-buffers that the tests carve out for each thread.
+static cl_int FirstTouchBuffers( cl_uint job_id, cl_uint thread_id, void *p )
+{
+    size_t sliceSize = BUFFER_SIZE / RoundUpToNextPowerOfTwo( GetThreadCount() );
+    size_t offset = thread_id * sliceSize;
+    uint32_t i;
+
+    memset( (char*) gIn + offset, 0, sliceSize );
+    memset( (char*) gIn2 + offset, 0, sliceSize );
+    memset( (char*) gIn3 + offset, 0, sliceSize );
+    memset( (char*) gOut_Ref + offset, 0, sliceSize );
+    memset( (char*) gOut_Ref2 + offset, 0, sliceSize );
+    for( i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++ )
+    {
+        memset( (char*) gOut[i] + offset, 0, sliceSize );
+        memset( (char*) gOut2[i] + offset, 0, sliceSize );
+    }
+
+    if( gVerboseBruteForce )
+        vlog( "Buffer slice %u touched on node %u\n", thread_id, GetThreadNode( thread_id ) );
+
+    return CL_SUCCESS;
+}
+
 static void ReleaseCL( void )
 {
     uint32_t i;
@@ -1585,6 +1641,7 @@ static void ReleaseCL( void )
         clReleaseMemObject(gOutBuffer2[i]);
     }
     clReleaseCommandQueue(gQueue);
+    release_program_cache();
     clReleaseContext(gContext);
 
     align_free(gIn);
@@ -1736,7 +1793,7 @@ int MakeKernel( const char **c, cl_uint count, const char *name, cl_kernel *k, c
       strcat(options, " -cl-fast-relaxed-math");
     }
 
-    error = create_single_kernel_helper(gContext, p, NULL, count, c, NULL, options);
+    error = create_program_cached(gContext, p, count, c, options);
     if (error != CL_SUCCESS)
     {
         vlog_error("\t\tFAILED -- Failed to create program. (%d)\n", error);
@@ -1781,7 +1838,7 @@ int MakeKernels( const char **c, cl_uint count, const char *name, cl_uint kernel
       strcat(options, " -cl-fast-relaxed-math");
     }
 
-    error = create_single_kernel_helper(gContext, p, NULL, count, c, NULL, options);
+    error = create_program_cached(gContext, p, count, c, options);
     if ( error != CL_SUCCESS )
     {
         vlog_error( "\t\tFAILED -- Failed to create program. (%d)\n", error );
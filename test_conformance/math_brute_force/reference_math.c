@@ -22,6 +22,7 @@
 #endif
 
 #include "Utility.h"
+#include "FunctionList.h"
 
 #if defined( __SSE__ ) || (defined( _MSC_VER ) && (defined(_M_IX86) || defined(_M_X64)))
     #include <xmmintrin.h>
@@ -5500,3 +5501,291 @@ int reference_notl( long double x )
 }
 
 
+#pragma mark -
+#pragma mark Batched references
+
+// Batched versions of the simpler single precision references, so that the reference pass over a
+// buffer in TestFloat can run several values at a time. See reference_math_array.h.
+typedef enum ArrayReferenceType
+{
+    kArray_f_f,         // double ref( double )
+    kArray_f_ff,        // double ref( double, double )
+    kArray_f_ff_f       // float ref( float, float )
+}ArrayReferenceType;
+
+typedef struct ArrayReference
+{
+    void                *ref;           // the scalar reference
+    aptr                array;          // its batched version
+    ArrayReferenceType  type;
+}ArrayReference;
+
+// The scalar references are called through a volatile pointer, so that they can't be inlined.
+// Inlined, the compiler may fold away the float to double and back conversions that quiet
+// signaling NaNs, and give a different answer than the tests get by calling through a Func.
+static void ArrayScalar_f_f( double (*ref)( double ), float *out, const float *in, size_t count )
+{
+    double (* volatile f)( double ) = ref;
+    size_t i;
+    for( i = 0; i < count; i++ )
+        out[i] = (float) f( in[i] );
+}
+
+static void ArrayScalar_f_ff( double (*ref)( double, double ), float *out, const float *in, const float *in2, size_t count )
+{
+    double (* volatile f)( double, double ) = ref;
+    size_t i;
+    for( i = 0; i < count; i++ )
+        out[i] = (float) f( in[i], in2[i] );
+}
+
+#if defined( __SSE2__ ) || (defined( _MSC_VER ) && (defined(_M_IX86) || defined(_M_X64)))
+    #define ARRAY_NAME( _n )        _n##_sse2
+    #define ARRAY_ATTR
+    #define ARRAY_WIDTH             4
+    #define ARRAY_V                 __m128
+    #define ARRAY_LOAD              _mm_loadu_ps
+    #define ARRAY_STORE             _mm_storeu_ps
+    #define ARRAY_SPLAT             _mm_set1_ps
+    #define ARRAY_AND               _mm_and_ps
+    #define ARRAY_OR                _mm_or_ps
+    #define ARRAY_ANDNOT            _mm_andnot_ps
+    #define ARRAY_ADD               _mm_add_ps
+    #define ARRAY_SUB               _mm_sub_ps
+    #define ARRAY_SQRT              _mm_sqrt_ps
+    #define ARRAY_LT                _mm_cmplt_ps
+    #define ARRAY_TRUNC( _x )       _mm_cvtepi32_ps( _mm_cvttps_epi32( _x ) )
+    #define ARRAY_ANY_NAN( _x )     _mm_movemask_ps( _mm_cmpunord_ps( _x, _x ) )
+    #include "reference_math_array.h"
+    #define HAS_ARRAY_SSE2 1
+#endif
+
+// AVX2 is picked at run time, so build it with a target attribute unless the whole file is built for AVX2
+#if defined( __AVX2__ ) || ((defined( __i386__ ) || defined( __x86_64__ )) && (defined( __clang__ ) || (defined( __GNUC__ ) && __GNUC__ >= 5)))
+    #include <immintrin.h>
+    #undef  ARRAY_NAME
+    #undef  ARRAY_ATTR
+    #undef  ARRAY_WIDTH
+    #undef  ARRAY_V
+    #undef  ARRAY_LOAD
+    #undef  ARRAY_STORE
+    #undef  ARRAY_SPLAT
+    #undef  ARRAY_AND
+    #undef  ARRAY_OR
+    #undef  ARRAY_ANDNOT
+    #undef  ARRAY_ADD
+    #undef  ARRAY_SUB
+    #undef  ARRAY_SQRT
+    #undef  ARRAY_LT
+    #undef  ARRAY_TRUNC
+    #undef  ARRAY_ANY_NAN
+    #define ARRAY_NAME( _n )        _n##_avx2
+    #if defined( __AVX2__ )
+        #define ARRAY_ATTR
+    #else
+        #define ARRAY_ATTR          __attribute__((target("avx2")))
+    #endif
+    #define ARRAY_WIDTH             8
+    #define ARRAY_V                 __m256
+    #define ARRAY_LOAD              _mm256_loadu_ps
+    #define ARRAY_STORE             _mm256_storeu_ps
+    #define ARRAY_SPLAT             _mm256_set1_ps
+    #define ARRAY_AND               _mm256_and_ps
+    #define ARRAY_OR                _mm256_or_ps
+    #define ARRAY_ANDNOT            _mm256_andnot_ps
+    #define ARRAY_ADD               _mm256_add_ps
+    #define ARRAY_SUB               _mm256_sub_ps
+    #define ARRAY_SQRT              _mm256_sqrt_ps
+    #define ARRAY_LT( _a, _b )      _mm256_cmp_ps( _a, _b, _CMP_LT_OQ )
+    #define ARRAY_TRUNC( _x )       _mm256_round_ps( _x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC )
+    #define ARRAY_ANY_NAN( _x )     _mm256_movemask_ps( _mm256_cmp_ps( _x, _x, _CMP_UNORD_Q ) )
+    #include "reference_math_array.h"
+    #define HAS_ARRAY_AVX2 1
+#endif
+
+// 32-bit ARM NEON flushes denormals, so only AArch64 gets a NEON path
+#if defined( __aarch64__ ) && defined( __ARM_NEON )
+    #include <arm_neon.h>
+    #define ARRAY_NAME( _n )        _n##_neon
+    #define ARRAY_ATTR
+    #define ARRAY_WIDTH             4
+    #define ARRAY_V                 float32x4_t
+    #define ARRAY_U( _x )           vreinterpretq_u32_f32( _x )
+    #define ARRAY_F( _x )           vreinterpretq_f32_u32( _x )
+    #define ARRAY_LOAD              vld1q_f32
+    #define ARRAY_STORE             vst1q_f32
+    #define ARRAY_SPLAT             vdupq_n_f32
+    #define ARRAY_AND( _a, _b )     ARRAY_F( vandq_u32( ARRAY_U( _a ), ARRAY_U( _b ) ) )
+    #define ARRAY_OR( _a, _b )      ARRAY_F( vorrq_u32( ARRAY_U( _a ), ARRAY_U( _b ) ) )
+    #define ARRAY_ANDNOT( _a, _b )  ARRAY_F( vbicq_u32( ARRAY_U( _b ), ARRAY_U( _a ) ) )
+    #define ARRAY_ADD               vaddq_f32
+    #define ARRAY_SUB               vsubq_f32
+    #define ARRAY_SQRT              vsqrtq_f32
+    #define ARRAY_LT( _a, _b )      ARRAY_F( vcltq_f32( _a, _b ) )
+    #define ARRAY_TRUNC             vrndq_f32
+    #define ARRAY_ANY_NAN( _x )     ( 0 != vmaxvq_u32( vmvnq_u32( vceqq_f32( _x, _x ) ) ) )
+    #include "reference_math_array.h"
+    #define HAS_ARRAY_NEON 1
+#endif
+
+// The batched references in use. NULL until ArrayReferenceSelfTest() passes.
+static const ArrayReference *gArrayReferences = NULL;
+
+aptr GetArrayReference( fptr f )
+{
+    const ArrayReference *a = gArrayReferences;
+    aptr none = { NULL };
+
+    if( NULL == a || NULL == f.p )
+        return none;
+
+    for( ; NULL != a->ref; a++ )
+        if( a->ref == f.p )
+            return a->array;
+
+    return none;
+}
+
+// Pick the widest instruction set the host supports
+static const ArrayReference *ArrayReferencesForHost( const char **name )
+{
+#if defined( HAS_ARRAY_AVX2 )
+    #if defined( __AVX2__ )
+    if( 1 )
+    #else
+    if( __builtin_cpu_supports( "avx2" ) )
+    #endif
+    {
+        *name = "AVX2";
+        return gArrayReferences_avx2;
+    }
+#endif
+#if defined( HAS_ARRAY_SSE2 )
+    *name = "SSE2";
+    return gArrayReferences_sse2;
+#elif defined( HAS_ARRAY_NEON )
+    *name = "NEON";
+    return gArrayReferences_neon;
+#else
+    *name = "none";
+    return NULL;
+#endif
+}
+
+int ArrayReferenceSelfTest( void )
+{
+    // Signed zeros, denormals, halfway cases, the edges of the range where floor and friends
+    // do any work, overflow to int, infinities and NaNs (quiet, signaling and with payloads)
+    static const cl_uint specials[] = {
+        0x00000000, 0x80000000, 0x00000001, 0x80000001, 0x007fffff, 0x807fffff, 0x00800000, 0x80800000,
+        0x3effffff, 0xbeffffff, 0x3f000000, 0xbf000000, 0x3f000001, 0xbf000001, 0x3f800000, 0xbf800000,
+        0x3fc00000, 0xbfc00000, 0x40200000, 0xc0200000, 0x4afffffe, 0xcafffffe, 0x4affffff, 0xcaffffff,
+        0x4b000000, 0xcb000000, 0x4b000001, 0xcb000001, 0x4b800000, 0xcb800000, 0x4effffff, 0xceffffff,
+        0x4f000000, 0xcf000000, 0x7f7fffff, 0xff7fffff, 0x7f800000, 0xff800000, 0x7fc00000, 0xffc00000,
+        0x7f800001, 0xff800001, 0x7fa00000, 0x7fc12345, 0xffbfffff };
+    const size_t specialCount = sizeof( specials ) / sizeof( specials[0] );
+    const size_t count = 1 << 16;
+    const ArrayReference *table, *a;
+    const char *isa;
+    cl_uint *in, *in2, *out, *ref;
+    size_t i, offset;
+    int errors = 0;
+    MTdata d;
+
+    gArrayReferences = NULL;
+    if( NULL == (table = ArrayReferencesForHost( &isa )) )
+        return 0;
+
+    in = (cl_uint*) malloc( count * sizeof( *in ) );
+    in2 = (cl_uint*) malloc( count * sizeof( *in2 ) );
+    out = (cl_uint*) malloc( count * sizeof( *out ) );
+    ref = (cl_uint*) malloc( count * sizeof( *ref ) );
+    d = init_genrand( 0x5eed1e55 );
+    if( NULL == in || NULL == in2 || NULL == out || NULL == ref || NULL == d )
+    {
+        vlog_error( "Error: Unable to allocate memory for the batched reference self test\n" );
+        errors = 1;
+        goto exit;
+    }
+
+    // Every pair of special values, then random bits salted with more special values
+    for( i = 0; i < count; i++ )
+    {
+        if( i < specialCount * specialCount )
+        {
+            in[i] = specials[ i / specialCount ];
+            in2[i] = specials[ i % specialCount ];
+        }
+        else
+        {
+            in[i] = genrand_int32( d );
+            in2[i] = (genrand_int32( d ) & 7) ? genrand_int32( d ) : specials[ genrand_int32( d ) % specialCount ];
+        }
+    }
+
+    for( a = table; NULL != a->ref && errors < 16; a++ )
+    {
+        // Run from an odd offset too, to cover unaligned data and a short tail
+        for( offset = 0; offset < 2; offset++ )
+        {
+            size_t n = count - offset;
+            const float *x = (const float*) in + offset;
+            const float *y = (const float*) in2 + offset;
+
+            memset( out, 0, count * sizeof( *out ) );
+            switch( a->type )
+            {
+                case kArray_f_f:
+                    ArrayScalar_f_f( (double (*)(double)) a->ref, (float*) ref, x, n );
+                    a->array.f_f( (float*) out, x, n );
+                    break;
+                case kArray_f_ff:
+                    ArrayScalar_f_ff( (double (*)(double, double)) a->ref, (float*) ref, x, y, n );
+                    a->array.f_ff( (float*) out, x, y, n );
+                    break;
+                case kArray_f_ff_f:
+                    for( i = 0; i < n; i++ )
+                        ((float*) ref)[i] = ((float (*)(float, float)) a->ref)( x[i], y[i] );
+                    a->array.f_ff( (float*) out, x, y, n );
+                    break;
+            }
+
+            for( i = 0; i < n && errors < 16; i++ )
+                if( out[i] != ref[i] )
+                {
+                    vlog_error( "Error: %s batched reference %d gives 0x%8.8x for 0x%8.8x, 0x%8.8x. Expected 0x%8.8x\n",
+                                isa, (int) (a - table), out[i], in[i + offset], in2[i + offset], ref[i] );
+                    errors++;
+                }
+        }
+    }
+
+exit:
+    free( in );
+    free( in2 );
+    free( out );
+    free( ref );
+    free_mtdata( d );
+
+    if( errors )
+        vlog_error( "Batched references do not match the scalar references. Using the scalar references only.\n" );
+    else
+        gArrayReferences = table;
+
+    return errors;
+}
+
+#pragma mark -
+#pragma mark Reference version
+
+// Identifies this version of the references, so cached reference results can be thrown away when
+// it changes. CMake passes in a hash of this file. Other builds fall back on the time this file was
+// compiled, which changes at least as often.
+const char *GetReferenceVersion( void )
+{
+#if defined( REFERENCE_MATH_HASH )
+    return REFERENCE_MATH_HASH;
+#else
+    return __DATE__ " " __TIME__;
+#endif
+}
@@ -227,6 +227,14 @@ long double reference_ldexpl( long double x, int n );
 long double reference_assignmentl( long double x );
 int reference_notl( long double x );
 
+// -- batched references, see GetArrayReference() in FunctionList.h --
+// Checks the batched references against the scalar ones, and enables them if they are bit
+// identical. Returns the number of mismatches, or 0 on success. Call once before running tests.
+int ArrayReferenceSelfTest( void );
+
+// Changes whenever the references do. Used to invalidate the reference cache in RefCache.h.
+const char *GetReferenceVersion( void );
+
 #endif
 
 
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2017 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Batched single precision references, written once in terms of the ARRAY_* vector
+// primitives. reference_math.c includes this file once per instruction set, after defining:
+//
+//   ARRAY_NAME( _n )         decorates a function name with the instruction set
+//   ARRAY_ATTR               function attributes needed to use the instruction set
+//   ARRAY_WIDTH              floats per vector
+//   ARRAY_V                  vector type
+//   ARRAY_LOAD / STORE       unaligned load and store
+//   ARRAY_SPLAT( f )         vector with every lane set to f
+//   ARRAY_AND, OR, ANDNOT    bitwise ops. ANDNOT( a, b ) is ~a & b
+//   ARRAY_ADD, SUB           arithmetic in the current rounding mode
+//   ARRAY_SQRT               correctly rounded square root
+//   ARRAY_LT( a, b )         all ones in lanes where a < b
+//   ARRAY_TRUNC( x )         x rounded toward zero. Only needs to be right for |x| < 2**23
+//   ARRAY_ANY_NAN( x )       non-zero if any lane of x is a NaN
+//
+// Vectors with a NaN input are handed to the scalar reference. NaN signs and payloads depend on
+// how the host converts between float and double, and the vector code can not be relied on to
+// match that. Everything else, including the NaN that sqrt returns for negative numbers, must be
+// bit identical to the scalar reference. ArrayReferenceSelfTest() checks this at start up.
+
+#define ARRAY_SELECT( _m, _a, _b )  ARRAY_OR( ARRAY_AND( _m, _a ), ARRAY_ANDNOT( _m, _b ) )
+#define ARRAY_SIGN                  ARRAY_SPLAT( -0.0f )
+#define ARRAY_COPYSIGN( _x, _y )    ARRAY_OR( ARRAY_ANDNOT( ARRAY_SIGN, _x ), ARRAY_AND( ARRAY_SIGN, _y ) )
+#define ARRAY_IS_SMALL( _x )        ARRAY_LT( ARRAY_ANDNOT( ARRAY_SIGN, _x ), ARRAY_SPLAT( 8388608.0f ) )    // |x| < 2**23
+
+#define ARRAY_UNARY( _name, _ref, _x, _expr )                                                   \
+static ARRAY_ATTR void ARRAY_NAME( _name )( float *out, const float *in, size_t count )        \
+{                                                                                               \
+    size_t i;                                                                                   \
+    for( i = 0; i + ARRAY_WIDTH <= count; i += ARRAY_WIDTH )                                    \
+    {                                                                                           \
+        ARRAY_V _x = ARRAY_LOAD( in + i );                                                      \
+        ARRAY_V r = _expr;                                                                      \
+        ARRAY_STORE( out + i, r );                                                              \
+        if( ARRAY_ANY_NAN( _x ) )                                                               \
+            ArrayScalar_f_f( _ref, out + i, in + i, ARRAY_WIDTH );                              \
+    }                                                                                           \
+    ArrayScalar_f_f( _ref, out + i, in + i, count - i );                                        \
+}
+
+#define ARRAY_BINARY( _name, _ref, _x, _y, _expr )                                              \
+static ARRAY_ATTR void ARRAY_NAME( _name )( float *out, const float *in, const float *in2, size_t count ) \
+{                                                                                               \
+    size_t i;                                                                                   \
+    for( i = 0; i + ARRAY_WIDTH <= count; i += ARRAY_WIDTH )                                    \
+    {                                                                                           \
+        ARRAY_V _x = ARRAY_LOAD( in + i );                                                      \
+        ARRAY_V _y = ARRAY_LOAD( in2 + i );                                                     \
+        ARRAY_V r = _expr;                                                                      \
+        ARRAY_STORE( out + i, r );                                                              \
+        if( ARRAY_ANY_NAN( _x ) || ARRAY_ANY_NAN( _y ) )                                        \
+            ArrayScalar_f_ff( _ref, out + i, in + i, in2 + i, ARRAY_WIDTH );                    \
+    }                                                                                           \
+    ArrayScalar_f_ff( _ref, out + i, in + i, in2 + i, count - i );                              \
+}
+
+static ARRAY_ATTR ARRAY_V ARRAY_NAME( ArrayFloor )( ARRAY_V x )
+{
+    ARRAY_V t = ARRAY_TRUNC( x );
+    t = ARRAY_SELECT( ARRAY_LT( x, t ), ARRAY_SUB( t, ARRAY_SPLAT( 1.0f ) ), t );
+    return ARRAY_SELECT( ARRAY_IS_SMALL( x ), ARRAY_COPYSIGN( t, x ), x );
+}
+
+static ARRAY_ATTR ARRAY_V ARRAY_NAME( ArrayCeil )( ARRAY_V x )
+{
+    ARRAY_V t = ARRAY_TRUNC( x );
+    t = ARRAY_SELECT( ARRAY_LT( t, x ), ARRAY_ADD( t, ARRAY_SPLAT( 1.0f ) ), t );
+    return ARRAY_SELECT( ARRAY_IS_SMALL( x ), ARRAY_COPYSIGN( t, x ), x );
+}
+
+static ARRAY_ATTR ARRAY_V ARRAY_NAME( ArrayTrunc )( ARRAY_V x )
+{
+    return ARRAY_SELECT( ARRAY_IS_SMALL( x ), ARRAY_COPYSIGN( ARRAY_TRUNC( x ), x ), x );
+}
+
+// Same trick as reference_rint, with a float sized magic number
+static ARRAY_ATTR ARRAY_V ARRAY_NAME( ArrayRint )( ARRAY_V x )
+{
+    ARRAY_V magic = ARRAY_COPYSIGN( ARRAY_SPLAT( 8388608.0f ), x );
+    ARRAY_V t = ARRAY_SUB( ARRAY_ADD( x, magic ), magic );
+    return ARRAY_SELECT( ARRAY_IS_SMALL( x ), ARRAY_COPYSIGN( t, x ), x );
+}
+
+ARRAY_UNARY( reference_fabs_array,      reference_fabs,     x, ARRAY_ANDNOT( ARRAY_SIGN, x ) )
+ARRAY_UNARY( reference_floor_array,     reference_floor,    x, ARRAY_NAME( ArrayFloor )( x ) )
+ARRAY_UNARY( reference_ceil_array,      reference_ceil,     x, ARRAY_NAME( ArrayCeil )( x ) )
+ARRAY_UNARY( reference_trunc_array,     reference_trunc,    x, ARRAY_NAME( ArrayTrunc )( x ) )
+ARRAY_UNARY( reference_rint_array,      reference_rint,     x, ARRAY_NAME( ArrayRint )( x ) )
+ARRAY_UNARY( reference_sqrt_array,      reference_sqrt,     x, ARRAY_SQRT( x ) )
+
+// fmin and fmax written out as the scalar references do: x <= y ? x : y, and x >= y ? x : y
+ARRAY_BINARY( reference_fmin_array,     reference_fmin,     x, y, ARRAY_SELECT( ARRAY_LT( y, x ), y, x ) )
+ARRAY_BINARY( reference_fmax_array,     reference_fmax,     x, y, ARRAY_SELECT( ARRAY_LT( x, y ), y, x ) )
+
+// copysign is pure bit manipulation, so even NaNs come out the same as the scalar reference
+static ARRAY_ATTR void ARRAY_NAME( reference_copysign_array )( float *out, const float *in, const float *in2, size_t count )
+{
+    size_t i;
+    for( i = 0; i + ARRAY_WIDTH <= count; i += ARRAY_WIDTH )
+        ARRAY_STORE( out + i, ARRAY_COPYSIGN( ARRAY_LOAD( in + i ), ARRAY_LOAD( in2 + i ) ) );
+    for( ; i < count; i++ )
+        out[i] = reference_copysign( in[i], in2[i] );
+}
+
+static const ArrayReference ARRAY_NAME( gArrayReferences )[] =
+{
+    { (void*) reference_fabs,       { (void*) ARRAY_NAME( reference_fabs_array ) },        kArray_f_f },
+    { (void*) reference_floor,      { (void*) ARRAY_NAME( reference_floor_array ) },       kArray_f_f },
+    { (void*) reference_ceil,       { (void*) ARRAY_NAME( reference_ceil_array ) },        kArray_f_f },
+    { (void*) reference_trunc,      { (void*) ARRAY_NAME( reference_trunc_array ) },       kArray_f_f },
+    { (void*) reference_rint,       { (void*) ARRAY_NAME( reference_rint_array ) },        kArray_f_f },
+    { (void*) reference_sqrt,       { (void*) ARRAY_NAME( reference_sqrt_array ) },        kArray_f_f },
+    { (void*) reference_fmin,       { (void*) ARRAY_NAME( reference_fmin_array ) },        kArray_f_ff },
+    { (void*) reference_fmax,       { (void*) ARRAY_NAME( reference_fmax_array ) },        kArray_f_ff },
+    { (void*) reference_copysign,   { (void*) ARRAY_NAME( reference_copysign_array ) },    kArray_f_ff_f },
+    { NULL,                         { NULL },                                              kArray_f_f }
+};
+
+#undef ARRAY_SELECT
+#undef ARRAY_SIGN
+#undef ARRAY_COPYSIGN
+#undef ARRAY_IS_SMALL
+#undef ARRAY_UNARY
+#undef ARRAY_BINARY
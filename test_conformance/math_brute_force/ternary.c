@@ -212,7 +212,7 @@ static size_t specialValuesFloatCount = sizeof( specialValuesFloat ) / sizeof( s
 
 int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -250,8 +250,11 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d)
      return error;
      */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
         uint32_t *p2 = (uint32_t *)gIn2;
@@ -286,10 +289,12 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d)
 
         for( ; j < bufferSize / sizeof( float ); j++ )
         {
-            p[j] = genrand_int32(d);
-            p2[j] = genrand_int32(d);
-            p3[j] = genrand_int32(d);
+            p[j] = genrand_int32(blockData);
+            p2[j] = genrand_int32(blockData);
+            p3[j] = genrand_int32(blockData);
         }
+        free_mtdata( blockData );
+
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
             vlog_error( "\n*** Error %d in clEnqueueWriteBuffer ***\n", error );
@@ -375,7 +380,7 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d)
 
         //Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
-        for( j = 0; j < bufferSize / sizeof( float ); j++ )
+        for( j = FirstMismatch32( t, gOut, 0, bufferSize / sizeof( float ) ); j < bufferSize / sizeof( float ); j = FirstMismatch32( t, gOut, j + 1, bufferSize / sizeof( float ) ) )
         {
             for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
             {
@@ -855,7 +860,7 @@ static const size_t specialValuesDoubleCount = sizeof( specialValuesDouble ) / s
 
 int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -890,8 +895,11 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d)
      return error;
      */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    cl_uint sweepSeed = genrand_int32(d);
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
+        MTdata blockData = GetSweepBlockData( sweepSeed, i / step );
         //Init input array
         double *p = (double *)gIn;
         double *p2 = (double *)gIn2;
@@ -922,10 +930,12 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d)
 
         for( ; j < bufferSize / sizeof( double ); j++ )
         {
-            p[j] = DoubleFromUInt32(genrand_int32(d));
-            p2[j] = DoubleFromUInt32(genrand_int32(d));
-            p3[j] = DoubleFromUInt32(genrand_int32(d));
+            p[j] = DoubleFromUInt32(genrand_int32(blockData));
+            p2[j] = DoubleFromUInt32(genrand_int32(blockData));
+            p3[j] = DoubleFromUInt32(genrand_int32(blockData));
         }
+        free_mtdata( blockData );
+
         if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0, bufferSize, gIn, 0, NULL, NULL) ))
         {
             vlog_error( "\n*** Error %d in clEnqueueWriteBuffer ***\n", error );
@@ -999,7 +1009,7 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d)
 
         //Verify data
         uint64_t *t = (uint64_t *)gOut_Ref;
-        for( j = 0; j < bufferSize / sizeof( double ); j++ )
+        for( j = FirstMismatch64( t, gOut, 0, bufferSize / sizeof( double ) ); j < bufferSize / sizeof( double ); j = FirstMismatch64( t, gOut, j + 1, bufferSize / sizeof( double ) ) )
         {
             for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
             {
@@ -17,6 +17,7 @@
 
 #include <string.h>
 #include "FunctionList.h"
+#include "RefCache.h"
 
 #if defined( __APPLE__ )
     #include <sys/time.h>
@@ -182,11 +183,18 @@ static cl_int BuildKernel_DoubleFn( cl_uint job_id, cl_uint thread_id UNUSED, vo
     return BuildKernelDouble( info->nameInCode, i, info->kernel_count, info->kernels[i], info->programs + i );
 }
 
+#define PIPELINE_SLOTS  2                           // jobs each worker thread keeps in flight
+
 //Thread specific data for a worker thread
 typedef struct ThreadInfo
 {
-    cl_mem      inBuf;                              // input buffer for the thread
-    cl_mem      outBuf[ VECTOR_SIZE_COUNT ];        // output buffers for the thread
+    cl_mem      inBuf[ PIPELINE_SLOTS ];                            // input buffers for the thread
+    cl_mem      outBuf[ PIPELINE_SLOTS ][ VECTOR_SIZE_COUNT ];      // output buffers for the thread
+    void        *out[ PIPELINE_SLOTS ][ VECTOR_SIZE_COUNT ];        // results mapped for reading, waiting to be checked
+    cl_event    mapDone[ PIPELINE_SLOTS ];                          // completes when out[ slot ] can be read
+    cl_uint     slot;                                               // slot for the next job
+    cl_uint     pendingJob;                                         // job launched into the other slot, not yet checked
+    int         pending;                                            // non-zero if pendingJob is valid
     float       maxError;                           // max error value. Init to 0.
     double      maxErrorValue;                      // position of the max error value.  Init to 0.
     cl_command_queue tQueue;                        // per thread command queue to improve performance
@@ -208,13 +216,18 @@ typedef struct TestInfo
 
     int         isRangeLimited;                     // 1 if the function is only to be evaluated over a range
     float       half_sin_cos_tan_limit;
+    RefCache    *refCache;                          // cached reference results, or NULL
 }TestInfo;
 
 static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *p );
+static cl_int DrainFloat( cl_uint job_id, cl_uint thread_id, void *p );
+static void PipelineAbort( ThreadInfo *tinfo );
 
 int TestFunc_Float_Float(const Func *f, MTdata d)
 {
     TestInfo    test_info;
+    BuildKernelInfo build_info;
+    TPTaskHandle buildTask = NULL;
     cl_int      error;
     size_t      i, j;
     float       maxError = 0.0f;
@@ -227,11 +240,11 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
     memset( &test_info, 0, sizeof( test_info ) );
     test_info.threadCount = GetThreadCount();
 
-    test_info.subBufferSize = BUFFER_SIZE / (sizeof( cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+    test_info.subBufferSize = BUFFER_SIZE / (sizeof( cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount) * PIPELINE_SLOTS);
     test_info.scale =  1;
     if (gWimpyMode)
     {
-        test_info.subBufferSize = gWimpyBufferSize / (sizeof( cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+        test_info.subBufferSize = gWimpyBufferSize / (sizeof( cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount) * PIPELINE_SLOTS);
         test_info.scale =  (cl_uint) sizeof(cl_float) * 2 * gWimpyReductionFactor;
     }
     test_info.step = (cl_uint) test_info.subBufferSize * test_info.scale;
@@ -248,6 +261,8 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
     test_info.f = f;
     test_info.ulps = gIsEmbedded ? f->float_embedded_ulps : f->float_ulps;
     test_info.ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
+    if( ! gSkipCorrectnessTesting )
+        test_info.refCache = RefCacheOpen( f->name, sizeof( cl_float ), (uint64_t) test_info.jobCount * test_info.subBufferSize, test_info.scale );
     // cl_kernels aren't thread safe, so we make one for each vector size for every thread
     for( i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++ )
     {
@@ -261,6 +276,15 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
         }
         memset( test_info.k[i], 0, array_size );
     }
+    // Start building the kernels while we set up the per-thread buffers and queues
+    build_info.offset = gMinVectorSizeIndex;
+    build_info.kernel_count = test_info.threadCount;
+    build_info.kernels = test_info.k;
+    build_info.programs = test_info.programs;
+    build_info.nameInCode = f->nameInCode;
+    if( (error = ThreadPool_Submit( BuildKernel_FloatFn, gMaxVectorSizeIndex - gMinVectorSizeIndex, &build_info, &buildTask ) ))
+        goto exit;
+
     test_info.tinfo = (ThreadInfo*)malloc( test_info.threadCount * sizeof(*test_info.tinfo) );
     if( NULL == test_info.tinfo )
     {
@@ -271,23 +295,27 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
     memset( test_info.tinfo, 0, test_info.threadCount * sizeof(*test_info.tinfo) );
     for( i = 0; i < test_info.threadCount; i++ )
     {
-        cl_buffer_region region = { i * test_info.subBufferSize * sizeof( cl_float), test_info.subBufferSize * sizeof( cl_float) };
-        test_info.tinfo[i].inBuf = clCreateSubBuffer( gInBuffer, CL_MEM_READ_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
-        if( error || NULL == test_info.tinfo[i].inBuf)
+        for( cl_uint slot = 0; slot < PIPELINE_SLOTS; slot++ )
         {
-            vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
-            goto exit;
-        }
-
-        for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
-        {
-            test_info.tinfo[i].outBuf[j] = clCreateSubBuffer( gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
-            if( error || NULL == test_info.tinfo[i].outBuf[j] )
+            cl_buffer_region region = { (i * PIPELINE_SLOTS + slot) * test_info.subBufferSize * sizeof( cl_float), test_info.subBufferSize * sizeof( cl_float) };
+            test_info.tinfo[i].inBuf[slot] = clCreateSubBuffer( gInBuffer, CL_MEM_READ_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+            if( error || NULL == test_info.tinfo[i].inBuf[slot])
             {
                 vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
                 goto exit;
             }
+
+            for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+            {
+                test_info.tinfo[i].outBuf[slot][j] = clCreateSubBuffer( gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+                if( error || NULL == test_info.tinfo[i].outBuf[slot][j] )
+                {
+                    vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
+                    goto exit;
+                }
+            }
         }
+
         test_info.tinfo[i].tQueue = clCreateCommandQueueWithProperties(gContext, gDevice, 0, &error);
         if( NULL == test_info.tinfo[i].tQueue || error )
         {
@@ -311,16 +339,17 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
         test_info.half_sin_cos_tan_limit = INFINITY;             // out of range resut from finite inputs must be numeric
     }
 
-    // Init the kernels
-    {
-        BuildKernelInfo build_info = { gMinVectorSizeIndex, test_info.threadCount, test_info.k, test_info.programs, f->nameInCode };
-        if( (error = ThreadPool_Do( BuildKernel_FloatFn, gMaxVectorSizeIndex - gMinVectorSizeIndex, &build_info ) ))
-            goto exit;
-    }
+    // Wait for the kernels
+    error = ThreadPool_Wait( buildTask );
+    buildTask = NULL;
+    if( error )
+        goto exit;
 
     if( !gSkipCorrectnessTesting || skipTestingRelaxed)
     {
-        error = ThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestFloat, test_info.jobCount, &test_info );
+        if( ! error )
+            error = ThreadPool_Do( DrainFloat, test_info.threadCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -412,6 +441,10 @@ int TestFunc_Float_Float(const Func *f, MTdata d)
     vlog( "\n" );
 
 exit:
+    // Don't release the programs out from under the kernel builds
+    if( buildTask )
+        ThreadPool_Wait( buildTask );
+
     for( i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++ )
     {
         clReleaseProgram(test_info.programs[i]);
@@ -427,48 +460,137 @@ exit:
     {
         for( i = 0; i < test_info.threadCount; i++ )
         {
-            clReleaseMemObject(test_info.tinfo[i].inBuf);
-            for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
-                clReleaseMemObject(test_info.tinfo[i].outBuf[j]);
+            PipelineAbort( test_info.tinfo + i );
+            for( cl_uint slot = 0; slot < PIPELINE_SLOTS; slot++ )
+            {
+                clReleaseMemObject(test_info.tinfo[i].inBuf[slot]);
+                for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+                    clReleaseMemObject(test_info.tinfo[i].outBuf[slot][j]);
+            }
             clReleaseCommandQueue(test_info.tinfo[i].tQueue);
         }
 
         free( test_info.tinfo );
     }
 
+    RefCacheClose( test_info.refCache );
+
     return error;
 }
 
-static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
+// Queues up non-blocking maps of the results of the job in slot. They go on the queue right behind its
+// kernels, so the host can wait for them without waiting for jobs launched later.
+static cl_int MapResults( ThreadInfo *tinfo, cl_uint slot, size_t buffer_size )
+{
+    cl_uint j;
+    cl_int error;
+
+    for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+    {
+        // This is an in order queue, so the last map finishing means they all have
+        cl_event *e = j + 1 == gMaxVectorSizeIndex ? tinfo->mapDone + slot : NULL;
+        tinfo->out[slot][j] = clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[slot][j], CL_FALSE, CL_MAP_READ, 0, buffer_size, 0, NULL, e, &error);
+        if( error || NULL == tinfo->out[slot][j] )
+        {
+            vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
+            return error;
+        }
+    }
+
+    return CL_SUCCESS;
+}
+
+static cl_int WaitForResults( ThreadInfo *tinfo, cl_uint slot )
+{
+    cl_int error = clWaitForEvents( 1, tinfo->mapDone + slot );
+
+    clReleaseEvent( tinfo->mapDone[slot] );
+    tinfo->mapDone[slot] = NULL;
+    if( error )
+        vlog_error( "Error: clWaitForEvents failed! err: %d\n", error );
+
+    return error;
+}
+
+// Each worker thread keeps two jobs in flight. A job launches its own kernels, then checks the job the
+// thread launched before it, so the host computes references and verifies results while the device
+// is busy. The last job of every thread is checked by PipelineDrain once ThreadPool_Do returns.
+typedef cl_int (*PipelineStage)( const TestInfo *job, cl_uint job_id, cl_uint thread_id, cl_uint slot );
+
+static cl_int PipelineJob( const TestInfo *job, cl_uint job_id, cl_uint thread_id, PipelineStage launch, PipelineStage check )
+{
+    ThreadInfo *tinfo = job->tinfo + thread_id;
+    cl_uint slot = tinfo->slot;
+    cl_int error;
+
+    if( (error = launch( job, job_id, thread_id, slot )) )
+        return error;
+
+    if( tinfo->pending )
+        error = check( job, tinfo->pendingJob, thread_id, slot ^ 1 );
+
+    tinfo->pendingJob = job_id;
+    tinfo->pending = 1;
+    tinfo->slot = slot ^ 1;
+
+    return error;
+}
+
+// Runs as job thread_id, for the leftover job of that thread
+static cl_int PipelineDrain( const TestInfo *job, cl_uint thread_id, PipelineStage check )
+{
+    ThreadInfo *tinfo = job->tinfo + thread_id;
+
+    if( ! tinfo->pending )
+        return CL_SUCCESS;
+
+    tinfo->pending = 0;
+    return check( job, tinfo->pendingJob, thread_id, tinfo->slot ^ 1 );
+}
+
+// Called on the way out. If a job failed, or the pipeline was never drained, results may still be
+// on their way to the host or mapped. Let them land and unmap them before the buffers are released.
+static void PipelineAbort( ThreadInfo *tinfo )
+{
+    cl_uint slot, j;
+
+    if( NULL == tinfo->tQueue )
+        return;
+
+    for( slot = 0; slot < PIPELINE_SLOTS; slot++ )
+    {
+        if( tinfo->mapDone[slot] )
+            WaitForResults( tinfo, slot );
+        for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+            if( tinfo->out[slot][j] )
+            {
+                clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[slot][j], tinfo->out[slot][j], 0, NULL, NULL );
+                tinfo->out[slot][j] = NULL;
+            }
+    }
+    clFinish( tinfo->tQueue );
+}
+
+// Writes the inputs of a job and queues up its kernels, followed by maps of the results for CheckFloat
+static cl_int LaunchFloat( const TestInfo *job, cl_uint job_id, cl_uint thread_id, cl_uint slot )
 {
-    const TestInfo *job = (const TestInfo *) data;
     size_t  buffer_elements = job->subBufferSize;
     size_t  buffer_size = buffer_elements * sizeof( cl_float );
     cl_uint scale = job->scale;
     cl_uint base = job_id * (cl_uint) job->step;
     ThreadInfo *tinfo = job->tinfo + thread_id;
-    float   ulps = job->ulps;
-    fptr    func = job->f->func;
     const char * fname = job->f->name;
-    if ( gTestFastRelaxed  )
-    {
-        ulps = job->f->relaxed_error;
-        func = job->f->rfunc;
-    }
-
-    cl_uint j, k;
+    cl_mem  inBuf = tinfo->inBuf[slot];
+    cl_mem  *outBuf = tinfo->outBuf[slot];
+    cl_uint j;
     cl_int error;
 
-    int isRangeLimited = job->isRangeLimited;
-    float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
-    int ftz = job->ftz;
-
     // start the map of the output arrays
     cl_event e[ VECTOR_SIZE_COUNT ];
     cl_uint  *out[ VECTOR_SIZE_COUNT ];
     for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
     {
-        out[j] = (uint32_t*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0, buffer_size, 0, NULL, e + j, &error);
+        out[j] = (uint32_t*) clEnqueueMapBuffer( tinfo->tQueue, outBuf[j], CL_FALSE, CL_MAP_WRITE, 0, buffer_size, 0, NULL, e + j, &error);
         if( error || NULL == out[j])
         {
             vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
@@ -481,7 +603,7 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
         vlog( "clFlush failed\n" );
 
     // Write the new values to the input array
-    cl_uint *p = (cl_uint*) gIn + thread_id * buffer_elements;
+    cl_uint *p = (cl_uint*) gIn + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
     for( j = 0; j < buffer_elements; j++ )
     {
       p[j] = base + j * scale;
@@ -502,7 +624,7 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
       }
     }
 
-    if( (error = clEnqueueWriteBuffer( tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0, buffer_size, p, 0, NULL, NULL) ))
+    if( (error = clEnqueueWriteBuffer( tinfo->tQueue, inBuf, CL_FALSE, 0, buffer_size, p, 0, NULL, NULL) ))
     {
         vlog_error( "Error: clEnqueueWriteBuffer failed! err: %d\n", error );
         return error;
@@ -525,7 +647,7 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
         // Fill the result buffer with garbage, so that old results don't carry over
         uint32_t pattern = 0xffffdead;
         memset_pattern4(out[j], &pattern, buffer_size);
-        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[j], out[j], 0, NULL, NULL) ))
+        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, outBuf[j], out[j], 0, NULL, NULL) ))
         {
             vlog_error( "Error: clEnqueueMapBuffer failed! err: %d\n", error );
             return error;
@@ -536,8 +658,8 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
         cl_kernel kernel = job->k[j][thread_id];  //each worker thread has its own copy of the cl_kernel
         cl_program program = job->programs[j];
 
-        if( ( error = clSetKernelArg( kernel, 0, sizeof( tinfo->outBuf[j] ), &tinfo->outBuf[j] ))){ LogBuildError(program); return error; }
-        if( ( error = clSetKernelArg( kernel, 1, sizeof( tinfo->inBuf ), &tinfo->inBuf ) )) { LogBuildError(program); return error; }
+        if( ( error = clSetKernelArg( kernel, 0, sizeof( outBuf[j] ), &outBuf[j] ))){ LogBuildError(program); return error; }
+        if( ( error = clSetKernelArg( kernel, 1, sizeof( inBuf ), &inBuf ) )) { LogBuildError(program); return error; }
 
         if( (error = clEnqueueNDRangeKernel(tinfo->tQueue, kernel, 1, NULL, &vectorCount, NULL, 0, NULL, NULL)))
         {
@@ -546,41 +668,65 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
         }
     }
 
+    if( ! gSkipCorrectnessTesting && (error = MapResults( tinfo, slot, buffer_size )) )
+        return error;
 
     // Get that moving
     if( (error = clFlush(tinfo->tQueue) ))
         vlog( "clFlush 2 failed\n" );
 
+    return CL_SUCCESS;
+}
+
+// Computes the reference results for a job started by LaunchFloat, and checks the device results against them
+static cl_int CheckFloat( const TestInfo *job, cl_uint job_id, cl_uint thread_id, cl_uint slot )
+{
+    size_t  buffer_elements = job->subBufferSize;
+    cl_uint base = job_id * (cl_uint) job->step;
+    ThreadInfo *tinfo = job->tinfo + thread_id;
+    float   ulps = job->ulps;
+    fptr    func = job->f->func;
+    const char * fname = job->f->name;
+    if ( gTestFastRelaxed  )
+    {
+        ulps = job->f->relaxed_error;
+        func = job->f->rfunc;
+    }
+
+    cl_uint j, k;
+    cl_int error;
+
+    int isRangeLimited = job->isRangeLimited;
+    float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
+    int ftz = job->ftz;
+    cl_uint  *out[ VECTOR_SIZE_COUNT ];
+
     if( gSkipCorrectnessTesting )
         return CL_SUCCESS;
 
     //Calculate the correctly rounded reference result
-    float *r = (float *)gOut_Ref + thread_id * buffer_elements;
-    float *s = (float *)p;
-    for( j = 0; j < buffer_elements; j++ )
-        r[j] = (float) func.f_f( s[j] );
-
-    // Read the data back -- no need to wait for the first N-1 buffers. This is an in order queue.
-    for( j = gMinVectorSizeIndex; j + 1 < gMaxVectorSizeIndex; j++ )
+    float *r = (float *)gOut_Ref + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
+    float *s = (float *)gIn + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
+    if( ! RefCacheRead( job->refCache, (uint64_t) job_id * buffer_elements, buffer_elements, r ) )
     {
-        out[j] = (uint32_t*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_READ, 0, buffer_size, 0, NULL, NULL, &error);
-        if( error || NULL == out[j] )
-        {
-            vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
-            return error;
-        }
+        aptr afunc = GetArrayReference( func );
+        if( afunc.f_f )
+            afunc.f_f( r, s, buffer_elements );
+        else
+            for( j = 0; j < buffer_elements; j++ )
+                r[j] = (float) func.f_f( s[j] );
+        RefCacheWrite( job->refCache, (uint64_t) job_id * buffer_elements, buffer_elements, r );
     }
-    // Wait for the last buffer
-    out[j] = (uint32_t*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_TRUE, CL_MAP_READ, 0, buffer_size, 0, NULL, NULL, &error);
-    if( error || NULL == out[j] )
-    {
-        vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
+
+    // Wait for the results
+    if( (error = WaitForResults( tinfo, slot )) )
         return error;
-    }
+    for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+        out[j] = (cl_uint*) tinfo->out[slot][j];
 
     //Verify data
     uint32_t *t = (uint32_t *)r;
-    for( j = 0; j < buffer_elements; j++ )
+    for( j = FirstMismatch32( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch32( t, (void**) out, j + 1, buffer_elements ) )
     {
         for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
         {
@@ -747,11 +893,12 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
 
     for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
     {
-        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[j], out[j], 0, NULL, NULL)) )
+        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[slot][j], out[j], 0, NULL, NULL)) )
         {
             vlog_error( "Error: clEnqueueUnmapMemObject %d failed 2! err: %d\n", j, error );
             return error;
         }
+        tinfo->out[slot][j] = NULL;
     }
 
     if( (error = clFlush(tinfo->tQueue) ))
@@ -775,28 +922,25 @@ static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
 
 
 
-static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
+// Writes the inputs of a job and queues up its kernels, followed by maps of the results for CheckDouble
+static cl_int LaunchDouble( const TestInfo *job, cl_uint job_id, cl_uint thread_id, cl_uint slot )
 {
-    const TestInfo *job = (const TestInfo *) data;
     size_t  buffer_elements = job->subBufferSize;
     size_t  buffer_size = buffer_elements * sizeof( cl_double );
     cl_uint scale = job->scale;
     cl_uint base = job_id * (cl_uint) job->step;
     ThreadInfo *tinfo = job->tinfo + thread_id;
-    float   ulps = job->ulps;
-    dptr    func = job->f->dfunc;
-    cl_uint j, k;
+    cl_mem  inBuf = tinfo->inBuf[slot];
+    cl_mem  *outBuf = tinfo->outBuf[slot];
+    cl_uint j;
     cl_int error;
-    int ftz = job->ftz;
-
-    Force64BitFPUPrecision();
 
     // start the map of the output arrays
     cl_event e[ VECTOR_SIZE_COUNT ];
     cl_ulong *out[ VECTOR_SIZE_COUNT ];
     for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
     {
-        out[j] = (cl_ulong*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0, buffer_size, 0, NULL, e + j, &error);
+        out[j] = (cl_ulong*) clEnqueueMapBuffer( tinfo->tQueue, outBuf[j], CL_FALSE, CL_MAP_WRITE, 0, buffer_size, 0, NULL, e + j, &error);
         if( error || NULL == out[j])
         {
             vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
@@ -809,11 +953,11 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
         vlog( "clFlush failed\n" );
 
     // Write the new values to the input array
-    cl_double *p = (cl_double*) gIn + thread_id * buffer_elements;
+    cl_double *p = (cl_double*) gIn + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
     for( j = 0; j < buffer_elements; j++ )
         p[j] = DoubleFromUInt32( base + j * scale);
 
-    if( (error = clEnqueueWriteBuffer( tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0, buffer_size, p, 0, NULL, NULL) ))
+    if( (error = clEnqueueWriteBuffer( tinfo->tQueue, inBuf, CL_FALSE, 0, buffer_size, p, 0, NULL, NULL) ))
     {
         vlog_error( "Error: clEnqueueWriteBuffer failed! err: %d\n", error );
         return error;
@@ -836,7 +980,7 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
         // Fill the result buffer with garbage, so that old results don't carry over
         uint32_t pattern = 0xffffdead;
         memset_pattern4(out[j], &pattern, buffer_size);
-        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[j], out[j], 0, NULL, NULL) ))
+        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, outBuf[j], out[j], 0, NULL, NULL) ))
         {
             vlog_error( "Error: clEnqueueMapBuffer failed! err: %d\n", error );
             return error;
@@ -847,8 +991,8 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
         cl_kernel kernel = job->k[j][thread_id];  //each worker thread has its own copy of the cl_kernel
         cl_program program = job->programs[j];
 
-        if( ( error = clSetKernelArg( kernel, 0, sizeof( tinfo->outBuf[j] ), &tinfo->outBuf[j] ))){ LogBuildError(program); return error; }
-        if( ( error = clSetKernelArg( kernel, 1, sizeof( tinfo->inBuf ), &tinfo->inBuf ) )) { LogBuildError(program); return error; }
+        if( ( error = clSetKernelArg( kernel, 0, sizeof( outBuf[j] ), &outBuf[j] ))){ LogBuildError(program); return error; }
+        if( ( error = clSetKernelArg( kernel, 1, sizeof( inBuf ), &inBuf ) )) { LogBuildError(program); return error; }
 
         if( (error = clEnqueueNDRangeKernel(tinfo->tQueue, kernel, 1, NULL, &vectorCount, NULL, 0, NULL, NULL)))
         {
@@ -857,42 +1001,53 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
         }
     }
 
+    if( ! gSkipCorrectnessTesting && (error = MapResults( tinfo, slot, buffer_size )) )
+        return error;
 
     // Get that moving
     if( (error = clFlush(tinfo->tQueue) ))
         vlog( "clFlush 2 failed\n" );
 
+    return CL_SUCCESS;
+}
+
+// Computes the reference results for a job started by LaunchDouble, and checks the device results against them
+static cl_int CheckDouble( const TestInfo *job, cl_uint job_id, cl_uint thread_id, cl_uint slot )
+{
+    size_t  buffer_elements = job->subBufferSize;
+    cl_uint base = job_id * (cl_uint) job->step;
+    ThreadInfo *tinfo = job->tinfo + thread_id;
+    float   ulps = job->ulps;
+    dptr    func = job->f->dfunc;
+    cl_uint j, k;
+    cl_int error;
+    int ftz = job->ftz;
+
+    Force64BitFPUPrecision();
+    cl_ulong *out[ VECTOR_SIZE_COUNT ];
+
     if( gSkipCorrectnessTesting )
         return CL_SUCCESS;
 
     //Calculate the correctly rounded reference result
-    cl_double *r = (cl_double *)gOut_Ref + thread_id * buffer_elements;
-    cl_double *s = (cl_double *)p;
-    for( j = 0; j < buffer_elements; j++ )
-        r[j] = (cl_double) func.f_f( s[j] );
-
-    // Read the data back -- no need to wait for the first N-1 buffers. This is an in order queue.
-    for( j = gMinVectorSizeIndex; j + 1 < gMaxVectorSizeIndex; j++ )
+    cl_double *r = (cl_double *)gOut_Ref + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
+    cl_double *s = (cl_double *)gIn + (thread_id * PIPELINE_SLOTS + slot) * buffer_elements;
+    if( ! RefCacheRead( job->refCache, (uint64_t) job_id * buffer_elements, buffer_elements, r ) )
     {
-        out[j] = (cl_ulong*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_READ, 0, buffer_size, 0, NULL, NULL, &error);
-        if( error || NULL == out[j] )
-        {
-            vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
-            return error;
-        }
-    }
-    // Wait for the last buffer
-    out[j] = (cl_ulong*) clEnqueueMapBuffer( tinfo->tQueue, tinfo->outBuf[j], CL_TRUE, CL_MAP_READ, 0, buffer_size, 0, NULL, NULL, &error);
-    if( error || NULL == out[j] )
-    {
-        vlog_error( "Error: clEnqueueMapBuffer %d failed! err: %d\n", j, error );
-        return error;
+        for( j = 0; j < buffer_elements; j++ )
+            r[j] = (cl_double) func.f_f( s[j] );
+        RefCacheWrite( job->refCache, (uint64_t) job_id * buffer_elements, buffer_elements, r );
     }
 
+    // Wait for the results
+    if( (error = WaitForResults( tinfo, slot )) )
+        return error;
+    for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+        out[j] = (cl_ulong*) tinfo->out[slot][j];
 
     //Verify data
     cl_ulong *t = (cl_ulong *)r;
-    for( j = 0; j < buffer_elements; j++ )
+    for( j = FirstMismatch64( t, (void**) out, 0, buffer_elements ); j < buffer_elements; j = FirstMismatch64( t, (void**) out, j + 1, buffer_elements ) )
     {
         for( k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++ )
         {
@@ -948,7 +1103,7 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
                 }
                 if( fail )
                 {
-                    vlog_error( "\nERROR: %s%s: %f ulp error at %.13la (0x%16.16llx): *%.13la vs. %.13la\n", job->f->name, sizeNames[k], err, ((cl_double*) gIn)[j], ((cl_ulong*) gIn)[j], ((cl_double*) gOut_Ref)[j], test );
+                    vlog_error( "\nERROR: %s%s: %f ulp error at %.13la (0x%16.16llx): *%.13la vs. %.13la\n", job->f->name, sizeNames[k], err, s[j], (unsigned long long) ((cl_ulong*) s)[j], r[j], test );
                     return -1;
                 }
             }
@@ -957,11 +1112,12 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
 
     for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
     {
-        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[j], out[j], 0, NULL, NULL)) )
+        if( (error = clEnqueueUnmapMemObject( tinfo->tQueue, tinfo->outBuf[slot][j], out[j], 0, NULL, NULL)) )
         {
             vlog_error( "Error: clEnqueueUnmapMemObject %d failed 2! err: %d\n", j, error );
             return error;
         }
+        tinfo->out[slot][j] = NULL;
     }
 
     if( (error = clFlush(tinfo->tQueue) ))
@@ -983,9 +1139,31 @@ static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
     return CL_SUCCESS;
 }
 
+static cl_int TestFloat( cl_uint job_id, cl_uint thread_id, void *data )
+{
+    return PipelineJob( (const TestInfo *) data, job_id, thread_id, LaunchFloat, CheckFloat );
+}
+
+static cl_int DrainFloat( cl_uint job_id, cl_uint thread_id UNUSED, void *data )
+{
+    return PipelineDrain( (const TestInfo *) data, job_id, CheckFloat );
+}
+
+static cl_int TestDouble( cl_uint job_id, cl_uint thread_id, void *data )
+{
+    return PipelineJob( (const TestInfo *) data, job_id, thread_id, LaunchDouble, CheckDouble );
+}
+
+static cl_int DrainDouble( cl_uint job_id, cl_uint thread_id UNUSED, void *data )
+{
+    return PipelineDrain( (const TestInfo *) data, job_id, CheckDouble );
+}
+
 int TestFunc_Double_Double(const Func *f, MTdata d)
 {
     TestInfo    test_info;
+    BuildKernelInfo build_info;
+    TPTaskHandle buildTask = NULL;
     cl_int      error;
     size_t      i, j;
     float       maxError = 0.0f;
@@ -1001,11 +1179,11 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
     // Init test_info
     memset( &test_info, 0, sizeof( test_info ) );
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE / (sizeof( cl_double) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+    test_info.subBufferSize = BUFFER_SIZE / (sizeof( cl_double) * RoundUpToNextPowerOfTwo(test_info.threadCount) * PIPELINE_SLOTS);
     test_info.scale =  1;
     if (gWimpyMode)
     {
-        test_info.subBufferSize = gWimpyBufferSize / (sizeof( cl_double) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+        test_info.subBufferSize = gWimpyBufferSize / (sizeof( cl_double) * RoundUpToNextPowerOfTwo(test_info.threadCount) * PIPELINE_SLOTS);
         test_info.scale =  (cl_uint) sizeof(cl_double) * 2 * gWimpyReductionFactor;
     }
     test_info.step = (cl_uint) test_info.subBufferSize * test_info.scale;
@@ -1022,6 +1200,8 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
     test_info.f = f;
     test_info.ulps = f->double_ulps;
     test_info.ftz = f->ftz || gForceFTZ;
+    if( ! gSkipCorrectnessTesting )
+        test_info.refCache = RefCacheOpen( f->name, sizeof( cl_double ), (uint64_t) test_info.jobCount * test_info.subBufferSize, test_info.scale );
 
     // cl_kernels aren't thread safe, so we make one for each vector size for every thread
     for( i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++ )
@@ -1036,6 +1216,15 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
         }
         memset( test_info.k[i], 0, array_size );
     }
+    // Start building the kernels while we set up the per-thread buffers and queues
+    build_info.offset = gMinVectorSizeIndex;
+    build_info.kernel_count = test_info.threadCount;
+    build_info.kernels = test_info.k;
+    build_info.programs = test_info.programs;
+    build_info.nameInCode = f->nameInCode;
+    if( (error = ThreadPool_Submit( BuildKernel_DoubleFn, gMaxVectorSizeIndex - gMinVectorSizeIndex, &build_info, &buildTask ) ))
+        goto exit;
+
     test_info.tinfo = (ThreadInfo*)malloc( test_info.threadCount * sizeof(*test_info.tinfo) );
     if( NULL == test_info.tinfo )
     {
@@ -1046,25 +1235,29 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
     memset( test_info.tinfo, 0, test_info.threadCount * sizeof(*test_info.tinfo) );
     for( i = 0; i < test_info.threadCount; i++ )
     {
-        cl_buffer_region region = { i * test_info.subBufferSize * sizeof( cl_double), test_info.subBufferSize * sizeof( cl_double) };
-        test_info.tinfo[i].inBuf = clCreateSubBuffer( gInBuffer, CL_MEM_READ_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
-        if( error || NULL == test_info.tinfo[i].inBuf)
+        for( cl_uint slot = 0; slot < PIPELINE_SLOTS; slot++ )
         {
-            vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
-            goto exit;
-        }
-
-        for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
-        {
-            /* Qualcomm fix: 9461 read-write flags must be compatible with parent buffer */
-            test_info.tinfo[i].outBuf[j] = clCreateSubBuffer( gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
-            /* Qualcomm fix: end */
-            if( error || NULL == test_info.tinfo[i].outBuf[j] )
+            cl_buffer_region region = { (i * PIPELINE_SLOTS + slot) * test_info.subBufferSize * sizeof( cl_double), test_info.subBufferSize * sizeof( cl_double) };
+            test_info.tinfo[i].inBuf[slot] = clCreateSubBuffer( gInBuffer, CL_MEM_READ_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+            if( error || NULL == test_info.tinfo[i].inBuf[slot])
             {
                 vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
                 goto exit;
             }
+
+            for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+            {
+                /* Qualcomm fix: 9461 read-write flags must be compatible with parent buffer */
+                test_info.tinfo[i].outBuf[slot][j] = clCreateSubBuffer( gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+                /* Qualcomm fix: end */
+                if( error || NULL == test_info.tinfo[i].outBuf[slot][j] )
+                {
+                    vlog_error( "Error: Unable to create sub-buffer of gInBuffer for region {%zd, %zd}\n", region.origin, region.size );
+                    goto exit;
+                }
+            }
         }
+
         test_info.tinfo[i].tQueue = clCreateCommandQueueWithProperties(gContext, gDevice, 0, &error);
         if( NULL == test_info.tinfo[i].tQueue || error )
         {
@@ -1073,16 +1266,17 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
         }
     }
 
-    // Init the kernels
-    {
-        BuildKernelInfo build_info = { gMinVectorSizeIndex, test_info.threadCount, test_info.k, test_info.programs, f->nameInCode };
-        if( (error = ThreadPool_Do( BuildKernel_DoubleFn, gMaxVectorSizeIndex - gMinVectorSizeIndex, &build_info ) ))
-           goto exit;
-    }
+    // Wait for the kernels
+    error = ThreadPool_Wait( buildTask );
+    buildTask = NULL;
+    if( error )
+        goto exit;
 
     if( !gSkipCorrectnessTesting )
     {
-        error = ThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        error = ShardedThreadPool_Do( TestDouble, test_info.jobCount, &test_info );
+        if( ! error )
+            error = ThreadPool_Do( DrainDouble, test_info.threadCount, &test_info );
 
         // Accumulate the arithmetic errors
         for( i = 0; i < test_info.threadCount; i++ )
@@ -1181,6 +1375,10 @@ int TestFunc_Double_Double(const Func *f, MTdata d)
     vlog( "\n" );
 
 exit:
+    // Don't release the programs out from under the kernel builds
+    if( buildTask )
+        ThreadPool_Wait( buildTask );
+
     for( i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++ )
     {
         clReleaseProgram(test_info.programs[i]);
@@ -1196,15 +1394,21 @@ exit:
     {
         for( i = 0; i < test_info.threadCount; i++ )
         {
-            clReleaseMemObject(test_info.tinfo[i].inBuf);
-            for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
-                clReleaseMemObject(test_info.tinfo[i].outBuf[j]);
+            PipelineAbort( test_info.tinfo + i );
+            for( cl_uint slot = 0; slot < PIPELINE_SLOTS; slot++ )
+            {
+                clReleaseMemObject(test_info.tinfo[i].inBuf[slot]);
+                for( j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++ )
+                    clReleaseMemObject(test_info.tinfo[i].outBuf[slot][j]);
+            }
             clReleaseCommandQueue(test_info.tinfo[i].tQueue);
         }
 
         free( test_info.tinfo );
     }
 
+    RefCacheClose( test_info.refCache );
+
     return error;
 }
 
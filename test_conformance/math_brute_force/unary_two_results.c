@@ -186,7 +186,7 @@ static cl_int BuildKernel_DoubleFn( cl_uint job_id, cl_uint thread_id UNUSED, vo
 
 int TestFunc_Float2_Float(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     uint32_t l;
     int error;
@@ -229,7 +229,8 @@ int TestFunc_Float2_Float(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
@@ -659,7 +660,7 @@ exit:
 
 int TestFunc_Double2_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -695,7 +696,8 @@ int TestFunc_Double2_Double(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         double *p = (double *)gIn;
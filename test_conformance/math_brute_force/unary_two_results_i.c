@@ -193,7 +193,7 @@ cl_ulong  abs_cl_long( cl_long i )
 
 int TestFunc_FloatI_Float(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -231,7 +231,8 @@ int TestFunc_FloatI_Float(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
@@ -495,7 +496,7 @@ exit:
 
 int TestFunc_DoubleI_Double(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -533,7 +534,8 @@ int TestFunc_DoubleI_Double(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         double *p = (double *)gIn;
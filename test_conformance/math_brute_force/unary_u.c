@@ -181,7 +181,7 @@ static cl_int BuildKernel_DoubleFn( cl_uint job_id, cl_uint thread_id UNUSED, vo
 
 int TestFunc_Float_UInt(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -229,7 +229,8 @@ int TestFunc_Float_UInt(const Func *f, MTdata d)
     }
 
 
-    for( i = 0; i < (1ULL<<32); i += step  )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         uint32_t *p = (uint32_t *)gIn;
@@ -458,7 +459,7 @@ static cl_ulong random64( MTdata d )
 
 int TestFunc_Double_ULong(const Func *f, MTdata d)
 {
-    uint64_t i;
+    uint64_t i, shardBegin, shardEnd;
     uint32_t j, k;
     int error;
     cl_program programs[ VECTOR_SIZE_COUNT ];
@@ -490,7 +491,8 @@ int TestFunc_Double_ULong(const Func *f, MTdata d)
             return error;
 */
 
-    for( i = 0; i < (1ULL<<32); i += step  )
+    GetShardSweep( step, &shardBegin, &shardEnd );
+    for( i = shardBegin; i < shardEnd; i += step )
     {
         //Init input array
         cl_ulong *p = (cl_ulong *)gIn;
@@ -18,6 +18,11 @@
 #include <string.h>
 #include <errno.h>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
 
 #if ! defined( _WIN32)
 #if ! defined( __ANDROID__ )
@@ -26,6 +31,9 @@
 #include <unistd.h>
 #define streamDup(fd1) dup(fd1)
 #define streamDup2(fd1,fd2) dup2(fd1,fd2)
+#define streamPipe(fds) pipe(fds)
+#define streamRead(fd,buf,size) read(fd,buf,size)
+#define streamWrite(fd,buf,size) write(fd,buf,size)
 #endif
 #include <limits.h>
 #include <time.h>
@@ -33,8 +41,12 @@
 
 #if defined(_WIN32)
 #include <io.h>
+#include <fcntl.h>
 #define streamDup(fd1) _dup(fd1)
 #define streamDup2(fd1,fd2) _dup2(fd1,fd2)
+#define streamPipe(fds) _pipe(fds,CAPTURE_BUFFER_SIZE,_O_BINARY)
+#define streamRead(fd,buf,size) _read(fd,buf,(unsigned int)(size))
+#define streamWrite(fd,buf,size) _write(fd,buf,(unsigned int)(size))
 #endif
 
 #include "harness/testHarness.h"
@@ -56,12 +68,22 @@ static void printUsage( void );
 
 //Stream helper functions
 
-//Associate stdout stream with the file(gFileName):i.e redirect stdout stream to the specific files (gFileName)
+//Redirect stdout into a pipe read by a thread, so the output never goes through a file
+static int startOutputCapture();
+static void stopOutputCapture();
+
+//Associate stdout stream with the capture pipe, or the file(gFileName) without one:i.e redirect stdout stream
 static int acquireOutputStream();
 
-//Close the file(gFileName) associated with the stdout stream and disassociates it.
+//Close the pipe or file(gFileName) associated with the stdout stream and disassociates it.
 static void releaseOutputStream(int fd);
 
+//Get everything printed since the stream was acquired
+static void getCapturedOutput(std::string &output);
+
+//Get the last line of output, split the way fgets reads it, into the analysis buffer
+static void getLastOutputPiece(const char* output, size_t size, char* analysisBuffer);
+
 //Get analysis buffer to verify the correctess of printed data
 static void getAnalysisBuffer(char* analysisBuffer);
 
@@ -79,6 +101,9 @@ static int isKernelPFormat(testCase* pTestCase,size_t testId);
 // Make a program that uses printf for the given type/format,
 static cl_program makePrintfProgram(cl_kernel *kernel_ptr, const cl_context context,const unsigned int testId,const unsigned int testNum,bool isLongSupport = true,bool is64bAddrSpace = false);
 
+// Runs every case that doesn't take kernel arguments in one program, one case per work-item
+static void runBatch(cl_command_queue queue, cl_context context, cl_device_id device);
+
 // Creates and execute the printf test for the given device, context, type/format
 static int doTest(cl_command_queue queue, cl_context context, const unsigned int testId, const unsigned int testNum, cl_device_id device);
 
@@ -109,6 +134,20 @@ static int               gFd;
 
 static char gFileName[256];
 
+// -b: run the cases in one batched program; see runBatch
+static bool gBatchCases = false;
+
+// Marks the start of the output of each case of the batched program
+#define BATCH_MARKER "@@printf case "
+
+// Output of each case of the batched program, by type and case number
+static struct
+{
+    bool done;
+    std::vector<std::string> output[TYPE_COUNT];
+    std::vector<bool> ran[TYPE_COUNT];
+} sBatch;
+
 //-----------------------------------------
 // Static helper functions definition
 //-----------------------------------------
@@ -136,13 +175,114 @@ static int getTempFileName()
     return 0;
 }
 
+//-----------------------------------------
+// Output capture
+//-----------------------------------------
+// While a kernel runs stdout goes into a pipe. A reader thread keeps the last CAPTURE_BUFFER_SIZE
+// bytes of it in a ring buffer. releaseOutputStream writes kCaptureEnd into the pipe after
+// restoring stdout and waits for the reader to reach it, so the output of the case is complete
+// when it returns.
+static const char kCaptureEnd[] = "\0printf capture end\0";
+static const size_t kCaptureEndSize = sizeof(kCaptureEnd) - 1;
+
+static struct
+{
+    bool active;
+    int fds[2];
+    std::thread reader;
+    std::mutex lock;
+    std::condition_variable reachedEnd;
+    char ring[CAPTURE_BUFFER_SIZE];
+    size_t size;        // bytes captured since acquireOutputStream, may be more than the ring holds
+    size_t endsSeen;
+} sCapture;
+
+static void captureByte(char c)
+{
+    sCapture.ring[sCapture.size++ % CAPTURE_BUFFER_SIZE] = c;
+}
+
+static void captureReader()
+{
+    char chunk[4096];
+    size_t matched = 0;
+    for(;;)
+    {
+        int count = (int)streamRead(sCapture.fds[0], chunk, sizeof(chunk));
+        if(count <= 0)
+            break;
+
+        std::lock_guard<std::mutex> guard(sCapture.lock);
+        for(int i = 0; i < count; i++)
+        {
+            if(chunk[i] == kCaptureEnd[matched])
+            {
+                if(++matched == kCaptureEndSize)
+                {
+                    matched = 0;
+                    sCapture.endsSeen++;
+                    sCapture.reachedEnd.notify_all();
+                }
+                continue;
+            }
+
+            // Not the end marker after all
+            for(size_t j = 0; j < matched; j++)
+                captureByte(kCaptureEnd[j]);
+            matched = 0;
+            if(chunk[i] == kCaptureEnd[0])
+                matched = 1;
+            else
+                captureByte(chunk[i]);
+        }
+    }
+}
+
+//-----------------------------------------
+// startOutputCapture
+//-----------------------------------------
+static int startOutputCapture()
+{
+    if(streamPipe(sCapture.fds) != 0)
+        return -1;
+    sCapture.size = sCapture.endsSeen = 0;
+    sCapture.reader = std::thread(captureReader);
+    sCapture.active = true;
+    return 0;
+}
+
+//-----------------------------------------
+// stopOutputCapture
+//-----------------------------------------
+static void stopOutputCapture()
+{
+    if(!sCapture.active)
+        return;
+
+    // The reader stops at the end of the pipe, once nothing can write to it
+    sCapture.active = false;
+    close(sCapture.fds[1]);
+    sCapture.reader.join();
+    close(sCapture.fds[0]);
+}
+
 //-----------------------------------------
 // acquireOutputStream
 //-----------------------------------------
 static int acquireOutputStream()
 {
     int fd = streamDup(fileno(stdout));
-    freopen(gFileName,"w",stdout);
+    if(sCapture.active)
+    {
+        fflush(stdout);
+        {
+            std::lock_guard<std::mutex> guard(sCapture.lock);
+            sCapture.size = 0;
+        }
+        streamDup2(sCapture.fds[1],fileno(stdout));
+    }
+    else
+        freopen(gFileName,"w",stdout);
     return fd;
 }
 
@@ -154,24 +294,84 @@ static void releaseOutputStream(int fd)
     fflush(stdout);
     streamDup2(fd,fileno(stdout));
     close(fd);
+
+    if(sCapture.active)
+    {
+        std::unique_lock<std::mutex> guard(sCapture.lock);
+        size_t target = sCapture.endsSeen + 1;
+        guard.unlock();
+        if(streamWrite(sCapture.fds[1], kCaptureEnd, kCaptureEndSize) != (int)kCaptureEndSize)
+        {
+            log_error("Failed to write to the printf capture pipe ('%s')\n", strerror(errno));
+            return;
+        }
+        guard.lock();
+        sCapture.reachedEnd.wait(guard, [&]{ return sCapture.endsSeen >= target; });
+    }
 }
 
 //-----------------------------------------
-// getAnalysisBuffer
+// getCapturedOutput
 //-----------------------------------------
-static void getAnalysisBuffer(char* analysisBuffer)
+static void getCapturedOutput(std::string &output)
 {
-    FILE *fp;
-    memset(analysisBuffer,0,ANALYSIS_BUFFER_SIZE);
+    output.clear();
+
+    if(sCapture.active)
+    {
+        std::lock_guard<std::mutex> guard(sCapture.lock);
+        size_t size = sCapture.size < CAPTURE_BUFFER_SIZE ? sCapture.size : CAPTURE_BUFFER_SIZE;
+        size_t first = sCapture.size - size;
+        for(size_t i = 0; i < size; i++)
+            output += sCapture.ring[(first + i) % CAPTURE_BUFFER_SIZE];
+        return;
+    }
 
-    fp = fopen(gFileName,"r");
+    FILE *fp = fopen(gFileName,"rb");
     if(NULL == fp)
+    {
         log_error("Failed to open analysis buffer ('%s')\n", strerror(errno));
-    else
-    while(fgets(analysisBuffer,ANALYSIS_BUFFER_SIZE , fp) != NULL );
+        return;
+    }
+    char chunk[4096];
+    size_t count;
+    while((count = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+        output.append(chunk, count);
     fclose(fp);
 }
 
+//-----------------------------------------
+// getLastOutputPiece
+//-----------------------------------------
+static void getLastOutputPiece(const char* output, size_t size, char* analysisBuffer)
+{
+    // Keep the last piece a loop of fgets(analysisBuffer,ANALYSIS_BUFFER_SIZE,fp) reads
+    memset(analysisBuffer,0,ANALYSIS_BUFFER_SIZE);
+    for(size_t pos = 0; pos < size; )
+    {
+        size_t length = 0;
+        while(pos + length < size && length < ANALYSIS_BUFFER_SIZE - 1)
+        {
+            char c = output[pos + length];
+            analysisBuffer[length++] = c;
+            if(c == '\n')
+                break;
+        }
+        analysisBuffer[length] = '\0';
+        pos += length;
+    }
+}
+
+//-----------------------------------------
+// getAnalysisBuffer
+//-----------------------------------------
+static void getAnalysisBuffer(char* analysisBuffer)
+{
+    std::string output;
+    getCapturedOutput(output);
+    getLastOutputPiece(output.data(), output.size(), analysisBuffer);
+}
+
 //-----------------------------------------
 // isKernelArgument
 //-----------------------------------------
@@ -423,6 +623,108 @@ static bool is64bAddressSpace(cl_device_id  device_id)
     else
         return false;
 }
+//-----------------------------------------
+// runBatch
+//-----------------------------------------
+static void runBatch(cl_command_queue queue, cl_context context, cl_device_id device)
+{
+    sBatch.done = true;
+
+    // Each case prints its output after a marker with its number in a single printf, so the
+    // output can be split up again whatever order the work-items print in
+    bool longSupported = isLongSupported(device);
+    std::string source = "__kernel void test_batch(void)\n{\n    size_t gid = get_global_id(0);\n";
+    std::vector<std::pair<unsigned int, unsigned int> > cases;
+    for(unsigned int testId = 0; testId < TYPE_COUNT; testId++)
+    {
+        testCase *pTestCase = allTestCase[testId];
+        sBatch.output[testId].assign(pTestCase->_testNum, std::string());
+        sBatch.ran[testId].assign(pTestCase->_testNum, false);
+
+        // Address space cases take kernel arguments, so they run on their own
+        if(pTestCase->_type == TYPE_ADDRESS_SPACE)
+            continue;
+
+        for(unsigned int testNum = 0; testNum < pTestCase->_testNum; testNum++)
+        {
+            const printDataGenParameters &params = pTestCase->_genParameters[testNum];
+            if(pTestCase->_type == TYPE_VECTOR && !strcmp(params.dataType,"long") && !longSupported)
+                continue;
+
+            char marker[64];
+            sprintf(marker, "\\n" BATCH_MARKER "%u@@", (unsigned int)cases.size());
+            source += "    if(gid == " + std::to_string(cases.size()) + ") { ";
+            if(pTestCase->_type == TYPE_VECTOR)
+            {
+                std::string vectorType = std::string(params.dataType) + params.vectorSize;
+                source += vectorType + " tmp = (" + vectorType + ")" + params.dataRepresentation + "; ";
+                source += std::string("printf(\"") + marker + params.vectorFormatFlag + "v" + params.vectorSize +
+                          params.vectorFormatSpecifier + "\\n\", tmp);";
+            }
+            else
+                source += std::string("printf(\"") + marker + params.genericFormat + "\\n\"," + params.dataRepresentation + ");";
+            source += " }\n";
+            cases.push_back(std::make_pair(testId, testNum));
+        }
+    }
+    source += "}\n";
+
+    log_info("Running %u printf cases in one batched program\n", (unsigned int)cases.size());
+
+    cl_program program = NULL;
+    cl_kernel kernel = NULL;
+    const char *sourcePtr = source.c_str();
+    int err = create_single_kernel_helper(context, &program, &kernel, 1, &sourcePtr, "test_batch");
+    if(err || !program || !kernel)
+    {
+        log_info("The batched program failed to build, running the cases on their own\n");
+        if(kernel)
+            clReleaseKernel(kernel);
+        if(program)
+            clReleaseProgram(program);
+        return;
+    }
+
+    size_t globalWorkSize[1] = { cases.size() };
+    cl_event ndrEvt;
+    int fd = acquireOutputStream();
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, globalWorkSize, NULL, 0, NULL, &ndrEvt);
+    if(err == CL_SUCCESS)
+    {
+        fflush(stdout);
+        err = clFlush(queue);
+        if(err == CL_SUCCESS)
+            err = waitForEvent(&ndrEvt);
+    }
+    releaseOutputStream(fd);
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    if(err != CL_SUCCESS)
+    {
+        log_info("The batched program failed to run (%d), running the cases on their own\n", err);
+        return;
+    }
+
+    // The output of a case runs from its marker up to the newline in front of the next marker.
+    // Cases whose marker is missing are left to run on their own.
+    std::string output;
+    getCapturedOutput(output);
+    for(size_t i = 0; i < cases.size(); i++)
+    {
+        std::string marker = BATCH_MARKER + std::to_string(i) + "@@";
+        size_t begin = output.find(marker);
+        if(begin == std::string::npos)
+            continue;
+        begin += marker.size();
+        size_t end = output.find("\n" BATCH_MARKER, begin);
+        if(end == std::string::npos)
+            end = output.size();
+
+        sBatch.output[cases[i].first][cases[i].second] = output.substr(begin, end - begin);
+        sBatch.ran[cases[i].first][cases[i].second] = true;
+    }
+}
+
 //-----------------------------------------
 // doTest
 //-----------------------------------------
@@ -458,6 +760,26 @@ static int doTest(cl_command_queue queue, cl_context context, const unsigned int
         return 0;
     }
 
+    // The case may have run in the batched program already; only if that output doesn't verify
+    // does it run on its own, which also logs the details
+    if(gBatchCases && allTestCase[testId]->_type != TYPE_ADDRESS_SPACE)
+    {
+        if(!sBatch.done)
+            runBatch(queue, context, device);
+        if(sBatch.ran[testId][testNum])
+        {
+            char batchBuffer[ANALYSIS_BUFFER_SIZE];
+            const std::string &output = sBatch.output[testId][testNum];
+            getLastOutputPiece(output.data(), output.size(), batchBuffer);
+            if(0 == verifyOutputBuffer(batchBuffer,allTestCase[testId],testNum))
+            {
+                ++s_test_cnt;
+                return 0;
+            }
+            log_info("Output from the batched program didn't verify, running the case on its own\n");
+        }
+    }
+
     // Long support for address in FULL_PROFILE/EMBEDDED_PROFILE
     bool isLongSupport = true;
     if(allTestCase[testId]->_type == TYPE_ADDRESS_SPACE && isKernelPFormat(allTestCase[testId],testNum) && !isLongSupported(device))
@@ -982,6 +1304,9 @@ int main(int argc, const char* argv[])
                     case 'h':
                         printUsage();
                         return 0;
+                    case 'b':
+                        gBatchCases = true;
+                        break;
                     default:
                         log_error( " <-- unknown flag: %c (0x%2.2x)\n)", *arg, *arg );
                         printUsage();
@@ -996,7 +1321,8 @@ int main(int argc, const char* argv[])
         }
     }
 
-    if (getTempFileName() == -1)
+    // Fall back to a temporary file when there is no pipe to capture the output with
+    if (startOutputCapture() != 0 && getTempFileName() == -1)
     {
         log_error("getTempFileName failed\n");
         return -1;
@@ -1019,7 +1345,10 @@ int main(int argc, const char* argv[])
 
 
     free(argList);
-    remove(gFileName);
+    if (sCapture.active)
+        stopOutputCapture();
+    else
+        remove(gFileName);
     return err;
 }
 
@@ -1028,8 +1357,9 @@ int main(int argc, const char* argv[])
 //-----------------------------------------
 static void printUsage( void )
 {
-    log_info("test_printf: <optional: testnames> \n");
+    log_info("test_printf: [-b] <optional: testnames> \n");
     log_info("\tdefault is to run the full test on the default device\n");
+    log_info("\t-b\tBuild and run the cases in one batched program, running only the ones that fail on their own\n");
     log_info("\n");
     for( int i = 0; i < test_num; i++ )
     {
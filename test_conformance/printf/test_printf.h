@@ -45,6 +45,7 @@
 #endif // USE_ATF
 
 #define ANALYSIS_BUFFER_SIZE 256
+#define CAPTURE_BUFFER_SIZE (64 * 1024)
 
 //-----------------------------------------
 // Definitions and initializations
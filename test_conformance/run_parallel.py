@@ -0,0 +1,256 @@
+#! /usr/bin/python
+
+# Runs the tests of a conformance csv file several at a time, longest first, and can resume a
+# run that was killed.
+#
+# Usage: run_parallel.py <test_list.csv> [--jobs N] [--timeout S] [--logdir DIR] [--history DIR]
+#                        [--fresh] [CL_DEVICE_TYPE(s) to test] [partial-test-names, ...]
+#
+# --jobs N       Run up to N test binaries at once (default 1).
+# --timeout S    Kill a test binary that runs longer than S seconds and report it as failed.
+# --logdir DIR   Where the output of each test, its results file and the journal go (default .).
+# --history DIR  Where the results files of an earlier run are (default: --logdir). The wall
+#                times recorded there are used to start the longest tests first; tests without
+#                a time are started before all others.
+# --fresh        Ignore the journal and run everything again.
+#
+# The csv format and the device and name selection are the same as for run_conformance.py.
+# Every finished test is appended to <logdir>/journal.txt; tests listed there are skipped when
+# the same run is started again.
+
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+def usage():
+    print('Usage: run_parallel.py <test_list.csv> [--jobs N] [--timeout S] [--logdir DIR] [--history DIR]')
+    print('                       [--fresh] [CL_DEVICE_TYPE(s) to test] [partial-test-names, ...]')
+    sys.exit(1)
+
+device_types = ['CL_DEVICE_TYPE_DEFAULT', 'CL_DEVICE_TYPE_CPU', 'CL_DEVICE_TYPE_GPU',
+                'CL_DEVICE_TYPE_ACCELERATOR', 'CL_DEVICE_TYPE_ALL']
+
+def parse_args(argv):
+    options = {'jobs': 1, 'timeout': None, 'logdir': '.', 'history': None, 'fresh': False}
+    devices = []
+    patterns = []
+    if len(argv) < 1:
+        usage()
+    csv = argv[0]
+    i = 1
+    while i < len(argv):
+        arg = argv[i]
+        if arg in ('--jobs', '--timeout', '--logdir', '--history'):
+            if i + 1 >= len(argv):
+                usage()
+            options[arg[2:]] = argv[i + 1]
+            i += 1
+        elif arg == '--fresh':
+            options['fresh'] = True
+        elif arg in device_types:
+            devices.append(arg)
+        elif arg.startswith('--'):
+            usage()
+        else:
+            patterns.append(arg)
+        i += 1
+    options['jobs'] = int(options['jobs'])
+    if options['timeout'] is not None:
+        options['timeout'] = float(options['timeout'])
+    if options['history'] is None:
+        options['history'] = options['logdir']
+    if options['jobs'] < 1:
+        usage()
+    return csv, options, devices or ['CL_DEVICE_TYPE_DEFAULT'], patterns
+
+# Same rules as get_tests in run_conformance.py: "name,command" or "device type,name,command"
+def get_tests(filename, devices):
+    tests = []
+    with open(filename) as f:
+        for line in f:
+            if re.match(r'^\s*#', line):
+                continue
+            m = re.match(r'^\s*(.+?)\s*,\s*(.+?)\s*,\s*(.+?)\s*$', line)
+            if m:
+                if m.group(1) in devices:
+                    tests.append((m.group(2), m.group(3)))
+                continue
+            m = re.match(r'^\s*(.+?)\s*,\s*(.+?)\s*$', line)
+            if m:
+                tests.append((m.group(1), m.group(2)))
+    return tests
+
+def select_tests(tests, patterns):
+    if not patterns:
+        return tests
+    selected = []
+    for pattern in patterns:
+        found = False
+        for test in tests:
+            if pattern in test[0] or pattern in test[1]:
+                found = True
+                if test not in selected:
+                    selected.append(test)
+        if not found:
+            print('Failed to find a test matching ' + pattern)
+    return selected
+
+def file_name(device, name):
+    return re.sub(r'[^A-Za-z0-9_.-]', '_', device + '_' + name)
+
+# Wall time of a test in an earlier run: the sum of its sub-tests in the harness results file
+def previous_seconds(history, device, name):
+    try:
+        with open(os.path.join(history, file_name(device, name) + '.json')) as f:
+            metrics = json.load(f).get('metrics', {})
+    except (IOError, OSError, ValueError):
+        return None
+    if not metrics:
+        return None
+    return sum(float(m.get('wall_seconds', 0)) for m in metrics.values())
+
+def load_journal(journal):
+    done = {}
+    try:
+        with open(journal) as f:
+            for line in f:
+                try:
+                    entry = json.loads(line)
+                    done[(entry['device'], entry['name'], entry['command'])] = entry
+                except (ValueError, KeyError):
+                    pass  # a line cut short when the run was killed
+    except (IOError, OSError):
+        pass
+    return done
+
+# Test processes still running, killed if the run is interrupted
+running = set()
+
+def kill_process(proc):
+    try:
+        if os.name == 'posix':
+            os.killpg(proc.pid, 9)
+        else:
+            proc.kill()
+    except OSError:
+        pass
+
+def run_test(test_dir, device, name, command, logdir, timeout):
+    program = command.split(None, 1)[0]
+    if os.sep == '\\':
+        program += '.exe'
+    if not os.path.exists(os.path.join(test_dir, program)):
+        return 'missing', 0.0
+
+    env = os.environ.copy()
+    env['CL_DEVICE_TYPE'] = device
+    env['CL_CONFORMANCE_RESULTS_FILENAME'] = os.path.abspath(os.path.join(logdir, file_name(device, name) + '.json'))
+    log = open(os.path.join(logdir, file_name(device, name) + '.log'), 'w')
+    kwargs = {}
+    if os.name == 'posix':
+        kwargs['preexec_fn'] = os.setsid  # so a timeout kills the whole shell pipeline
+    start = time.time()
+    proc = subprocess.Popen(os.path.join(test_dir, command), shell=True, stdout=log, stderr=subprocess.STDOUT,
+                            cwd=os.path.dirname(os.path.join(test_dir, program)), env=env, **kwargs)
+    running.add(proc)
+
+    timer = None
+    timed_out = []
+    if timeout is not None:
+        def kill():
+            timed_out.append(True)
+            kill_process(proc)
+        timer = threading.Timer(timeout, kill)
+        timer.start()
+    code = proc.wait()
+    running.discard(proc)
+    if timer is not None:
+        timer.cancel()
+    log.close()
+
+    seconds = time.time() - start
+    if timed_out:
+        return 'timeout', seconds
+    return ('pass' if code == 0 else 'fail'), seconds
+
+def main():
+    csv, options, devices, patterns = parse_args(sys.argv[1:])
+    test_dir = os.getcwd()
+    logdir = options['logdir']
+    if not os.path.isdir(logdir):
+        os.makedirs(logdir)
+    journal_name = os.path.join(logdir, 'journal.txt')
+    if options['fresh'] and os.path.exists(journal_name):
+        os.remove(journal_name)
+    done = load_journal(journal_name)
+
+    tests = select_tests(get_tests(csv, devices), patterns)
+    jobs = []
+    for device in devices:
+        for name, command in tests:
+            if (device, name, command) in done:
+                continue
+            seconds = previous_seconds(options['history'], device, name)
+            jobs.append((float('inf') if seconds is None else seconds, device, name, command))
+    jobs.sort(key=lambda job: -job[0])
+
+    skipped = len(devices) * len(tests) - len(jobs)
+    print('%d tests to run, %d already done according to %s' % (len(jobs), skipped, journal_name))
+
+    lock = threading.Lock()
+    journal = open(journal_name, 'a')
+    selected = set((device, name, command) for device in devices for name, command in tests)
+    failures = [key[1] for key, entry in done.items() if key in selected and entry['result'] != 'pass']
+    finished = [0]
+    interrupted = [False]  # set on Ctrl-C; the tests still running then were killed, not failed
+
+    def worker():
+        while True:
+            with lock:
+                if not jobs:
+                    return
+                estimate, device, name, command = jobs.pop(0)
+            result, seconds = run_test(test_dir, device, name, command, logdir, options['timeout'])
+            with lock:
+                if interrupted[0]:
+                    return
+                finished[0] += 1
+                print('(%s) %-7s %-40s %s (%ds, %d/%d)' % (time.strftime('%d-%b %H:%M:%S'), result.upper(), name,
+                                                           device, int(seconds), finished[0] + skipped,
+                                                           len(devices) * len(tests)))
+                sys.stdout.flush()
+                if result != 'pass':
+                    failures.append(name)
+                journal.write(json.dumps({'device': device, 'name': name, 'command': command,
+                                          'result': result, 'seconds': seconds}) + '\n')
+                journal.flush()
+                os.fsync(journal.fileno())
+
+    threads = [threading.Thread(target=worker) for i in range(min(options['jobs'], max(len(jobs), 1)))]
+    for thread in threads:
+        thread.daemon = True
+        thread.start()
+    # Join with a timeout so Ctrl-C still reaches the main thread
+    try:
+        for thread in threads:
+            while thread.is_alive():
+                thread.join(1)
+    except KeyboardInterrupt:
+        with lock:
+            interrupted[0] = True
+            del jobs[:]
+            for proc in list(running):
+                kill_process(proc)
+        print('Interrupted. Run again with the same --logdir to resume.')
+        sys.exit(1)
+    journal.close()
+
+    print('Testing complete. %d failures for %d tests.' % (len(failures), len(devices) * len(tests)))
+    sys.exit(1 if failures else 0)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,137 @@
+#! /usr/bin/python
+
+# Runs one test binary as several shards in parallel and merges the results.
+#
+# Usage: run_sharded.py --shards N [--devices 0,1,...] [--subdevices] [--logdir DIR] -- <test command>
+#
+# Each shard runs <test command> --shard i/N. With --devices the shards are spread round robin
+# over the listed device indices via CL_DEVICE_INDEX. With --subdevices each shard also runs on
+# its own equal partition of the device (--shard-subdevices), so shards sharing one CPU device
+# don't compete for the same compute units.
+#
+# Every shard runs the same tests on its own part of the inputs, so a test passes only if it
+# passes on every shard; the counts are over the tests, not the shards. For the math tests the
+# worst ulp error of each sub-test over all shards is reported.
+
+import os
+import re
+import sys
+import subprocess
+
+def usage():
+    print('Usage: run_sharded.py --shards N [--devices 0,1,...] [--subdevices] [--logdir DIR] -- <test command>')
+    sys.exit(1)
+
+def parse_args(argv):
+    shards = 0
+    devices = []
+    subdevices = False
+    logdir = '.'
+    i = 0
+    while i < len(argv):
+        arg = argv[i]
+        if arg == '--':
+            return shards, devices, subdevices, logdir, argv[i + 1:]
+        if arg == '--shards' and i + 1 < len(argv):
+            shards = int(argv[i + 1])
+            i += 1
+        elif arg == '--devices' and i + 1 < len(argv):
+            devices = [d for d in argv[i + 1].split(',') if d != '']
+            i += 1
+        elif arg == '--subdevices':
+            subdevices = True
+        elif arg == '--logdir' and i + 1 < len(argv):
+            logdir = argv[i + 1]
+            i += 1
+        else:
+            usage()
+        i += 1
+    usage()
+
+# A math sub-test line looks like "<name> ...\t<max ulp error> @ <value>"
+ulp_line = re.compile(r'^([^\t]*)\t\s*([-+0-9.eEinfa]+) @ (.*)$')
+# The harness ends each test with "<name> passed" or "<name> FAILED"
+pass_line = re.compile(r'^(\S+) passed$')
+fail_line = re.compile(r'^(\S+) FAILED$')
+
+def merge_logs(logs):
+    passes = {}     # test name -> number of shards it passed on
+    failures = set()
+    tests = []
+    worst = {}
+    order = []
+    for log in logs:
+        with open(log) as f:
+            for line in f:
+                m = ulp_line.match(line.rstrip('\n'))
+                if m:
+                    name = m.group(1).strip(' .')
+                    try:
+                        error = float(m.group(2))
+                    except ValueError:
+                        continue
+                    if name not in worst:
+                        order.append(name)
+                        worst[name] = (error, m.group(3))
+                    elif error > worst[name][0]:
+                        worst[name] = (error, m.group(3))
+                    continue
+                m = pass_line.match(line.rstrip('\n'))
+                if m:
+                    if m.group(1) not in passes:
+                        tests.append(m.group(1))
+                        passes[m.group(1)] = 0
+                    passes[m.group(1)] += 1
+                    continue
+                m = fail_line.match(line.rstrip('\n'))
+                if m:
+                    if m.group(1) not in passes:
+                        tests.append(m.group(1))
+                        passes[m.group(1)] = 0
+                    failures.add(m.group(1))
+    # A test that didn't finish on some shard (e.g. because the shard crashed) didn't pass
+    failed = [name for name in tests if name in failures or passes[name] < len(logs)]
+    return len(tests) - len(failed), failed, [(name, worst[name]) for name in order]
+
+def main():
+    shards, devices, subdevices, logdir, command = parse_args(sys.argv[1:])
+    if shards < 1 or len(command) == 0:
+        usage()
+
+    procs = []
+    logs = []
+    for i in range(shards):
+        env = os.environ.copy()
+        if len(devices) > 0:
+            env['CL_DEVICE_INDEX'] = devices[i % len(devices)]
+        args = command + ['--shard', '%d/%d' % (i, shards)]
+        if subdevices:
+            args.append('--shard-subdevices')
+        log = os.path.join(logdir, 'shard_%d_of_%d.log' % (i, shards))
+        out = open(log, 'w')
+        print('Shard %d: %s > %s' % (i, ' '.join(args), log))
+        procs.append((subprocess.Popen(args, stdout=out, stderr=subprocess.STDOUT, env=env), out))
+        logs.append(log)
+
+    result = 0
+    for i, (proc, out) in enumerate(procs):
+        code = proc.wait()
+        out.close()
+        if code != 0:
+            print('Shard %d exited with %d' % (i, code))
+            result = 1
+
+    passed, failed, errors = merge_logs(logs)
+    for name, (error, value) in errors:
+        print('%s\t%8.2f @ %s' % (name, error, value))
+    for name in failed:
+        print('%s FAILED' % name)
+    if failed:
+        print('FAILED %d of %d tests.' % (len(failed), passed + len(failed)))
+        result = 1
+    elif passed:
+        print('PASSED %d of %d tests.' % (passed, passed))
+    sys.exit(result)
+
+if __name__ == '__main__':
+    main()